@@ -4,6 +4,7 @@ HEADERS += \
     $$PWD/application.h \
     $$PWD/applicationinstancemanager.h \
     $$PWD/cmdoptions.h \
+    $$PWD/externalprogramrunner.h \
     $$PWD/filelogger.h \
     $$PWD/qtlocalpeer/qtlocalpeer.h \
     $$PWD/signalhandler.h \
@@ -13,6 +14,7 @@ SOURCES += \
     $$PWD/application.cpp \
     $$PWD/applicationinstancemanager.cpp \
     $$PWD/cmdoptions.cpp \
+    $$PWD/externalprogramrunner.cpp \
     $$PWD/filelogger.cpp \
     $$PWD/main.cpp \
     $$PWD/qtlocalpeer/qtlocalpeer.cpp \
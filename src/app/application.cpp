@@ -36,9 +36,7 @@
 #endif
 
 #ifdef Q_OS_WIN
-#include <memory>
 #include <Windows.h>
-#include <Shellapi.h>
 #elif defined(Q_OS_UNIX)
 #include <sys/resource.h>
 #endif
@@ -47,7 +45,6 @@
 #include <QDebug>
 #include <QLibraryInfo>
 #include <QMetaObject>
-#include <QProcess>
 
 #ifndef DISABLE_GUI
 #include <QMenu>
@@ -66,6 +63,7 @@
 #include "base/bittorrent/infohash.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/torrent.h"
+#include "base/bittorrent/torrenteventbus.h"
 #include "base/exceptions.h"
 #include "base/global.h"
 #include "base/iconprovider.h"
@@ -87,6 +85,7 @@
 #include "base/utils/string.h"
 #include "base/version.h"
 #include "applicationinstancemanager.h"
+#include "externalprogramrunner.h"
 #include "filelogger.h"
 #include "upgrade.h"
 
@@ -499,137 +498,7 @@ void Application::processMessage(const QString &message)
 
 void Application::runExternalProgram(const QString &programTemplate, const BitTorrent::Torrent *torrent) const
 {
-    // Cannot give users shell environment by default, as doing so could
-    // enable command injection via torrent name and other arguments
-    // (especially when some automated download mechanism has been setup).
-    // See: https://github.com/qbittorrent/qBittorrent/issues/10925
-
-    const auto replaceVariables = [torrent](QString str) -> QString
-    {
-        for (int i = (str.length() - 2); i >= 0; --i)
-        {
-            if (str[i] != u'%')
-                continue;
-
-            const ushort specifier = str[i + 1].unicode();
-            switch (specifier)
-            {
-            case u'C':
-                str.replace(i, 2, QString::number(torrent->filesCount()));
-                break;
-            case u'D':
-                str.replace(i, 2, torrent->savePath().toString());
-                break;
-            case u'F':
-                str.replace(i, 2, torrent->contentPath().toString());
-                break;
-            case u'G':
-                str.replace(i, 2, torrent->tags().join(u","_qs));
-                break;
-            case u'I':
-                str.replace(i, 2, (torrent->infoHash().v1().isValid() ? torrent->infoHash().v1().toString() : u"-"_qs));
-                break;
-            case u'J':
-                str.replace(i, 2, (torrent->infoHash().v2().isValid() ? torrent->infoHash().v2().toString() : u"-"_qs));
-                break;
-            case u'K':
-                str.replace(i, 2, torrent->id().toString());
-                break;
-            case u'L':
-                str.replace(i, 2, torrent->category());
-                break;
-            case u'N':
-                str.replace(i, 2, torrent->name());
-                break;
-            case u'R':
-                str.replace(i, 2, torrent->rootPath().toString());
-                break;
-            case u'T':
-                str.replace(i, 2, torrent->currentTracker());
-                break;
-            case u'Z':
-                str.replace(i, 2, QString::number(torrent->totalSize()));
-                break;
-            default:
-                // do nothing
-                break;
-            }
-
-            // decrement `i` to avoid unwanted replacement, example pattern: "%%N"
-            --i;
-        }
-
-        return str;
-    };
-
-    const QString logMsg = tr("Running external program. Torrent: \"%1\". Command: `%2`");
-
-    // The processing sequenece is different for Windows and other OS, this is intentional
-#if defined(Q_OS_WIN)
-    const QString program = replaceVariables(programTemplate);
-    const std::wstring programWStr = program.toStdWString();
-
-    // Need to split arguments manually because QProcess::startDetached(QString)
-    // will strip off empty parameters.
-    // E.g. `python.exe "1" "" "3"` will become `python.exe "1" "3"`
-    int argCount = 0;
-    std::unique_ptr<LPWSTR[], decltype(&::LocalFree)> args {::CommandLineToArgvW(programWStr.c_str(), &argCount), ::LocalFree};
-
-    if (argCount <= 0)
-        return;
-
-    QStringList argList;
-    for (int i = 1; i < argCount; ++i)
-        argList += QString::fromWCharArray(args[i]);
-
-    LogMsg(logMsg.arg(torrent->name(), program));
-
-    QProcess proc;
-    proc.setProgram(QString::fromWCharArray(args[0]));
-    proc.setArguments(argList);
-    proc.setCreateProcessArgumentsModifier([](QProcess::CreateProcessArguments *args)
-    {
-        if (Preferences::instance()->isAutoRunConsoleEnabled())
-        {
-            args->flags |= CREATE_NEW_CONSOLE;
-            args->flags &= ~(CREATE_NO_WINDOW | DETACHED_PROCESS);
-        }
-        else
-        {
-            args->flags |= CREATE_NO_WINDOW;
-            args->flags &= ~(CREATE_NEW_CONSOLE | DETACHED_PROCESS);
-        }
-        args->inheritHandles = false;
-        args->startupInfo->dwFlags &= ~STARTF_USESTDHANDLES;
-        ::CloseHandle(args->startupInfo->hStdInput);
-        ::CloseHandle(args->startupInfo->hStdOutput);
-        ::CloseHandle(args->startupInfo->hStdError);
-        args->startupInfo->hStdInput = nullptr;
-        args->startupInfo->hStdOutput = nullptr;
-        args->startupInfo->hStdError = nullptr;
-    });
-    proc.startDetached();
-#else // Q_OS_WIN
-    QStringList args = Utils::String::splitCommand(programTemplate);
-
-    if (args.isEmpty())
-        return;
-
-    for (QString &arg : args)
-    {
-        // strip redundant quotes
-        if (arg.startsWith(u'"') && arg.endsWith(u'"'))
-            arg = arg.mid(1, (arg.size() - 2));
-
-        arg = replaceVariables(arg);
-    }
-
-    // show intended command in log
-    LogMsg(logMsg.arg(torrent->name(), replaceVariables(programTemplate)));
-
-    const QString command = args.takeFirst();
-    QProcess::startDetached(command, args);
-#endif
+    m_externalProgramRunner->run(programTemplate, torrent);
 }
 
 void Application::sendNotificationEmail(const BitTorrent::Torrent *torrent)
@@ -811,12 +680,15 @@ try
 #endif
     connect(BitTorrent::Session::instance(), &BitTorrent::Session::restored, this, [this]()
     {
+        m_externalProgramRunner = new ExternalProgramRunner(this);
+
         connect(BitTorrent::Session::instance(), &BitTorrent::Session::torrentAdded, this, &Application::torrentAdded);
         connect(BitTorrent::Session::instance(), &BitTorrent::Session::torrentFinished, this, &Application::torrentFinished);
         connect(BitTorrent::Session::instance(), &BitTorrent::Session::allTorrentsFinished, this, &Application::allTorrentsFinished, Qt::QueuedConnection);
 
         Net::GeoIPManager::initInstance();
         TorrentFilesWatcher::initInstance();
+        BitTorrent::TorrentEventBus::initInstance();
 
         new RSS::Session; // create RSS::Session singleton
         new RSS::AutoDownloader; // create RSS::AutoDownloader singleton
@@ -1250,8 +1122,13 @@ void Application::cleanup()
     delete RSS::AutoDownloader::instance();
     delete RSS::Session::instance();
 
+    BitTorrent::TorrentEventBus::freeInstance();
     TorrentFilesWatcher::freeInstance();
     BitTorrent::Session::freeInstance();
+
+    // the runner is used by the session signal handlers, so it is deleted once the session is gone
+    delete m_externalProgramRunner;
+    m_externalProgramRunner = nullptr;
     Net::GeoIPManager::freeInstance();
     Net::DownloadManager::freeInstance();
     Net::ProxyConfigurationManager::freeInstance();
@@ -53,6 +53,7 @@
 #endif
 
 class ApplicationInstanceManager;
+class ExternalProgramRunner;
 class FileLogger;
 
 namespace BitTorrent
@@ -171,6 +172,7 @@ private:
 #endif
 
     ApplicationInstanceManager *m_instanceManager = nullptr;
+    ExternalProgramRunner *m_externalProgramRunner = nullptr;
     QAtomicInt m_isCleanupRun;
     bool m_isProcessingParamsAllowed = false;
     ShutdownDialogAction m_shutdownAct;
@@ -0,0 +1,349 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "externalprogramrunner.h"
+
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#include <memory>
+#include <Windows.h>
+#include <Shellapi.h>
+#endif
+
+#include <QMetaObject>
+#include <QProcess>
+
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/torrent.h"
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/preferences.h"
+#include "base/utils/string.h"
+
+#define SETTINGS_KEY(name) (u"AutoRun/" name)
+
+namespace
+{
+    // the template cache is only expected to hold the "torrent added" and "torrent finished" commands
+    const int MAX_CACHED_TEMPLATES = 8;
+
+    bool isPlaceholder(const char16_t specifier)
+    {
+        switch (specifier)
+        {
+        case u'C':
+        case u'D':
+        case u'F':
+        case u'G':
+        case u'I':
+        case u'J':
+        case u'K':
+        case u'L':
+        case u'N':
+        case u'R':
+        case u'T':
+        case u'Z':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    QString placeholderValue(const char16_t placeholder, const BitTorrent::Torrent *torrent)
+    {
+        switch (placeholder)
+        {
+        case u'C':
+            return QString::number(torrent->filesCount());
+        case u'D':
+            return torrent->savePath().toString();
+        case u'F':
+            return torrent->contentPath().toString();
+        case u'G':
+            return torrent->tags().join(u","_qs);
+        case u'I':
+            return (torrent->infoHash().v1().isValid() ? torrent->infoHash().v1().toString() : u"-"_qs);
+        case u'J':
+            return (torrent->infoHash().v2().isValid() ? torrent->infoHash().v2().toString() : u"-"_qs);
+        case u'K':
+            return torrent->id().toString();
+        case u'L':
+            return torrent->category();
+        case u'N':
+            return torrent->name();
+        case u'R':
+            return torrent->rootPath().toString();
+        case u'T':
+            return torrent->currentTracker();
+        case u'Z':
+            return QString::number(torrent->totalSize());
+        default:
+            Q_ASSERT(false);
+            return {};
+        }
+    }
+}
+
+ExternalProgramRunner::ExternalProgramRunner(QObject *parent)
+    : QObject {parent}
+    , m_maxConcurrentLaunches {SETTINGS_KEY(u"MaxConcurrentLaunches"_qs), 2, [](const int value) { return std::max(1, value); }}
+    , m_maxLaunchesPerSecond {SETTINGS_KEY(u"MaxLaunchesPerSecond"_qs), 20, [](const int value) { return std::clamp(value, 1, 1000); }}
+{
+    m_threadPool.setMaxThreadCount(m_maxConcurrentLaunches);
+
+    m_dispatchTimer.setInterval(1000 / m_maxLaunchesPerSecond);
+    connect(&m_dispatchTimer, &QTimer::timeout, this, &ExternalProgramRunner::dispatch);
+}
+
+ExternalProgramRunner::~ExternalProgramRunner()
+{
+    m_threadPool.waitForDone();
+
+    // the commands were requested already, so don't drop the remaining ones on exit
+    while (!m_queue.isEmpty())
+    {
+        const Job job = m_queue.dequeue();
+        LogMsg(tr("Running external program. Torrent: \"%1\". Command: `%2`").arg(job.torrentName, job.commandLine));
+        launch(job);
+    }
+}
+
+void ExternalProgramRunner::run(const QString &programTemplate, const BitTorrent::Torrent *torrent)
+{
+    // Cannot give users shell environment by default, as doing so could
+    // enable command injection via torrent name and other arguments
+    // (especially when some automated download mechanism has been setup).
+    // See: https://github.com/qbittorrent/qBittorrent/issues/10925
+
+    const CommandTemplate &parsedTemplate = commandTemplate(programTemplate);
+
+    const auto torrentValue = [torrent](const char16_t placeholder) { return placeholderValue(placeholder, torrent); };
+
+    // torrent data is captured right away since the torrent may be gone by the time the job is started
+    Job job;
+    job.torrentName = torrent->name();
+    job.commandLine = expand(parsedTemplate.commandLine, torrentValue);
+#ifdef Q_OS_WIN
+    job.isConsoleEnabled = Preferences::instance()->isAutoRunConsoleEnabled();
+#else
+    if (parsedTemplate.arguments.isEmpty())
+        return;
+
+    job.arguments.reserve(parsedTemplate.arguments.size());
+    for (const ParsedString &argument : parsedTemplate.arguments)
+        job.arguments.append(expand(argument, torrentValue));
+#endif
+    job.queuedTimer.start();
+    m_queue.enqueue(job);
+
+    if (!m_dispatchTimer.isActive())
+    {
+        dispatch();
+        m_dispatchTimer.start();
+    }
+}
+
+ExternalProgramRunner::ParsedString ExternalProgramRunner::parse(const QString &str)
+{
+    // Placeholders are searched from the end to be consistent with the former in-place replacement,
+    // the character preceding a '%' is never treated as the start of another placeholder, e.g. "%%N".
+    ParsedString segments;
+    int literalEnd = str.size();
+    for (int i = (str.size() - 2); i >= 0; --i)
+    {
+        if (str[i] != u'%')
+            continue;
+
+        const char16_t specifier = str[i + 1].unicode();
+        if (isPlaceholder(specifier))
+        {
+            if ((i + 2) < literalEnd)
+                segments.append({str.mid((i + 2), (literalEnd - (i + 2))), 0});
+            segments.append({{}, specifier});
+            literalEnd = i;
+        }
+
+        --i;
+    }
+    if (literalEnd > 0)
+        segments.append({str.left(literalEnd), 0});
+
+    std::reverse(segments.begin(), segments.end());
+    return segments;
+}
+
+QString ExternalProgramRunner::expand(const ParsedString &parsedString, const PlaceholderValueFunc &placeholderValue)
+{
+    QString result;
+    for (const Segment &segment : parsedString)
+        result += ((segment.placeholder == 0) ? segment.text : placeholderValue(segment.placeholder));
+    return result;
+}
+
+const ExternalProgramRunner::CommandTemplate &ExternalProgramRunner::commandTemplate(const QString &programTemplate)
+{
+    const auto iter = m_templates.constFind(programTemplate);
+    if (iter != m_templates.cend())
+        return iter.value();
+
+    if (m_templates.size() >= MAX_CACHED_TEMPLATES)
+        m_templates.clear();
+
+    CommandTemplate parsedTemplate;
+    parsedTemplate.commandLine = parse(programTemplate);
+#ifndef Q_OS_WIN
+    // The processing sequence is different for Windows and other OS, this is intentional.
+    // Here the command is split before the placeholders are replaced, so their values always stay within a single argument.
+    for (QString arg : asConst(Utils::String::splitCommand(programTemplate)))
+    {
+        // strip redundant quotes
+        if (arg.startsWith(u'"') && arg.endsWith(u'"'))
+            arg = arg.mid(1, (arg.size() - 2));
+
+        parsedTemplate.arguments.append(parse(arg));
+    }
+#endif
+
+    return *m_templates.insert(programTemplate, parsedTemplate);
+}
+
+bool ExternalProgramRunner::launch(const Job &job)
+{
+#if defined(Q_OS_WIN)
+    const std::wstring programWStr = job.commandLine.toStdWString();
+
+    // Need to split arguments manually because QProcess::startDetached(QString)
+    // will strip off empty parameters.
+    // E.g. `python.exe "1" "" "3"` will become `python.exe "1" "3"`
+    int argCount = 0;
+    std::unique_ptr<LPWSTR[], decltype(&::LocalFree)> args {::CommandLineToArgvW(programWStr.c_str(), &argCount), ::LocalFree};
+
+    if (argCount <= 0)
+        return false;
+
+    QStringList argList;
+    for (int i = 1; i < argCount; ++i)
+        argList += QString::fromWCharArray(args[i]);
+
+    const bool isConsoleEnabled = job.isConsoleEnabled;
+    QProcess proc;
+    proc.setProgram(QString::fromWCharArray(args[0]));
+    proc.setArguments(argList);
+    proc.setCreateProcessArgumentsModifier([isConsoleEnabled](QProcess::CreateProcessArguments *args)
+    {
+        if (isConsoleEnabled)
+        {
+            args->flags |= CREATE_NEW_CONSOLE;
+            args->flags &= ~(CREATE_NO_WINDOW | DETACHED_PROCESS);
+        }
+        else
+        {
+            args->flags |= CREATE_NO_WINDOW;
+            args->flags &= ~(CREATE_NEW_CONSOLE | DETACHED_PROCESS);
+        }
+        args->inheritHandles = false;
+        args->startupInfo->dwFlags &= ~STARTF_USESTDHANDLES;
+        ::CloseHandle(args->startupInfo->hStdInput);
+        ::CloseHandle(args->startupInfo->hStdOutput);
+        ::CloseHandle(args->startupInfo->hStdError);
+        args->startupInfo->hStdInput = nullptr;
+        args->startupInfo->hStdOutput = nullptr;
+        args->startupInfo->hStdError = nullptr;
+    });
+    return proc.startDetached();
+#else // Q_OS_WIN
+    QStringList args = job.arguments;
+    const QString command = args.takeFirst();
+    return QProcess::startDetached(command, args);
+#endif
+}
+
+void ExternalProgramRunner::dispatch()
+{
+    if (m_queue.isEmpty())
+    {
+        m_dispatchTimer.stop();
+        return;
+    }
+
+    // wait for the next tick if the workers are still busy starting processes
+    if (m_launchesInProgress >= m_threadPool.maxThreadCount())
+        return;
+
+    const Job job = m_queue.dequeue();
+    LogMsg(tr("Running external program. Torrent: \"%1\". Command: `%2`").arg(job.torrentName, job.commandLine));
+
+    m_maxQueueDelay = std::max(m_maxQueueDelay, job.queuedTimer.elapsed());
+    ++m_launchesInProgress;
+
+    m_threadPool.start([this, job]
+    {
+        QElapsedTimer launchTimer;
+        launchTimer.start();
+        const bool isStarted = launch(job);
+        const qint64 launchDuration = launchTimer.elapsed();
+
+        QMetaObject::invokeMethod(this, [this, torrentName = job.torrentName, commandLine = job.commandLine, isStarted, launchDuration]
+        {
+            handleLaunchFinished(torrentName, commandLine, isStarted, launchDuration);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ExternalProgramRunner::handleLaunchFinished(const QString &torrentName, const QString &commandLine
+        , const bool isStarted, const qint64 launchDuration)
+{
+    --m_launchesInProgress;
+
+    if (isStarted)
+    {
+        ++m_startedCount;
+    }
+    else
+    {
+        ++m_failedCount;
+        LogMsg(tr("Failed to start external program. Torrent: \"%1\". Command: `%2`").arg(torrentName, commandLine), Log::WARNING);
+    }
+    m_maxLaunchDuration = std::max(m_maxLaunchDuration, launchDuration);
+
+    if (!m_queue.isEmpty() || (m_launchesInProgress > 0))
+        return;
+
+    if ((m_startedCount + m_failedCount) > 1)
+    {
+        LogMsg(tr("External programs started: %1, failed to start: %2. Longest wait in queue: %3 ms. Longest start time: %4 ms")
+            .arg(QString::number(m_startedCount), QString::number(m_failedCount)
+                , QString::number(m_maxQueueDelay), QString::number(m_maxLaunchDuration)));
+    }
+
+    m_startedCount = 0;
+    m_failedCount = 0;
+    m_maxQueueDelay = 0;
+    m_maxLaunchDuration = 0;
+}
@@ -0,0 +1,117 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <functional>
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+
+#include "base/settingvalue.h"
+
+namespace BitTorrent
+{
+    class Torrent;
+}
+
+// Runs the external programs configured for torrent events.
+// Commands are queued and started from worker threads at a limited rate,
+// so a burst of events (e.g. many torrents finishing after a recheck) doesn't stall the event loop.
+class ExternalProgramRunner final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(ExternalProgramRunner)
+
+public:
+    explicit ExternalProgramRunner(QObject *parent = nullptr);
+    ~ExternalProgramRunner() override;
+
+    void run(const QString &programTemplate, const BitTorrent::Torrent *torrent);
+
+    // text split into literal parts and placeholders (e.g. "%N")
+    struct Segment
+    {
+        QString text;
+        char16_t placeholder = 0;  // 0 for literal text
+    };
+    using ParsedString = QVector<Segment>;
+    using PlaceholderValueFunc = std::function<QString (char16_t placeholder)>;
+
+    static ParsedString parse(const QString &str);
+    static QString expand(const ParsedString &parsedString, const PlaceholderValueFunc &placeholderValue);
+
+private:
+    struct CommandTemplate
+    {
+        ParsedString commandLine;
+#ifndef Q_OS_WIN
+        QVector<ParsedString> arguments;
+#endif
+    };
+
+    struct Job
+    {
+        QString torrentName;
+        QString commandLine;
+#ifdef Q_OS_WIN
+        bool isConsoleEnabled = false;
+#else
+        QStringList arguments;
+#endif
+        QElapsedTimer queuedTimer;
+    };
+
+    static bool launch(const Job &job);
+
+    const CommandTemplate &commandTemplate(const QString &programTemplate);
+    void dispatch();
+    void handleLaunchFinished(const QString &torrentName, const QString &commandLine, bool isStarted, qint64 launchDuration);
+
+    CachedSettingValue<int> m_maxConcurrentLaunches;
+    CachedSettingValue<int> m_maxLaunchesPerSecond;
+
+    QHash<QString, CommandTemplate> m_templates;
+    QQueue<Job> m_queue;
+    QThreadPool m_threadPool;
+    QTimer m_dispatchTimer;
+    int m_launchesInProgress = 0;
+
+    // statistics of the current burst, logged once the queue is drained
+    int m_startedCount = 0;
+    int m_failedCount = 0;
+    qint64 m_maxQueueDelay = 0;
+    qint64 m_maxLaunchDuration = 0;
+};
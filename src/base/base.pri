@@ -5,6 +5,7 @@ HEADERS += \
     $$PWD/asyncfilestorage.h \
     $$PWD/bittorrent/abstractfilestorage.h \
     $$PWD/bittorrent/addtorrentparams.h \
+    $$PWD/bittorrent/announcescheduler.h \
     $$PWD/bittorrent/bandwidthscheduler.h \
     $$PWD/bittorrent/bencoderesumedatastorage.h \
     $$PWD/bittorrent/cachestatus.h \
@@ -13,6 +14,7 @@ HEADERS += \
     $$PWD/bittorrent/customstorage.h \
     $$PWD/bittorrent/downloadpriority.h \
     $$PWD/bittorrent/dbresumedatastorage.h \
+    $$PWD/bittorrent/demandqueuescheduler.h \
     $$PWD/bittorrent/extensiondata.h \
     $$PWD/bittorrent/filesearcher.h \
     $$PWD/bittorrent/filterparserthread.h \
@@ -22,10 +24,12 @@ HEADERS += \
     $$PWD/bittorrent/ltqhash.h \
     $$PWD/bittorrent/lttypecast.h \
     $$PWD/bittorrent/magneturi.h \
+    $$PWD/bittorrent/memorystatus.h \
     $$PWD/bittorrent/nativesessionextension.h \
     $$PWD/bittorrent/nativetorrentextension.h \
     $$PWD/bittorrent/peeraddress.h \
     $$PWD/bittorrent/peerinfo.h \
+    $$PWD/bittorrent/pieceavailabilitystats.h \
     $$PWD/bittorrent/portforwarderimpl.h \
     $$PWD/bittorrent/resumedatastorage.h \
     $$PWD/bittorrent/session.h \
@@ -36,10 +40,16 @@ HEADERS += \
     $$PWD/bittorrent/torrentcontentlayout.h \
     $$PWD/bittorrent/torrentcontenthandler.h \
     $$PWD/bittorrent/torrentcreatorthread.h \
+    $$PWD/bittorrent/torrenteventbus.h \
     $$PWD/bittorrent/torrentimpl.h \
     $$PWD/bittorrent/torrentinfo.h \
+    $$PWD/bittorrent/torrentsqueue.h \
+    $$PWD/bittorrent/torrenttransferhistory.h \
     $$PWD/bittorrent/tracker.h \
     $$PWD/bittorrent/trackerentry.h \
+    $$PWD/bittorrent/trackerhoststatistics.h \
+    $$PWD/bittorrent/transferhistory.h \
+    $$PWD/bittorrent/uploadallocator.h \
     $$PWD/digest32.h \
     $$PWD/exceptions.h \
     $$PWD/global.h \
@@ -85,6 +95,8 @@ HEADERS += \
     $$PWD/search/searchpluginmanager.h \
     $$PWD/settingsstorage.h \
     $$PWD/settingvalue.h \
+    $$PWD/stringpool.h \
+    $$PWD/tagindex.h \
     $$PWD/tagset.h \
     $$PWD/torrentfileguard.h \
     $$PWD/torrentfileswatcher.h \
@@ -110,11 +122,13 @@ SOURCES += \
     $$PWD/applicationcomponent.cpp \
     $$PWD/asyncfilestorage.cpp \
     $$PWD/bittorrent/abstractfilestorage.cpp \
+    $$PWD/bittorrent/announcescheduler.cpp \
     $$PWD/bittorrent/bandwidthscheduler.cpp \
     $$PWD/bittorrent/bencoderesumedatastorage.cpp \
     $$PWD/bittorrent/categoryoptions.cpp \
     $$PWD/bittorrent/customstorage.cpp \
     $$PWD/bittorrent/dbresumedatastorage.cpp \
+    $$PWD/bittorrent/demandqueuescheduler.cpp \
     $$PWD/bittorrent/downloadpriority.cpp \
     $$PWD/bittorrent/filesearcher.cpp \
     $$PWD/bittorrent/filterparserthread.cpp \
@@ -125,6 +139,7 @@ SOURCES += \
     $$PWD/bittorrent/nativetorrentextension.cpp \
     $$PWD/bittorrent/peeraddress.cpp \
     $$PWD/bittorrent/peerinfo.cpp \
+    $$PWD/bittorrent/pieceavailabilitystats.cpp \
     $$PWD/bittorrent/portforwarderimpl.cpp \
     $$PWD/bittorrent/resumedatastorage.cpp \
     $$PWD/bittorrent/sessionimpl.cpp \
@@ -132,10 +147,16 @@ SOURCES += \
     $$PWD/bittorrent/torrent.cpp \
     $$PWD/bittorrent/torrentcontenthandler.h \
     $$PWD/bittorrent/torrentcreatorthread.cpp \
+    $$PWD/bittorrent/torrenteventbus.cpp \
     $$PWD/bittorrent/torrentimpl.cpp \
     $$PWD/bittorrent/torrentinfo.cpp \
+    $$PWD/bittorrent/torrentsqueue.cpp \
+    $$PWD/bittorrent/torrenttransferhistory.cpp \
     $$PWD/bittorrent/tracker.cpp \
     $$PWD/bittorrent/trackerentry.cpp \
+    $$PWD/bittorrent/trackerhoststatistics.cpp \
+    $$PWD/bittorrent/transferhistory.cpp \
+    $$PWD/bittorrent/uploadallocator.cpp \
     $$PWD/exceptions.cpp \
     $$PWD/http/connection.cpp \
     $$PWD/http/httperror.cpp \
@@ -171,6 +192,8 @@ SOURCES += \
     $$PWD/search/searchhandler.cpp \
     $$PWD/search/searchpluginmanager.cpp \
     $$PWD/settingsstorage.cpp \
+    $$PWD/stringpool.cpp \
+    $$PWD/tagindex.cpp \
     $$PWD/tagset.cpp \
     $$PWD/torrentfileguard.cpp \
     $$PWD/torrentfileswatcher.cpp \
@@ -0,0 +1,282 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "announcescheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "base/global.h"
+#include "base/utils/random.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    // Consider the announce as finished if tracker didn't respond in time
+    const qint64 ANNOUNCE_TIMEOUT = 60 * 1000;
+    // libtorrent doesn't contact every tracker (e.g. the backup tiers),
+    // so the hosts which weren't announced to shortly after the request are released
+    const qint64 ANNOUNCE_START_TIMEOUT = 10 * 1000;
+}
+
+using namespace BitTorrent;
+
+AnnounceScheduler::AnnounceScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setInterval(1s);
+    connect(&m_timer, &QTimer::timeout, this, &AnnounceScheduler::processQueue);
+}
+
+int AnnounceScheduler::window() const
+{
+    return m_window;
+}
+
+void AnnounceScheduler::setWindow(const int seconds)
+{
+    m_window = std::max(0, seconds);
+}
+
+int AnnounceScheduler::maxAnnouncesPerHost() const
+{
+    return m_maxAnnouncesPerHost;
+}
+
+void AnnounceScheduler::setMaxAnnouncesPerHost(const int value)
+{
+    m_maxAnnouncesPerHost = std::max(0, value);
+
+    // the blocked jobs may fit in the new limit
+    const QStringList blockingHosts = m_blockedJobsPerHost.keys();
+    for (const QString &host : blockingHosts)
+        processBlockedJobs(host);
+}
+
+void AnnounceScheduler::schedule(const TorrentID &id, const QStringList &trackerHosts, const bool isPriority)
+{
+    // Keep the existing schedule if the torrent is already waiting to be announced
+    if (m_queuedTorrents.contains(id) || m_blockedJobs.contains(id))
+        return;
+
+    Job job {id, trackerHosts, 0, isPriority};
+    job.trackerHosts.removeDuplicates();
+
+    // Torrents with active leechers get announced within the first half of the window
+    const qint64 windowMSecs = static_cast<qint64>(m_window) * 1000;
+    const qint64 delay = (windowMSecs > 0)
+            ? Utils::Random::rand(0, static_cast<quint32>(isPriority ? (windowMSecs / 2) : windowMSecs))
+            : 0;
+
+    const qint64 time = QDateTime::currentMSecsSinceEpoch() + delay;
+    job.time = time;
+    const auto iter = m_queue.emplace(time, std::move(job));
+    m_queuedTorrents.insert(id, iter);
+
+    if (!m_timer.isActive())
+        m_timer.start();
+}
+
+void AnnounceScheduler::cancel(const TorrentID &id)
+{
+    if (const auto iter = m_queuedTorrents.find(id); iter != m_queuedTorrents.end())
+    {
+        m_queue.erase(iter.value());
+        m_queuedTorrents.erase(iter);
+    }
+
+    // its entry in the list of the blocking host is skipped when the host is released
+    m_blockedJobs.remove(id);
+
+    const QHash<QString, ActiveAnnounce> activeAnnounces = m_activeAnnounces.take(id);
+    for (auto iter = activeAnnounces.cbegin(); iter != activeAnnounces.cend(); ++iter)
+        releaseHost(iter.key());
+}
+
+void AnnounceScheduler::handleAnnounceStarted(const TorrentID &id, const QString &trackerHost)
+{
+    const auto torrentIter = m_activeAnnounces.find(id);
+    if (torrentIter == m_activeAnnounces.end())
+        return;
+
+    const auto hostIter = torrentIter->find(trackerHost);
+    if (hostIter == torrentIter->end())
+        return;
+
+    hostIter->time = QDateTime::currentMSecsSinceEpoch();
+    hostIter->isStarted = true;
+}
+
+void AnnounceScheduler::handleAnnounceFinished(const TorrentID &id, const QString &trackerHost)
+{
+    finishAnnounce(id, trackerHost);
+}
+
+QVector<ScheduledAnnounce> AnnounceScheduler::scheduledAnnounces() const
+{
+    QVector<ScheduledAnnounce> result;
+    result.reserve(static_cast<qsizetype>(m_blockedJobs.size() + m_queue.size()));
+    for (const BlockedJob &blockedJob : asConst(m_blockedJobs))
+        result.append({blockedJob.job.torrentID, QDateTime::fromMSecsSinceEpoch(blockedJob.job.time), blockedJob.job.isPriority});
+    for (const auto &[time, job] : m_queue)
+        result.append({job.torrentID, QDateTime::fromMSecsSinceEpoch(time), job.isPriority});
+    return result;
+}
+
+void AnnounceScheduler::processQueue()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    // Release hosts occupied by announces which weren't sent or replied in time
+    QStringList expiredHosts;
+    for (auto torrentIter = m_activeAnnounces.begin(); torrentIter != m_activeAnnounces.end();)
+    {
+        QHash<QString, ActiveAnnounce> &activeAnnounces = torrentIter.value();
+        for (auto hostIter = activeAnnounces.begin(); hostIter != activeAnnounces.end();)
+        {
+            const qint64 timeout = hostIter->isStarted ? ANNOUNCE_TIMEOUT : ANNOUNCE_START_TIMEOUT;
+            if ((now - hostIter->time) < timeout)
+            {
+                ++hostIter;
+                continue;
+            }
+
+            expiredHosts.append(hostIter.key());
+            hostIter = activeAnnounces.erase(hostIter);
+        }
+
+        torrentIter = (activeAnnounces.isEmpty() ? m_activeAnnounces.erase(torrentIter) : ++torrentIter);
+    }
+
+    // the released hosts may start the blocked jobs, which changes the active announces
+    for (const QString &host : asConst(expiredHosts))
+        releaseHost(host);
+
+    while (!m_queue.empty() && (m_queue.begin()->first <= now))
+    {
+        Job job = std::move(m_queue.begin()->second);
+        m_queue.erase(m_queue.begin());
+        m_queuedTorrents.remove(job.torrentID);
+
+        tryStartAnnounce(std::move(job));
+    }
+
+    if (m_queue.empty() && m_activeAnnounces.isEmpty())
+        m_timer.stop();
+}
+
+QString AnnounceScheduler::findBusyHost(const Job &job) const
+{
+    if (m_maxAnnouncesPerHost <= 0)
+        return {};
+
+    const auto iter = std::find_if(job.trackerHosts.cbegin(), job.trackerHosts.cend(), [this](const QString &host)
+    {
+        return (m_activeAnnouncesPerHost.value(host) >= m_maxAnnouncesPerHost);
+    });
+    return (iter != job.trackerHosts.cend()) ? *iter : QString();
+}
+
+void AnnounceScheduler::tryStartAnnounce(Job job)
+{
+    if (const QString busyHost = findBusyHost(job); !busyHost.isEmpty())
+    {
+        const TorrentID torrentID = job.torrentID;
+        m_blockedJobs.insert(torrentID, {std::move(job), busyHost});
+        m_blockedJobsPerHost[busyHost].enqueue(torrentID);
+        return;
+    }
+
+    startAnnounce(job);
+    emit announceRequested(job.torrentID);
+}
+
+void AnnounceScheduler::startAnnounce(const Job &job)
+{
+    if (job.trackerHosts.isEmpty())
+        return;
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QHash<QString, ActiveAnnounce> &activeAnnounces = m_activeAnnounces[job.torrentID];
+    for (const QString &host : job.trackerHosts)
+    {
+        if (!activeAnnounces.contains(host))
+            ++m_activeAnnouncesPerHost[host];
+        activeAnnounces[host] = {now, false};
+    }
+
+    if (!m_timer.isActive())
+        m_timer.start();
+}
+
+void AnnounceScheduler::finishAnnounce(const TorrentID &id, const QString &trackerHost)
+{
+    const auto torrentIter = m_activeAnnounces.find(id);
+    if (torrentIter == m_activeAnnounces.end())
+        return;
+
+    if (torrentIter->remove(trackerHost) == 0)
+        return;
+
+    if (torrentIter->isEmpty())
+        m_activeAnnounces.erase(torrentIter);
+    releaseHost(trackerHost);
+}
+
+void AnnounceScheduler::releaseHost(const QString &trackerHost)
+{
+    if (--m_activeAnnouncesPerHost[trackerHost] <= 0)
+        m_activeAnnouncesPerHost.remove(trackerHost);
+
+    processBlockedJobs(trackerHost);
+}
+
+void AnnounceScheduler::processBlockedJobs(const QString &trackerHost)
+{
+    // Starting a job may block it on another host, which modifies the lists, so the iterators aren't kept
+    while ((m_maxAnnouncesPerHost <= 0) || (m_activeAnnouncesPerHost.value(trackerHost) < m_maxAnnouncesPerHost))
+    {
+        const auto hostIter = m_blockedJobsPerHost.find(trackerHost);
+        if (hostIter == m_blockedJobsPerHost.end())
+            return;
+
+        const TorrentID torrentID = hostIter->dequeue();
+        if (hostIter->isEmpty())
+            m_blockedJobsPerHost.erase(hostIter);
+
+        // skip the jobs canceled or rescheduled meanwhile
+        const auto jobIter = m_blockedJobs.find(torrentID);
+        if ((jobIter == m_blockedJobs.end()) || (jobIter->blockingHost != trackerHost))
+            continue;
+
+        Job job = std::move(jobIter->job);
+        m_blockedJobs.erase(jobIter);
+        tryStartAnnounce(std::move(job));
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <map>
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QQueue>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    struct ScheduledAnnounce
+    {
+        TorrentID torrentID;
+        QDateTime time;
+        bool isPriority = false;
+    };
+
+    // Spreads session-wide reannounces over a time window
+    // and limits the number of simultaneous announces to the same tracker host
+    class AnnounceScheduler final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(AnnounceScheduler)
+
+    public:
+        explicit AnnounceScheduler(QObject *parent = nullptr);
+
+        int window() const;
+        void setWindow(int seconds);
+        int maxAnnouncesPerHost() const;
+        void setMaxAnnouncesPerHost(int value);
+
+        // Trackers are identified by their hosts, which the session keeps cached per tracker URL
+        void schedule(const TorrentID &id, const QStringList &trackerHosts, bool isPriority);
+        void cancel(const TorrentID &id);
+        void handleAnnounceStarted(const TorrentID &id, const QString &trackerHost);
+        void handleAnnounceFinished(const TorrentID &id, const QString &trackerHost);
+
+        QVector<ScheduledAnnounce> scheduledAnnounces() const;
+
+    signals:
+        void announceRequested(const TorrentID &id);
+
+    private:
+        struct Job
+        {
+            TorrentID torrentID;
+            QStringList trackerHosts;
+            qint64 time = 0;
+            bool isPriority = false;
+        };
+
+        struct BlockedJob
+        {
+            Job job;
+            QString blockingHost;
+        };
+
+        struct ActiveAnnounce
+        {
+            qint64 time = 0;
+            // whether libtorrent has actually sent the announce to the host
+            bool isStarted = false;
+        };
+
+        using Queue = std::multimap<qint64, Job>;
+
+        void processQueue();
+        QString findBusyHost(const Job &job) const;
+        void tryStartAnnounce(Job job);
+        void startAnnounce(const Job &job);
+        void finishAnnounce(const TorrentID &id, const QString &trackerHost);
+        void releaseHost(const QString &trackerHost);
+        void processBlockedJobs(const QString &trackerHost);
+
+        int m_window = 0;
+        int m_maxAnnouncesPerHost = 0;
+
+        Queue m_queue;
+        QHash<TorrentID, Queue::iterator> m_queuedTorrents;
+        // due jobs waiting for a host to be released, each one is listed under the first busy host it has
+        QHash<TorrentID, BlockedJob> m_blockedJobs;
+        QHash<QString, QQueue<TorrentID>> m_blockedJobsPerHost;
+        // announces started by the scheduler which are not replied yet
+        QHash<TorrentID, QHash<QString, ActiveAnnounce>> m_activeAnnounces;
+        QHash<QString, int> m_activeAnnouncesPerHost;
+        QTimer m_timer;
+    };
+}
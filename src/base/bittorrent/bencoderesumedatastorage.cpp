@@ -241,6 +241,9 @@ BitTorrent::LoadResumeDataResult BitTorrent::BencodeResumeDataStorage::loadTorre
     torrentParams.stopCondition = Utils::String::toEnum(
                 fromLTString(resumeDataRoot.dict_find_string_value("qBt-stopCondition")), Torrent::StopCondition::None);
 
+    const lt::string_view transferHistory = resumeDataRoot.dict_find_string_value("qBt-transferHistory");
+    torrentParams.transferHistory = QByteArray(transferHistory.data(), static_cast<int>(transferHistory.size()));
+
     const lt::string_view ratioLimitString = resumeDataRoot.dict_find_string_value("qBt-ratioLimit");
     if (ratioLimitString.empty())
         torrentParams.ratioLimit = resumeDataRoot.dict_find_int_value("qBt-ratioLimit", Torrent::USE_GLOBAL_RATIO * 1000) / 1000.0;
@@ -321,6 +324,12 @@ void BitTorrent::BencodeResumeDataStorage::storeQueue(const QVector<TorrentID> &
     });
 }
 
+void BitTorrent::BencodeResumeDataStorage::updateQueue(const QVector<TorrentID> &queue, [[maybe_unused]] const int from, [[maybe_unused]] const int to) const
+{
+    // Queue file can't be modified partially
+    storeQueue(queue);
+}
+
 BitTorrent::BencodeResumeDataStorage::Worker::Worker(const Path &resumeDataDir)
     : m_resumeDataDir {resumeDataDir}
 {
@@ -384,6 +393,7 @@ void BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, co
     data["qBt-contentLayout"] = Utils::String::fromEnum(resumeData.contentLayout).toStdString();
     data["qBt-firstLastPiecePriority"] = resumeData.firstLastPiecePriority;
     data["qBt-stopCondition"] = Utils::String::fromEnum(resumeData.stopCondition).toStdString();
+    data["qBt-transferHistory"] = resumeData.transferHistory.toStdString();
 
     if (!resumeData.useAutoTMM)
     {
@@ -28,6 +28,7 @@
 
 #include "dbresumedatastorage.h"
 
+#include <algorithm>
 #include <utility>
 
 #include <libtorrent/bdecode.hpp>
@@ -61,7 +62,7 @@ namespace
 {
     const QString DB_CONNECTION_NAME = u"ResumeDataStorage"_qs;
 
-    const int DB_VERSION = 3;
+    const int DB_VERSION = 4;
 
     const QString DB_TABLE_META = u"meta"_qs;
     const QString DB_TABLE_TORRENTS = u"torrents"_qs;
@@ -97,6 +98,7 @@ namespace
     const Column DB_COLUMN_STOP_CONDITION = makeColumn("stop_condition");
     const Column DB_COLUMN_RESUMEDATA = makeColumn("libtorrent_resume_data");
     const Column DB_COLUMN_METADATA = makeColumn("metadata");
+    const Column DB_COLUMN_TRANSFER_HISTORY = makeColumn("transfer_history");
     const Column DB_COLUMN_VALUE = makeColumn("value");
 
     template <typename LTStr>
@@ -183,7 +185,7 @@ namespace BitTorrent
 
         void store(const TorrentID &id, const LoadTorrentParams &resumeData) const;
         void remove(const TorrentID &id) const;
-        void storeQueue(const QVector<TorrentID> &queue) const;
+        void storeQueue(const QVector<TorrentID> &queue, int from, int to) const;
 
     private:
         const Path m_path;
@@ -215,6 +217,7 @@ namespace BitTorrent
             resumeData.stopped = query.value(DB_COLUMN_STOPPED.name).toBool();
             resumeData.stopCondition = Utils::String::toEnum(
                         query.value(DB_COLUMN_STOP_CONDITION.name).toString(), Torrent::StopCondition::None);
+            resumeData.transferHistory = query.value(DB_COLUMN_TRANSFER_HISTORY.name).toByteArray();
 
             resumeData.savePath = Profile::instance()->fromPortablePath(
                         Path(query.value(DB_COLUMN_TARGET_SAVE_PATH.name).toString()));
@@ -371,7 +374,15 @@ void BitTorrent::DBResumeDataStorage::storeQueue(const QVector<TorrentID> &queue
 {
     QMetaObject::invokeMethod(m_asyncWorker, [this, queue]()
     {
-        m_asyncWorker->storeQueue(queue);
+        m_asyncWorker->storeQueue(queue, 0, (static_cast<int>(queue.size()) - 1));
+    });
+}
+
+void BitTorrent::DBResumeDataStorage::updateQueue(const QVector<TorrentID> &queue, const int from, const int to) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, queue, from, to]()
+    {
+        m_asyncWorker->storeQueue(queue, from, to);
     });
 }
 
@@ -505,7 +516,8 @@ void BitTorrent::DBResumeDataStorage::createDB() const
             makeColumnDefinition(DB_COLUMN_STOPPED, "INTEGER NOT NULL"),
             makeColumnDefinition(DB_COLUMN_STOP_CONDITION, "TEXT NOT NULL DEFAULT `None`"),
             makeColumnDefinition(DB_COLUMN_RESUMEDATA, "BLOB NOT NULL"),
-            makeColumnDefinition(DB_COLUMN_METADATA, "BLOB")
+            makeColumnDefinition(DB_COLUMN_METADATA, "BLOB"),
+            makeColumnDefinition(DB_COLUMN_TRANSFER_HISTORY, "BLOB")
         };
         const QString createTableTorrentsQuery = makeCreateTableStatement(DB_TABLE_TORRENTS, tableTorrentsItems);
         if (!query.exec(createTableTorrentsQuery))
@@ -553,6 +565,14 @@ void BitTorrent::DBResumeDataStorage::updateDB(const int fromVersion) const
                 throw RuntimeError(query.lastError().text());
         }
 
+        if (fromVersion <= 3)
+        {
+            const auto alterTableTorrentsQuery = u"ALTER TABLE %1 ADD %2"_qs
+                    .arg(quoted(DB_TABLE_TORRENTS), makeColumnDefinition(DB_COLUMN_TRANSFER_HISTORY, "BLOB"));
+            if (!query.exec(alterTableTorrentsQuery))
+                throw RuntimeError(query.lastError().text());
+        }
+
         const QString updateMetaVersionQuery = makeUpdateStatement(DB_TABLE_META, {DB_COLUMN_NAME, DB_COLUMN_VALUE});
         if (!query.prepare(updateMetaVersionQuery))
             throw RuntimeError(query.lastError().text());
@@ -649,7 +669,8 @@ void BitTorrent::DBResumeDataStorage::Worker::store(const TorrentID &id, const L
         DB_COLUMN_OPERATING_MODE,
         DB_COLUMN_STOPPED,
         DB_COLUMN_STOP_CONDITION,
-        DB_COLUMN_RESUMEDATA
+        DB_COLUMN_RESUMEDATA,
+        DB_COLUMN_TRANSFER_HISTORY
     };
 
     lt::entry data = lt::write_resume_data(p);
@@ -716,6 +737,7 @@ void BitTorrent::DBResumeDataStorage::Worker::store(const TorrentID &id, const L
         }
 
         query.bindValue(DB_COLUMN_RESUMEDATA.placeholder, bencodedResumeData);
+        query.bindValue(DB_COLUMN_TRANSFER_HISTORY.placeholder, resumeData.transferHistory);
         if (!bencodedMetadata.isEmpty())
             query.bindValue(DB_COLUMN_METADATA.placeholder, bencodedMetadata);
 
@@ -756,7 +778,7 @@ void BitTorrent::DBResumeDataStorage::Worker::remove(const TorrentID &id) const
     }
 }
 
-void BitTorrent::DBResumeDataStorage::Worker::storeQueue(const QVector<TorrentID> &queue) const
+void BitTorrent::DBResumeDataStorage::Worker::storeQueue(const QVector<TorrentID> &queue, const int from, const int to) const
 {
     const auto updateQueuePosStatement = u"UPDATE %1 SET %2 = %3 WHERE %4 = %5;"_qs
             .arg(quoted(DB_TABLE_TORRENTS), quoted(DB_COLUMN_QUEUE_POSITION.name), DB_COLUMN_QUEUE_POSITION.placeholder
@@ -778,11 +800,11 @@ void BitTorrent::DBResumeDataStorage::Worker::storeQueue(const QVector<TorrentID
             if (!query.prepare(updateQueuePosStatement))
                 throw RuntimeError(query.lastError().text());
 
-            int pos = 0;
-            for (const TorrentID &torrentID : queue)
+            const int lastPos = std::min(to, (static_cast<int>(queue.size()) - 1));
+            for (int pos = std::max(from, 0); pos <= lastPos; ++pos)
             {
-                query.bindValue(DB_COLUMN_TORRENT_ID.placeholder, torrentID.toString());
-                query.bindValue(DB_COLUMN_QUEUE_POSITION.placeholder, pos++);
+                query.bindValue(DB_COLUMN_TORRENT_ID.placeholder, queue[pos].toString());
+                query.bindValue(DB_COLUMN_QUEUE_POSITION.placeholder, pos);
                 if (!query.exec())
                     throw RuntimeError(query.lastError().text());
             }
@@ -53,6 +53,7 @@ namespace BitTorrent
         void store(const TorrentID &id, const LoadTorrentParams &resumeData) const override;
         void remove(const TorrentID &id) const override;
         void storeQueue(const QVector<TorrentID> &queue) const override;
+        void updateQueue(const QVector<TorrentID> &queue, int from, int to) const override;
 
     private:
         void doLoadAll() const override;
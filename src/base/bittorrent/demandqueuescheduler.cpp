@@ -0,0 +1,117 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "demandqueuescheduler.h"
+
+#include <algorithm>
+
+#include "torrent.h"
+
+namespace
+{
+    // Recent upload rate which weighs as much as one leecher per seed
+    const qint64 UPLOAD_RATE_UNIT = 100 * 1024;
+}
+
+using namespace BitTorrent;
+
+bool DemandQueueScheduler::isCandidate(const Torrent *torrent)
+{
+    return torrent->hasMetadata() && torrent->isFinished()
+        && !torrent->isPaused() && !torrent->isForced()
+        && !torrent->isChecking() && !torrent->isMoving()
+        && !torrent->isErrored() && !torrent->hasMissingFiles();
+}
+
+qreal DemandQueueScheduler::score(const int seeds, const int leechers, const qint64 recentUploadRate)
+{
+    return (static_cast<qreal>(std::max(0, leechers)) / (std::max(0, seeds) + 1))
+            + (static_cast<qreal>(std::max<qint64>(0, recentUploadRate)) / UPLOAD_RATE_UNIT);
+}
+
+void DemandQueueScheduler::assignSlots(QVector<DemandQueueEntry> &entries, const int activeSlots)
+{
+    // Keep currently active torrents on ties to avoid needless rotation
+    std::stable_sort(entries.begin(), entries.end(), [](const DemandQueueEntry &left, const DemandQueueEntry &right)
+    {
+        if (left.score != right.score)
+            return (left.score > right.score);
+        return (left.isActive && !right.isActive);
+    });
+
+    const int candidatesCount = static_cast<int>(entries.size());
+    const int count = (activeSlots < 0) ? candidatesCount : std::min(activeSlots, candidatesCount);
+    for (int i = 0; i < candidatesCount; ++i)
+        entries[i].shouldBeActive = (i < count);
+}
+
+QVector<DemandQueueEntry> DemandQueueScheduler::rank(const QVector<Torrent *> &torrents, const int activeSlots) const
+{
+    const qint64 elapsedSecs = m_baselineTimer.isValid() ? std::max<qint64>(1, (m_baselineTimer.elapsed() / 1000)) : 0;
+
+    QVector<DemandQueueEntry> entries;
+    entries.reserve(torrents.size());
+    for (const Torrent *torrent : torrents)
+    {
+        if (!isCandidate(torrent))
+            continue;
+
+        DemandQueueEntry entry;
+        entry.torrentID = torrent->id();
+        entry.seeds = std::max(0, torrent->totalSeedsCount());
+        entry.leechers = std::max(0, torrent->totalLeechersCount());
+        if (elapsedSecs > 0)
+        {
+            const auto baselineIter = m_uploadBaselines.constFind(entry.torrentID);
+            if (baselineIter != m_uploadBaselines.cend())
+                entry.recentUploadRate = std::max<qint64>(0, (torrent->totalPayloadUpload() - baselineIter.value())) / elapsedSecs;
+        }
+        entry.score = score(entry.seeds, entry.leechers, entry.recentUploadRate);
+        entry.isActive = !torrent->isQueued();
+        entries.append(entry);
+    }
+
+    assignSlots(entries, activeSlots);
+    return entries;
+}
+
+void DemandQueueScheduler::commit(const QVector<Torrent *> &torrents)
+{
+    m_uploadBaselines.clear();
+    for (const Torrent *torrent : torrents)
+    {
+        if (isCandidate(torrent))
+            m_uploadBaselines.insert(torrent->id(), torrent->totalPayloadUpload());
+    }
+
+    m_baselineTimer.start();
+}
+
+void DemandQueueScheduler::removeTorrent(const TorrentID &id)
+{
+    m_uploadBaselines.remove(id);
+}
@@ -0,0 +1,72 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QVector>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    class Torrent;
+
+    struct DemandQueueEntry
+    {
+        TorrentID torrentID;
+        qreal score = 0;
+        int seeds = 0;
+        int leechers = 0;
+        // average upload rate since the last rotation (bytes per second)
+        qint64 recentUploadRate = 0;
+        bool isActive = false;
+        bool shouldBeActive = false;
+    };
+
+    // Ranks auto managed seeding torrents by the demand for them, so that the limited
+    // number of active seeding slots is given to the torrents the swarms need the most
+    class DemandQueueScheduler
+    {
+    public:
+        static bool isCandidate(const Torrent *torrent);
+        static qreal score(int seeds, int leechers, qint64 recentUploadRate);
+        // Orders the entries by score and marks the first activeSlots of them to be active
+        static void assignSlots(QVector<DemandQueueEntry> &entries, int activeSlots);
+
+        // Returns candidates ordered by score, the first activeSlots of them should be active
+        QVector<DemandQueueEntry> rank(const QVector<Torrent *> &torrents, int activeSlots) const;
+        // Starts measuring the recent upload from now
+        void commit(const QVector<Torrent *> &torrents);
+        void removeTorrent(const TorrentID &id);
+
+    private:
+        QHash<TorrentID, qint64> m_uploadBaselines;
+        QElapsedTimer m_baselineTimer;
+    };
+}
@@ -91,6 +91,11 @@ BitTorrent::InfoHash::operator WrappedType() const
     return m_nativeHash;
 }
 
+BitTorrent::TorrentID::TorrentID(const BaseType &digest)
+    : BaseType {digest}
+{
+}
+
 BitTorrent::TorrentID BitTorrent::TorrentID::fromString(const QString &hashString)
 {
     return TorrentID(BaseType::fromString(hashString));
@@ -42,6 +42,9 @@ using SHA256Hash = Digest32<256>;
 
 Q_DECLARE_METATYPE(SHA1Hash)
 Q_DECLARE_METATYPE(SHA256Hash)
+// zero-filled memory is a valid (default constructed) digest
+Q_DECLARE_TYPEINFO(SHA1Hash, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(SHA256Hash, Q_PRIMITIVE_TYPE);
 
 namespace BitTorrent
 {
@@ -53,6 +56,9 @@ namespace BitTorrent
         using BaseType = Digest32<160>;
         using BaseType::BaseType;
 
+        TorrentID() = default;
+        explicit TorrentID(const BaseType &digest);
+
         static TorrentID fromString(const QString &hashString);
         static TorrentID fromInfoHash(const InfoHash &infoHash);
         static TorrentID fromSHA1Hash(const SHA1Hash &hash);
@@ -98,6 +104,12 @@ namespace BitTorrent
 }
 
 Q_DECLARE_METATYPE(BitTorrent::TorrentID)
-// We can declare it as Q_MOVABLE_TYPE to improve performance
-// since base type uses QSharedDataPointer as the only member
-Q_DECLARE_TYPEINFO(BitTorrent::TorrentID, Q_MOVABLE_TYPE);
+Q_DECLARE_TYPEINFO(BitTorrent::TorrentID, Q_PRIMITIVE_TYPE);
+
+namespace std
+{
+    template <>
+    struct hash<BitTorrent::TorrentID> : hash<BitTorrent::TorrentID::BaseType>
+    {
+    };
+}
@@ -30,6 +30,7 @@
 
 #include <libtorrent/add_torrent_params.hpp>
 
+#include <QByteArray>
 #include <QString>
 
 #include "base/path.h"
@@ -60,5 +61,8 @@ namespace BitTorrent
 
         qreal ratioLimit = Torrent::USE_GLOBAL_RATIO;
         int seedingTimeLimit = Torrent::USE_GLOBAL_SEEDING_TIME;
+
+        // encoded TorrentTransferHistory
+        QByteArray transferHistory;
     };
 }
@@ -0,0 +1,105 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "pieceavailabilitystats.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QBitArray>
+
+bool BitTorrent::PieceAvailabilityStats::isRarityKnown() const
+{
+    return (peersCount > 0);
+}
+
+qreal BitTorrent::PieceAvailabilityStats::rareDataScore() const
+{
+    if ((piecesCount <= 0) || !isRarityKnown())
+        return 0;
+
+    // Data nobody else can provide weighs more than data which is just rare
+    return (uniqueHeldPieces + (0.5 * (rareHeldPieces - uniqueHeldPieces))) / piecesCount;
+}
+
+BitTorrent::PieceAvailabilityStats BitTorrent::computePieceAvailabilityStats(const std::vector<int> &availability, const QBitArray &havePieces, const int peersCount)
+{
+    PieceAvailabilityStats stats;
+    if (availability.empty())
+        return stats;
+
+    stats.piecesCount = static_cast<int>(availability.size());
+    stats.peersCount = std::max(0, peersCount);
+    // Every piece has zero availability when no peers are connected, which doesn't make it rare
+    const bool isRarityKnown = stats.isRarityKnown();
+    stats.histogram.fill(0, (PieceAvailabilityStats::MAX_HISTOGRAM_AVAILABILITY + 1));
+    stats.minAvailability = std::numeric_limits<int>::max();
+
+    qint64 availabilitySum = 0;
+    PieceAvailabilityRun run;
+    for (int i = 0; i < stats.piecesCount; ++i)
+    {
+        const int pieceAvailability = std::max(0, availability[i]);
+        const bool isHeld = (i < havePieces.size()) && havePieces.testBit(i);
+
+        availabilitySum += pieceAvailability;
+        stats.minAvailability = std::min(stats.minAvailability, pieceAvailability);
+        ++stats.histogram[std::min(pieceAvailability, PieceAvailabilityStats::MAX_HISTOGRAM_AVAILABILITY)];
+
+        if (isRarityKnown && (pieceAvailability <= PieceAvailabilityStats::RARE_AVAILABILITY))
+        {
+            ++stats.rarePieces;
+            if (isHeld)
+                ++stats.rareHeldPieces;
+        }
+
+        if (isRarityKnown && (pieceAvailability == 0))
+        {
+            if (isHeld)
+                ++stats.uniqueHeldPieces;
+            else
+                ++stats.unavailablePieces;
+        }
+
+        if ((run.length > 0) && (run.availability != pieceAvailability))
+        {
+            stats.runs.append(run);
+            run.length = 0;
+        }
+        run.availability = pieceAvailability;
+        ++run.length;
+    }
+    stats.runs.append(run);
+
+    stats.averageAvailability = static_cast<qreal>(availabilitySum) / stats.piecesCount;
+
+    // Trailing empty buckets carry no information
+    while ((stats.histogram.size() > 1) && (stats.histogram.last() == 0))
+        stats.histogram.removeLast();
+
+    return stats;
+}
@@ -0,0 +1,81 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <vector>
+
+#include <QtGlobal>
+#include <QVector>
+
+#include "infohash.h"
+
+class QBitArray;
+
+namespace BitTorrent
+{
+    struct PieceAvailabilityRun
+    {
+        int availability = 0;
+        int length = 0;
+    };
+
+    // Compact summary of the availability of torrent pieces among the connected peers
+    struct PieceAvailabilityStats
+    {
+        // Pieces available from this number of peers or less are considered rare
+        static constexpr int RARE_AVAILABILITY = 1;
+        // Pieces available from more peers are counted in the last histogram bucket
+        static constexpr int MAX_HISTOGRAM_AVAILABILITY = 32;
+
+        TorrentID torrentID;
+        qint64 updateTime = 0; // seconds since epoch
+        int piecesCount = 0;
+        // Number of connected peers the availability was collected from,
+        // without them the rarity of the pieces is unknown and isn't counted
+        int peersCount = 0;
+        int minAvailability = 0;
+        qreal averageAvailability = 0;
+        // Number of pieces by availability
+        QVector<int> histogram;
+        // Availability of consecutive pieces, run-length encoded
+        QVector<PieceAvailabilityRun> runs;
+        // Rare pieces, whether or not we have them
+        int rarePieces = 0;
+        // Pieces which neither we nor the connected peers have
+        int unavailablePieces = 0;
+        // Rare pieces we have
+        int rareHeldPieces = 0;
+        // Pieces we have and none of the connected peers does
+        int uniqueHeldPieces = 0;
+
+        bool isRarityKnown() const;
+        qreal rareDataScore() const;
+    };
+
+    PieceAvailabilityStats computePieceAvailabilityStats(const std::vector<int> &availability, const QBitArray &havePieces, int peersCount);
+}
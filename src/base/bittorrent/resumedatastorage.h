@@ -63,6 +63,8 @@ namespace BitTorrent
         virtual void store(const TorrentID &id, const LoadTorrentParams &resumeData) const = 0;
         virtual void remove(const TorrentID &id) const = 0;
         virtual void storeQueue(const QVector<TorrentID> &queue) const = 0;
+        // Stores only the positions in range [from, to] assuming the rest of the queue is already stored
+        virtual void updateQueue(const QVector<TorrentID> &queue, int from, int to) const = 0;
 
         void loadAll() const;
         QList<LoadedResumeData> fetchLoadedResumeData() const;
@@ -38,6 +38,7 @@
 #include "trackerentry.h"
 
 class QString;
+class TagIndex;
 
 // These values should remain unchanged when adding new items
 // so as not to break the existing user settings.
@@ -62,8 +63,14 @@ namespace BitTorrent
     class Torrent;
     class TorrentID;
     class TorrentInfo;
+    class TransferHistory;
     struct CacheStatus;
+    struct DemandQueueEntry;
+    struct MemoryStatus;
+    struct PieceAvailabilityStats;
+    struct ScheduledAnnounce;
     struct SessionStatus;
+    struct TrackerHostStatus;
 
     // Using `Q_ENUM_NS()` without a wrapper namespace in our case is not advised
     // since `Q_NAMESPACE` cannot be used when the same namespace resides at different files.
@@ -175,6 +182,8 @@ namespace BitTorrent
         virtual bool hasTag(const QString &tag) const = 0;
         virtual bool addTag(const QString &tag) = 0;
         virtual bool removeTag(const QString &tag) = 0;
+        // tag membership of the torrents is stored as bits indexed by it, see Torrent::tagBits()
+        virtual const TagIndex &tagIndex() const = 0;
 
         // Torrent Management Mode subsystem (TMM)
         //
@@ -334,6 +343,18 @@ namespace BitTorrent
         virtual void setUploadRateForSlowTorrents(int rateInKibiBytes) = 0;
         virtual int slowTorrentsInactivityTimer() const = 0;
         virtual void setSlowTorrentsInactivityTimer(int timeInSeconds) = 0;
+        virtual bool isDynamicQueueingEnabled() const = 0;
+        virtual void setDynamicQueueingEnabled(bool enabled) = 0;
+        virtual int dynamicQueueingInterval() const = 0;
+        virtual void setDynamicQueueingInterval(int minutes) = 0;
+        virtual QVector<DemandQueueEntry> dynamicQueueingReport() const = 0;
+        virtual bool isUploadAllocationEnabled() const = 0;
+        virtual void setUploadAllocationEnabled(bool enabled) = 0;
+        // Piece availability statistics are collected in background, so the cached ones are returned
+        // and the outdated ones are scheduled to be refreshed
+        virtual PieceAvailabilityStats pieceAvailabilityStats(const TorrentID &id) = 0;
+        // Returns statistics of torrents we have rare pieces of, ordered by the rareness of the data
+        virtual QVector<PieceAvailabilityStats> rareDataRanking() = 0;
         virtual int outgoingPortsMin() const = 0;
         virtual void setOutgoingPortsMin(int min) = 0;
         virtual int outgoingPortsMax() const = 0;
@@ -353,6 +374,12 @@ namespace BitTorrent
         virtual bool isReannounceWhenAddressChangedEnabled() const = 0;
         virtual void setReannounceWhenAddressChangedEnabled(bool enabled) = 0;
         virtual void reannounceToAllTrackers() const = 0;
+        virtual int announceJitterWindow() const = 0;
+        virtual void setAnnounceJitterWindow(int value) = 0;
+        virtual int maxAnnouncesPerTrackerHost() const = 0;
+        virtual void setMaxAnnouncesPerTrackerHost(int value) = 0;
+        virtual QVector<ScheduledAnnounce> scheduledAnnounces() const = 0;
+        virtual QVector<TrackerHostStatus> trackerHostStatuses() const = 0;
         virtual int stopTrackerTimeout() const = 0;
         virtual void setStopTrackerTimeout(int value) = 0;
         virtual int maxConnections() const = 0;
@@ -405,6 +432,8 @@ namespace BitTorrent
         virtual qsizetype torrentsCount() const = 0;
         virtual const SessionStatus &status() const = 0;
         virtual const CacheStatus &cacheStatus() const = 0;
+        virtual MemoryStatus memoryStatus() const = 0;
+        virtual const TransferHistory &transferHistory() const = 0;
         virtual bool isListening() const = 0;
 
         virtual MaxRatioAction maxRatioAction() const = 0;
@@ -466,6 +495,6 @@ namespace BitTorrent
         void trackersRemoved(Torrent *torrent, const QStringList &trackers);
         void trackerSuccess(Torrent *torrent, const QString &tracker);
         void trackerWarning(Torrent *torrent, const QString &tracker);
-        void trackerEntriesUpdated(Torrent *torrent, const QHash<QString, TrackerEntry> &updatedTrackerEntries);
+        void trackerEntriesUpdated(const QHash<Torrent *, QHash<QString, TrackerEntry>> &updateInfos);
     };
 }
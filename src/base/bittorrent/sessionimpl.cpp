@@ -32,6 +32,7 @@
 #include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <ctime>
 #include <queue>
 #include <string>
@@ -58,6 +59,7 @@
 #include <libtorrent/session_status.hpp>
 #include <libtorrent/torrent_info.hpp>
 
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
@@ -95,6 +97,7 @@
 #include "base/utils/net.h"
 #include "base/utils/random.h"
 #include "base/version.h"
+#include "announcescheduler.h"
 #include "bandwidthscheduler.h"
 #include "bencoderesumedatastorage.h"
 #include "common.h"
@@ -107,6 +110,7 @@
 #include "loadtorrentparams.h"
 #include "lttypecast.h"
 #include "magneturi.h"
+#include "memorystatus.h"
 #include "nativesessionextension.h"
 #include "portforwarderimpl.h"
 #include "resumedatastorage.h"
@@ -117,18 +121,11 @@ using namespace std::chrono_literals;
 using namespace BitTorrent;
 
 const Path CATEGORIES_FILE_NAME {u"categories.json"_qs};
+const Path TRANSFER_HISTORY_FILE_NAME {u"transfer_history.dat"_qs};
 const int MAX_PROCESSING_RESUMEDATA_COUNT = 50;
 const int STATISTICS_SAVE_INTERVAL = std::chrono::milliseconds(15min).count();
 
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
-namespace std
-{
-    uint qHash(const std::string &key, uint seed = 0)
-    {
-        return qHash(QByteArray::fromRawData(key.data(), static_cast<int>(key.length())), seed);
-    }
-}
-
 namespace libtorrent
 {
     uint qHash(const libtorrent::torrent_handle &key)
@@ -446,6 +443,9 @@ SessionImpl::SessionImpl(QObject *parent)
     , m_downloadRateForSlowTorrents(BITTORRENT_SESSION_KEY(u"SlowTorrentsDownloadRate"_qs), 2)
     , m_uploadRateForSlowTorrents(BITTORRENT_SESSION_KEY(u"SlowTorrentsUploadRate"_qs), 2)
     , m_slowTorrentsInactivityTimer(BITTORRENT_SESSION_KEY(u"SlowTorrentsInactivityTimer"_qs), 60)
+    , m_isDynamicQueueingEnabled(BITTORRENT_SESSION_KEY(u"DynamicQueueingEnabled"_qs), false)
+    , m_dynamicQueueingInterval(BITTORRENT_SESSION_KEY(u"DynamicQueueingInterval"_qs), 30, lowerLimited(1))
+    , m_isUploadAllocationEnabled(BITTORRENT_SESSION_KEY(u"UploadAllocationEnabled"_qs), false)
     , m_outgoingPortsMin(BITTORRENT_SESSION_KEY(u"OutgoingPortsMin"_qs), 0)
     , m_outgoingPortsMax(BITTORRENT_SESSION_KEY(u"OutgoingPortsMax"_qs), 0)
     , m_UPnPLeaseDuration(BITTORRENT_SESSION_KEY(u"UPnPLeaseDuration"_qs), 0)
@@ -456,6 +456,8 @@ SessionImpl::SessionImpl(QObject *parent)
     , m_maxConcurrentHTTPAnnounces(BITTORRENT_SESSION_KEY(u"MaxConcurrentHTTPAnnounces"_qs), 50)
     , m_isReannounceWhenAddressChangedEnabled(BITTORRENT_SESSION_KEY(u"ReannounceWhenAddressChanged"_qs), false)
     , m_stopTrackerTimeout(BITTORRENT_SESSION_KEY(u"StopTrackerTimeout"_qs), 5)
+    , m_announceJitterWindow(BITTORRENT_SESSION_KEY(u"AnnounceJitterWindow"_qs), 60, lowerLimited(0))
+    , m_maxAnnouncesPerTrackerHost(BITTORRENT_SESSION_KEY(u"MaxAnnouncesPerTrackerHost"_qs), 10, lowerLimited(0))
     , m_maxConnections(BITTORRENT_SESSION_KEY(u"MaxConnections"_qs), 500, lowerLimited(0, -1))
     , m_maxUploads(BITTORRENT_SESSION_KEY(u"MaxUploads"_qs), 20, lowerLimited(0, -1))
     , m_maxConnectionsPerTorrent(BITTORRENT_SESSION_KEY(u"MaxConnectionsPerTorrent"_qs), 100, lowerLimited(0, -1))
@@ -532,6 +534,11 @@ SessionImpl::SessionImpl(QObject *parent)
     , m_resumeDataStorageType(BITTORRENT_SESSION_KEY(u"ResumeDataStorageType"_qs), ResumeDataStorageType::Legacy)
     , m_seedingLimitTimer {new QTimer(this)}
     , m_resumeDataTimer {new QTimer(this)}
+    , m_announceScheduler {new AnnounceScheduler(this)}
+    , m_dynamicQueueingTimer {new QTimer(this)}
+    , m_uploadAllocationTimer {new QTimer(this)}
+    , m_transferHistorySaveTimer {new QTimer(this)}
+    , m_torrentsTransferHistoryTimer {new QTimer(this)}
     , m_ioThread {new QThread}
     , m_asyncWorker {new QThreadPool(this)}
     , m_recentErroredTorrentsTimer {new QTimer(this)}
@@ -545,6 +552,25 @@ SessionImpl::SessionImpl(QObject *parent)
     if (port() < 0)
         m_port = Utils::Random::rand(1024, 65535);
 
+    m_announceScheduler->setWindow(m_announceJitterWindow);
+    m_announceScheduler->setMaxAnnouncesPerHost(m_maxAnnouncesPerTrackerHost);
+    connect(m_announceScheduler, &AnnounceScheduler::announceRequested, this, [this](const TorrentID &id)
+    {
+        TorrentImpl *torrent = m_torrents.value(id);
+        if (!torrent)
+            return;
+
+        // Trackers on backed off hosts keep their postponed announces
+        QSet<QString> backedOffTrackerURLs;
+        for (const TrackerEntry &trackerEntry : asConst(torrent->trackers()))
+        {
+            if (m_trackerHostStatistics.backoffRemaining(trackerEntry.url) > 0)
+                backedOffTrackerURLs.insert(trackerEntry.url);
+        }
+
+        torrent->forceReannounceExcept(backedOffTrackerURLs);
+    });
+
     m_recentErroredTorrentsTimer->setSingleShot(true);
     m_recentErroredTorrentsTimer->setInterval(1s);
     connect(m_recentErroredTorrentsTimer, &QTimer::timeout
@@ -553,6 +579,16 @@ SessionImpl::SessionImpl(QObject *parent)
     m_seedingLimitTimer->setInterval(10s);
     connect(m_seedingLimitTimer, &QTimer::timeout, this, &SessionImpl::processShareLimits);
 
+    m_dynamicQueueingTimer->setInterval(std::chrono::minutes(dynamicQueueingInterval()));
+    connect(m_dynamicQueueingTimer, &QTimer::timeout, this, &SessionImpl::rotateSeedingTorrents);
+    if (isDynamicQueueingEnabled())
+        m_dynamicQueueingTimer->start();
+
+    m_uploadAllocationTimer->setInterval(5s);
+    connect(m_uploadAllocationTimer, &QTimer::timeout, this, &SessionImpl::allocateUploadBandwidth);
+    if (isUploadAllocationEnabled())
+        m_uploadAllocationTimer->start();
+
     initializeNativeSession();
     configureComponents();
 
@@ -566,8 +602,8 @@ SessionImpl::SessionImpl(QObject *parent)
         m_categories = expandCategories(m_categories);
     }
 
-    const QStringList storedTags = m_storedTags.get();
-    m_tags = {storedTags.cbegin(), storedTags.cend()};
+    for (const QString &tag : asConst(m_storedTags.get()))
+        m_tags.insert(tag);
 
     updateSeedingLimitTimer();
     populateAdditionalTrackers();
@@ -595,6 +631,13 @@ SessionImpl::SessionImpl(QObject *parent)
 
     initMetrics();
     loadStatistics();
+    loadTransferHistory();
+    m_transferHistorySaveTimer->setInterval(5min);
+    connect(m_transferHistorySaveTimer, &QTimer::timeout, this, &SessionImpl::saveTransferHistory);
+    m_transferHistorySaveTimer->start();
+    m_torrentsTransferHistoryTimer->setInterval(5min);
+    connect(m_torrentsTransferHistoryTimer, &QTimer::timeout, this, &SessionImpl::recordTorrentsTransferHistory);
+    m_torrentsTransferHistoryTimer->start();
 
     // initialize PortForwarder instance
     new PortForwarderImpl(this);
@@ -621,6 +664,7 @@ SessionImpl::~SessionImpl()
     saveResumeData();
 
     saveStatistics();
+    saveTransferHistory();
 
     // We must delete FilterParserThread
     // before we delete lt::session
@@ -946,10 +990,20 @@ void SessionImpl::setUseCategoryPathsInManualMode(const bool value)
 }
 
 QSet<QString> SessionImpl::tags() const
+{
+    return m_tags.tags();
+}
+
+const TagIndex &SessionImpl::tagIndex() const
 {
     return m_tags;
 }
 
+StringPool &SessionImpl::stringPool()
+{
+    return m_stringPool;
+}
+
 bool SessionImpl::hasTag(const QString &tag) const
 {
     return m_tags.contains(tag);
@@ -961,22 +1015,23 @@ bool SessionImpl::addTag(const QString &tag)
         return false;
 
     m_tags.insert(tag);
-    m_storedTags = m_tags.values();
+    m_storedTags = m_tags.tagList();
     emit tagAdded(tag);
     return true;
 }
 
 bool SessionImpl::removeTag(const QString &tag)
 {
-    if (m_tags.remove(tag))
-    {
-        for (TorrentImpl *const torrent : asConst(m_torrents))
-            torrent->removeTag(tag);
-        m_storedTags = m_tags.values();
-        emit tagRemoved(tag);
-        return true;
-    }
-    return false;
+    if (!hasTag(tag))
+        return false;
+
+    // Torrents refer to the tag by its index, so it must outlive their membership
+    for (TorrentImpl *const torrent : asConst(m_torrents))
+        torrent->removeTag(tag);
+    m_tags.remove(tag);
+    m_storedTags = m_tags.tagList();
+    emit tagRemoved(tag);
+    return true;
 }
 
 bool SessionImpl::isAutoTMMDisabledByDefault() const
@@ -1106,6 +1161,10 @@ void SessionImpl::applyBandwidthLimits()
     settingsPack.set_int(lt::settings_pack::download_rate_limit, downloadSpeedLimit());
     settingsPack.set_int(lt::settings_pack::upload_rate_limit, uploadSpeedLimit());
     m_nativeSession->apply_settings(std::move(settingsPack));
+
+    // share the new upload limit right away instead of waiting for the next allocation
+    if (isUploadAllocationEnabled())
+        allocateUploadBandwidth();
 }
 
 void SessionImpl::configure()
@@ -1113,6 +1172,10 @@ void SessionImpl::configure()
     m_nativeSession->apply_settings(loadLTSettings());
     configureComponents();
 
+    // the upload limit may have been changed
+    if (isUploadAllocationEnabled())
+        allocateUploadBandwidth();
+
     m_deferredConfigureScheduled = false;
 }
 
@@ -1421,7 +1484,10 @@ void SessionImpl::endStartup(ResumeSessionContext *context)
     if (m_resumeDataStorage != context->startupStorage)
     {
         if (isQueueingSystemEnabled())
+        {
+            m_torrentsQueue.markAllChanged();
             saveTorrentsQueue();
+        }
 
         const Path dbPath = context->startupStorage->path();
         context->startupStorage->deleteLater();
@@ -1435,6 +1501,8 @@ void SessionImpl::endStartup(ResumeSessionContext *context)
         }
     }
 
+    // Queue positions of the loaded torrents are already stored
+    m_torrentsQueue.resetChanged();
     context->deleteLater();
 
     m_nativeSession->resume();
@@ -2155,6 +2223,80 @@ void SessionImpl::processShareLimits()
     }
 }
 
+void SessionImpl::rotateSeedingTorrents()
+{
+    const QVector<Torrent *> torrents(m_torrents.cbegin(), m_torrents.cend());
+
+    // Giving errored torrents back to auto management would restart them,
+    // they leave the demand queue when they are resumed by the user
+    const auto isErrored = [](const TorrentImpl *torrent)
+    {
+        return (torrent->isErrored() || torrent->hasMissingFiles());
+    };
+
+    if (!isDynamicQueueingEnabled() || !isQueueingSystemEnabled() || (maxActiveUploads() < 0))
+    {
+        for (TorrentImpl *const torrent : asConst(m_torrents))
+        {
+            if (!isErrored(torrent))
+                torrent->setQueuedByDemand(false);
+        }
+        return;
+    }
+
+    for (TorrentImpl *const torrent : asConst(m_torrents))
+    {
+        if (!DemandQueueScheduler::isCandidate(torrent) && !isErrored(torrent))
+            torrent->setQueuedByDemand(false);
+    }
+
+    QVector<TorrentImpl *> queuedTorrents;
+    int rotatedCount = 0;
+    for (const DemandQueueEntry &entry : asConst(m_demandQueueScheduler.rank(torrents, maxActiveUploads())))
+    {
+        TorrentImpl *const torrent = m_torrents.value(entry.torrentID);
+        if (entry.shouldBeActive != entry.isActive)
+            ++rotatedCount;
+
+        torrent->setQueuedByDemand(!entry.shouldBeActive);
+        if (!entry.shouldBeActive)
+            queuedTorrents.append(torrent);
+    }
+
+    // Torrents taken out of auto management aren't scraped by libtorrent,
+    // so refresh their swarm counts in batches to let them compete for the slots
+    const int scrapeBatchSize = 100;
+    if (m_demandQueueScrapeOffset >= queuedTorrents.size())
+        m_demandQueueScrapeOffset = 0;
+    const int scrapeEnd = std::min<int>((m_demandQueueScrapeOffset + scrapeBatchSize), queuedTorrents.size());
+    for (int i = m_demandQueueScrapeOffset; i < scrapeEnd; ++i)
+        queuedTorrents[i]->scrapeTrackers();
+    m_demandQueueScrapeOffset = scrapeEnd;
+
+    m_demandQueueScheduler.commit(torrents);
+
+    if (rotatedCount > 0)
+        LogMsg(tr("Rotated seeding torrents by demand. Changed torrents: %1").arg(rotatedCount));
+}
+
+void SessionImpl::allocateUploadBandwidth()
+{
+    // Allocation only makes sense when there is a limited upload bandwidth to share
+    const int budget = uploadSpeedLimit();
+    if (!isUploadAllocationEnabled() || (budget <= 0))
+    {
+        m_uploadAllocator.reset();
+        for (TorrentImpl *const torrent : asConst(m_torrents))
+            torrent->setAllocatedUploadLimit(0);
+        return;
+    }
+
+    const QHash<TorrentID, int> allocations = m_uploadAllocator.allocate(
+            QVector<Torrent *>(m_torrents.cbegin(), m_torrents.cend()), budget);
+    for (TorrentImpl *const torrent : asConst(m_torrents))
+        torrent->setAllocatedUploadLimit(allocations.value(torrent->id()));
+}
+
 // Add to BitTorrent session the downloaded torrent file
 void SessionImpl::handleDownloadFinished(const Net::DownloadResult &result)
 {
@@ -2304,6 +2446,14 @@ bool SessionImpl::deleteTorrent(const TorrentID &id, const DeleteOption deleteOp
     // Remove it from torrent resume directory
     m_resumeDataStorage->remove(torrent->id());
 
+    m_updatedTrackerEntries.remove(torrent);
+    m_transferringTorrents.remove(torrent);
+    m_announceScheduler->cancel(torrent->id());
+    m_trackerHostStatistics.removeTorrent(torrent->id());
+    m_torrentsQueue.remove(torrent->id());
+    m_demandQueueScheduler.removeTorrent(torrent->id());
+    m_pieceAvailabilityStats.remove(torrent->id());
+    m_pieceAvailabilityStatsRequests.remove(torrent->id());
     delete torrent;
     return true;
 }
@@ -2981,13 +3131,20 @@ void SessionImpl::generateResumeData()
             m_needSaveResumeDataTorrents.remove(torrent->id());
         }
     }
+
+    m_stringPool.squeeze();
 }
 
 // Called on exit
 void SessionImpl::saveResumeData()
 {
     for (const TorrentImpl *torrent : asConst(m_torrents))
-        torrent->nativeHandle().save_resume_data(lt::torrent_handle::only_if_modified);
+    {
+        // libtorrent isn't aware of the data stored by qBittorrent only, such as the transfer history
+        const lt::resume_data_flags_t flags = torrent->needSaveResumeData()
+                ? lt::resume_data_flags_t {} : lt::torrent_handle::only_if_modified;
+        torrent->nativeHandle().save_resume_data(flags);
+    }
     m_numResumeData += m_torrents.size();
 
     // clear queued storage move jobs except the current ongoing one
@@ -3039,19 +3196,18 @@ void SessionImpl::saveResumeData()
 
 void SessionImpl::saveTorrentsQueue()
 {
-    QVector<TorrentID> queue;
-    for (const TorrentImpl *torrent : asConst(m_torrents))
-    {
-        if (const int queuePos = torrent->queuePosition(); queuePos >= 0)
-        {
-            if (queuePos >= queue.size())
-                queue.resize(queuePos + 1);
-            queue[queuePos] = torrent->id();
-        }
-    }
-
-    m_resumeDataStorage->storeQueue(queue);
     m_needSaveTorrentsQueue = false;
+    if (!m_torrentsQueue.isChanged())
+        return;
+
+    const QVector<TorrentID> queue = m_torrentsQueue.toVector();
+    const auto [changedFrom, changedTo] = m_torrentsQueue.changedRange();
+    if ((changedFrom == 0) && (changedTo >= (queue.size() - 1)))
+        m_resumeDataStorage->storeQueue(queue);
+    else
+        m_resumeDataStorage->updateQueue(queue, changedFrom, changedTo);
+
+    m_torrentsQueue.resetChanged();
 }
 
 void SessionImpl::removeTorrentsQueue()
@@ -4157,9 +4313,15 @@ void SessionImpl::setQueueingSystemEnabled(const bool enabled)
         configureDeferred();
 
         if (enabled)
+        {
+            m_torrentsQueue.markAllChanged();
             m_torrentsQueueChanged = true;
+        }
         else
+        {
             removeTorrentsQueue();
+            rotateSeedingTorrents();
+        }
     }
 }
 
@@ -4264,6 +4426,137 @@ void SessionImpl::setSlowTorrentsInactivityTimer(const int timeInSeconds)
     configureDeferred();
 }
 
+bool SessionImpl::isDynamicQueueingEnabled() const
+{
+    return m_isDynamicQueueingEnabled;
+}
+
+void SessionImpl::setDynamicQueueingEnabled(const bool enabled)
+{
+    if (enabled == m_isDynamicQueueingEnabled)
+        return;
+
+    m_isDynamicQueueingEnabled = enabled;
+    if (enabled)
+    {
+        m_demandQueueScheduler.commit(QVector<Torrent *>(m_torrents.cbegin(), m_torrents.cend()));
+        m_dynamicQueueingTimer->start();
+    }
+    else
+    {
+        m_dynamicQueueingTimer->stop();
+        // give seeding slots back to libtorrent
+        rotateSeedingTorrents();
+    }
+}
+
+int SessionImpl::dynamicQueueingInterval() const
+{
+    return m_dynamicQueueingInterval;
+}
+
+void SessionImpl::setDynamicQueueingInterval(const int minutes)
+{
+    if (minutes == m_dynamicQueueingInterval)
+        return;
+
+    m_dynamicQueueingInterval = minutes;
+    m_dynamicQueueingTimer->setInterval(std::chrono::minutes(m_dynamicQueueingInterval));
+}
+
+QVector<DemandQueueEntry> SessionImpl::dynamicQueueingReport() const
+{
+    return m_demandQueueScheduler.rank(QVector<Torrent *>(m_torrents.cbegin(), m_torrents.cend()), maxActiveUploads());
+}
+
+bool SessionImpl::isUploadAllocationEnabled() const
+{
+    return m_isUploadAllocationEnabled;
+}
+
+void SessionImpl::setUploadAllocationEnabled(const bool enabled)
+{
+    if (enabled == m_isUploadAllocationEnabled)
+        return;
+
+    m_isUploadAllocationEnabled = enabled;
+    if (enabled)
+    {
+        m_uploadAllocationTimer->start();
+    }
+    else
+    {
+        m_uploadAllocationTimer->stop();
+        // give the bandwidth back to libtorrent
+        allocateUploadBandwidth();
+    }
+}
+
+PieceAvailabilityStats SessionImpl::pieceAvailabilityStats(const TorrentID &id)
+{
+    const TorrentImpl *torrent = m_torrents.value(id);
+    if (!torrent)
+        return {};
+
+    refreshPieceAvailabilityStats(torrent);
+    return m_pieceAvailabilityStats.value(id);
+}
+
+QVector<PieceAvailabilityStats> SessionImpl::rareDataRanking()
+{
+    QVector<PieceAvailabilityStats> ranking;
+    for (const TorrentImpl *torrent : asConst(m_torrents))
+    {
+        refreshPieceAvailabilityStats(torrent);
+
+        const auto statsIter = m_pieceAvailabilityStats.constFind(torrent->id());
+        if ((statsIter != m_pieceAvailabilityStats.cend()) && (statsIter->rareHeldPieces > 0))
+            ranking.append(statsIter.value());
+    }
+
+    std::sort(ranking.begin(), ranking.end()
+            , [](const PieceAvailabilityStats &left, const PieceAvailabilityStats &right)
+    {
+        return (left.rareDataScore() > right.rareDataScore());
+    });
+
+    return ranking;
+}
+
+void SessionImpl::refreshPieceAvailabilityStats(const TorrentImpl *torrent)
+{
+    // Statistics are computed from peer bitfields which change slowly, so they are refreshed rarely
+    const qint64 statsLifetime = 60;
+    // Limit the number of jobs queued in the worker thread at once
+    const int maxRequests = 100;
+
+    const TorrentID id = torrent->id();
+    // Idle torrents have no peers to collect the availability from
+    if (!torrent->hasMetadata() || torrent->isPaused() || torrent->isQueued() || (torrent->peersCount() == 0))
+    {
+        m_pieceAvailabilityStats.remove(id);
+        return;
+    }
+
+    if (m_pieceAvailabilityStatsRequests.contains(id) || (m_pieceAvailabilityStatsRequests.size() >= maxRequests))
+        return;
+
+    const qint64 currentTime = QDateTime::currentSecsSinceEpoch();
+    const auto statsIter = m_pieceAvailabilityStats.constFind(id);
+    if ((statsIter != m_pieceAvailabilityStats.cend()) && ((currentTime - statsIter->updateTime) < statsLifetime))
+        return;
+
+    m_pieceAvailabilityStatsRequests.insert(id);
+    torrent->fetchPieceAvailabilityStats([this, id](PieceAvailabilityStats stats)
+    {
+        m_pieceAvailabilityStatsRequests.remove(id);
+
+        stats.torrentID = id;
+        stats.updateTime = QDateTime::currentSecsSinceEpoch();
+        m_pieceAvailabilityStats.insert(id, stats);
+    });
+}
+
 int SessionImpl::outgoingPortsMin() const
 {
     return m_outgoingPortsMin;
@@ -4393,14 +4686,63 @@ void SessionImpl::reannounceToAllTrackers() const
 {
     for (const TorrentImpl *torrent : asConst(m_torrents))
     {
-        try
+        // libtorrent doesn't announce paused and queued torrents
+        if (torrent->isPaused() || torrent->isQueued())
+            continue;
+
+        QStringList trackerHosts;
+        for (const TrackerEntry &trackerEntry : asConst(torrent->trackers()))
         {
-            torrent->nativeHandle().force_reannounce(0, -1, lt::torrent_handle::ignore_min_interval);
+            if (m_trackerHostStatistics.backoffRemaining(trackerEntry.url) == 0)
+                trackerHosts.append(m_trackerHostStatistics.trackerHost(trackerEntry.url));
         }
-        catch (const std::exception &) {}
+        if (trackerHosts.isEmpty())
+            continue;
+
+        // torrents which have someone to upload to are announced first
+        const bool isPriority = (torrent->leechsCount() > 0);
+        m_announceScheduler->schedule(torrent->id(), trackerHosts, isPriority);
     }
 }
 
+int SessionImpl::announceJitterWindow() const
+{
+    return m_announceJitterWindow;
+}
+
+void SessionImpl::setAnnounceJitterWindow(const int value)
+{
+    if (value == m_announceJitterWindow)
+        return;
+
+    m_announceJitterWindow = value;
+    m_announceScheduler->setWindow(value);
+}
+
+int SessionImpl::maxAnnouncesPerTrackerHost() const
+{
+    return m_maxAnnouncesPerTrackerHost;
+}
+
+void SessionImpl::setMaxAnnouncesPerTrackerHost(const int value)
+{
+    if (value == m_maxAnnouncesPerTrackerHost)
+        return;
+
+    m_maxAnnouncesPerTrackerHost = value;
+    m_announceScheduler->setMaxAnnouncesPerHost(value);
+}
+
+QVector<ScheduledAnnounce> SessionImpl::scheduledAnnounces() const
+{
+    return m_announceScheduler->scheduledAnnounces();
+}
+
+QVector<TrackerHostStatus> SessionImpl::trackerHostStatuses() const
+{
+    return m_trackerHostStatistics.statuses();
+}
+
 int SessionImpl::stopTrackerTimeout() const
 {
     return m_stopTrackerTimeout;
@@ -5046,11 +5388,25 @@ const SessionStatus &SessionImpl::status() const
     return m_status;
 }
 
+const TransferHistory &SessionImpl::transferHistory() const
+{
+    return m_transferHistory;
+}
+
 const CacheStatus &SessionImpl::cacheStatus() const
 {
     return m_cacheStatus;
 }
 
+MemoryStatus SessionImpl::memoryStatus() const
+{
+    MemoryStatus memoryStatus;
+    for (const TorrentImpl *torrent : asConst(m_torrents))
+        torrent->collectMemoryStatus(memoryStatus);
+    memoryStatus.stringPool = m_stringPool.memoryUsage();
+    return memoryStatus;
+}
+
 void SessionImpl::enqueueRefresh()
 {
     Q_ASSERT(!m_refreshEnqueued);
@@ -5241,6 +5597,7 @@ void SessionImpl::handleAlert(const lt::alert *a)
         case lt::tracker_error_alert::alert_type:
         case lt::tracker_reply_alert::alert_type:
         case lt::tracker_warning_alert::alert_type:
+        case lt::scrape_reply_alert::alert_type:
             handleTrackerAlert(static_cast<const lt::tracker_alert *>(a));
             break;
         case lt::file_error_alert::alert_type:
@@ -5338,6 +5695,7 @@ TorrentImpl *SessionImpl::createTorrent(const lt::torrent_handle &nativeHandle,
 {
     auto *const torrent = new TorrentImpl(this, m_nativeSession, nativeHandle, params);
     m_torrents.insert(torrent->id(), torrent);
+    m_torrentsQueue.setPosition(torrent->id(), torrent->queuePosition());
     if (const InfoHash infoHash = torrent->infoHash(); infoHash.isHybrid())
         m_hybridTorrentsByAltID.insert(TorrentID::fromSHA1Hash(infoHash.v1()), torrent);
 
@@ -5676,6 +6034,8 @@ void SessionImpl::handleSessionStatsAlert(const lt::session_stats_alert *p)
     if (m_statisticsLastUpdateTimer.hasExpired(STATISTICS_SAVE_INTERVAL))
         saveStatistics();
 
+    recordTransferHistory();
+
     m_cacheStatus.totalUsedBuffers = stats[m_metricIndices.disk.diskBlocksInUse];
     m_cacheStatus.jobQueueLength = stats[m_metricIndices.disk.queuedDiskJobs];
 
@@ -5762,8 +6122,15 @@ void SessionImpl::handleStateUpdateAlert(const lt::state_update_alert *p)
         if (!torrent)
             continue;
 
+        m_torrentsQueue.setPosition(id, static_cast<int>(status.queue_position));
         torrent->handleStateUpdate(status);
         updatedTorrents.push_back(torrent);
+
+        // libtorrent reports the torrents whose rates dropped to zero too
+        if ((torrent->uploadPayloadRate() > 0) || (torrent->downloadPayloadRate() > 0))
+            m_transferringTorrents.insert(torrent);
+        else
+            m_transferringTorrents.remove(torrent);
     }
 
     if (!updatedTorrents.isEmpty())
@@ -5797,13 +6164,40 @@ void SessionImpl::handleTrackerAlert(const lt::tracker_alert *a)
     if (!torrent)
         return;
 
-    QMap<TrackerEntry::Endpoint, int> &updateInfo = m_updatedTrackerEntries[torrent->nativeHandle()][std::string(a->tracker_url())];
+    const TrackerEntry trackerEntry = torrent->updateTrackerEntry(a);
+    if (trackerEntry.url.isEmpty())
+        return;
 
-    if (a->type() == lt::tracker_reply_alert::alert_type)
+    m_updatedTrackerEntries[torrent].insert(trackerEntry.url, trackerEntry);
+
+    switch (a->type())
     {
-        const int numPeers = static_cast<const lt::tracker_reply_alert *>(a)->num_peers;
-        updateInfo.insert(a->local_endpoint, numPeers);
+    case lt::tracker_announce_alert::alert_type:
+        m_trackerHostStatistics.handleAnnounceStarted(torrent->id(), trackerEntry.url);
+        m_announceScheduler->handleAnnounceStarted(torrent->id(), m_trackerHostStatistics.trackerHost(trackerEntry.url));
+        break;
+    case lt::tracker_reply_alert::alert_type:
+        m_trackerHostStatistics.handleAnnounceReplied(torrent->id(), trackerEntry.url);
+        m_announceScheduler->handleAnnounceFinished(torrent->id(), m_trackerHostStatistics.trackerHost(trackerEntry.url));
+        break;
+    case lt::tracker_error_alert::alert_type:
+        {
+            const auto *errorAlert = static_cast<const lt::tracker_error_alert *>(a);
+            // Failure reason is sent by the tracker itself so the host is alive
+            if (std::strlen(errorAlert->failure_reason()) > 0)
+                m_trackerHostStatistics.handleAnnounceReplied(torrent->id(), trackerEntry.url);
+            else
+                handleTrackerHostFailure(torrent, trackerEntry.url, QString::fromLocal8Bit(errorAlert->error.message().c_str()));
+            m_announceScheduler->handleAnnounceFinished(torrent->id(), m_trackerHostStatistics.trackerHost(trackerEntry.url));
+            emit trackerError(torrent, trackerEntry.url);
+        }
+        break;
+    default:
+        break;
     }
+
+    if (a->type() == lt::tracker_reply_alert::alert_type)
+        m_trackerScrapeDataRequests.insert(torrent->nativeHandle());
 }
 
 #ifdef QBT_USES_LIBTORRENT2
@@ -5854,52 +6248,74 @@ void SessionImpl::handleTorrentConflictAlert(const lt::torrent_conflict_alert *a
 }
 #endif
 
-void SessionImpl::processTrackerStatuses()
+void SessionImpl::handleTrackerHostFailure(TorrentImpl *torrent, const QString &trackerURL, const QString &message)
 {
-    if (m_updatedTrackerEntries.isEmpty())
+    if (!m_trackerHostStatistics.handleAnnounceFailed(torrent->id(), trackerURL, message))
+    {
+        // Announce was sent before the host has been backed off
+        if (const int backoff = m_trackerHostStatistics.backoffRemaining(trackerURL); backoff > 0)
+            torrent->postponeAnnounces({trackerURL}, backoff);
         return;
+    }
 
-    for (auto it = m_updatedTrackerEntries.cbegin(); it != m_updatedTrackerEntries.cend(); ++it)
+    const QString host = m_trackerHostStatistics.trackerHost(trackerURL);
+    const int backoff = m_trackerHostStatistics.backoffRemaining(trackerURL);
+    const QSet<QString> trackerURLs = m_trackerHostStatistics.trackerURLs(host);
+    LogMsg(tr("Tracker host is not responding, postponing its announces. Host: \"%1\". Delay: %2 seconds. Error: \"%3\"")
+        .arg(host, QString::number(backoff), message), Log::WARNING);
+
+    for (TorrentImpl *const hostTorrent : asConst(m_torrents))
+        hostTorrent->postponeAnnounces(trackerURLs, backoff);
+}
+
+void SessionImpl::processTrackerStatuses()
+{
+    if (!m_trackerScrapeDataRequests.isEmpty())
     {
-        invokeAsync([this, torrentHandle = it.key(), updatedTrackers = it.value()]() mutable
+        // Fetch swarm counts for all the torrents at once,
+        // they will be reported along with the next batch of updates
+        invokeAsync([this, torrentHandles = std::exchange(m_trackerScrapeDataRequests, {})]
         {
-            try
+            std::vector<std::pair<lt::torrent_handle, std::vector<lt::announce_entry>>> nativeTrackers;
+            nativeTrackers.reserve(torrentHandles.size());
+            for (const lt::torrent_handle &torrentHandle : torrentHandles)
+            {
+                try
+                {
+                    nativeTrackers.emplace_back(torrentHandle, torrentHandle.trackers());
+                }
+                catch (const std::exception &)
+                {
+                }
+            }
+
+            invoke([this, nativeTrackers = std::move(nativeTrackers)]
             {
-                std::vector<lt::announce_entry> nativeTrackers = torrentHandle.trackers();
-                invoke([this, torrentHandle, nativeTrackers = std::move(nativeTrackers)
-                        , updatedTrackers = std::move(updatedTrackers)]
+                for (const auto &[torrentHandle, announceEntries] : nativeTrackers)
                 {
                     TorrentImpl *torrent = m_torrents.value(torrentHandle.info_hash());
                     if (!torrent)
-                        return;
+                        continue;
 
-                    QHash<QString, TrackerEntry> updatedTrackerEntries;
-                    updatedTrackerEntries.reserve(updatedTrackers.size());
-                    for (const lt::announce_entry &announceEntry : nativeTrackers)
+                    QHash<QString, TrackerEntry> &updatedTrackerEntries = m_updatedTrackerEntries[torrent];
+                    for (const lt::announce_entry &announceEntry : announceEntries)
                     {
-                        const auto updatedTrackersIter = updatedTrackers.find(announceEntry.url);
-                        if (updatedTrackersIter == updatedTrackers.end())
-                            continue;
-
-                        const QMap<TrackerEntry::Endpoint, int> &updateInfo = updatedTrackersIter.value();
-                        TrackerEntry trackerEntry = torrent->updateTrackerEntry(announceEntry, updateInfo);
-#if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
-                        updatedTrackerEntries[trackerEntry.url] = std::move(trackerEntry);
-#else
-                        updatedTrackerEntries.emplace(trackerEntry.url, std::move(trackerEntry));
-#endif
+                        TrackerEntry trackerEntry = torrent->updateTrackerEntryScrapeData(announceEntry);
+                        if (!trackerEntry.url.isEmpty())
+                            updatedTrackerEntries.insert(trackerEntry.url, std::move(trackerEntry));
                     }
 
-                    emit trackerEntriesUpdated(torrent, updatedTrackerEntries);
-                });
-            }
-            catch (const std::exception &)
-            {
-            }
+                    if (updatedTrackerEntries.isEmpty())
+                        m_updatedTrackerEntries.remove(torrent);
+                }
+            });
         });
     }
 
-    m_updatedTrackerEntries.clear();
+    if (m_updatedTrackerEntries.isEmpty())
+        return;
+
+    emit trackerEntriesUpdated(std::exchange(m_updatedTrackerEntries, {}));
 }
 
 void SessionImpl::saveStatistics() const
@@ -5925,3 +6341,65 @@ void SessionImpl::loadStatistics()
     m_previouslyDownloaded = value[u"AlltimeDL"_qs].toLongLong();
     m_previouslyUploaded = value[u"AlltimeUL"_qs].toLongLong();
 }
+
+void SessionImpl::recordTransferHistory()
+{
+    const qint64 currentTime = QDateTime::currentSecsSinceEpoch();
+    m_transferHistory.record(currentTime, m_status);
+
+    QHash<QString, TransferHistory::CategoryRates> categoryRates;
+    categoryRates.reserve(m_categories.size());
+    for (auto iter = m_categories.cbegin(); iter != m_categories.cend(); ++iter)
+        categoryRates.insert(iter.key(), {});
+
+    // idle torrents don't contribute to the rates
+    for (const TorrentImpl *torrent : asConst(m_transferringTorrents))
+    {
+        const auto ratesIter = categoryRates.find(torrent->category());
+        if (ratesIter == categoryRates.end())
+            continue;
+
+        (*ratesIter)[TransferHistory::CategoryPayloadUpload] += torrent->uploadPayloadRate();
+        (*ratesIter)[TransferHistory::CategoryPayloadDownload] += torrent->downloadPayloadRate();
+    }
+
+    m_transferHistory.recordCategories(currentTime, categoryRates);
+}
+
+void SessionImpl::recordTorrentsTransferHistory()
+{
+    const qint64 currentTime = QDateTime::currentSecsSinceEpoch();
+    for (TorrentImpl *const torrent : asConst(m_torrents))
+        torrent->recordTransferHistory(currentTime);
+}
+
+void SessionImpl::saveTransferHistory() const
+{
+    const Path path = specialFolderLocation(SpecialFolder::Data) / TRANSFER_HISTORY_FILE_NAME;
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(path, m_transferHistory.serialize());
+    if (!result)
+    {
+        LogMsg(tr("Failed to save transfer history. File: \"%1\". Error: \"%2\"")
+               .arg(path.toString(), result.error()), Log::WARNING);
+    }
+}
+
+void SessionImpl::loadTransferHistory()
+{
+    QFile file {(specialFolderLocation(SpecialFolder::Data) / TRANSFER_HISTORY_FILE_NAME).data()};
+    if (!file.exists())
+        return;
+
+    if (!file.open(QFile::ReadOnly))
+    {
+        LogMsg(tr("Failed to load transfer history. File: \"%1\". Error: \"%2\"")
+               .arg(file.fileName(), file.errorString()), Log::WARNING);
+        return;
+    }
+
+    if (!m_transferHistory.load(file.readAll()))
+    {
+        LogMsg(tr("Failed to load transfer history. File: \"%1\". Error: \"Invalid data format\"")
+               .arg(file.fileName()), Log::WARNING);
+    }
+}
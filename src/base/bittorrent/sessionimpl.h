@@ -46,15 +46,23 @@
 
 #include "base/path.h"
 #include "base/settingvalue.h"
+#include "base/stringpool.h"
+#include "base/tagindex.h"
 #include "base/types.h"
 #include "base/utils/thread.h"
 #include "addtorrentparams.h"
 #include "cachestatus.h"
 #include "categoryoptions.h"
+#include "pieceavailabilitystats.h"
+#include "demandqueuescheduler.h"
 #include "session.h"
 #include "sessionstatus.h"
 #include "torrentinfo.h"
+#include "torrentsqueue.h"
 #include "trackerentry.h"
+#include "trackerhoststatistics.h"
+#include "transferhistory.h"
+#include "uploadallocator.h"
 
 #if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
 class QNetworkConfiguration;
@@ -78,6 +86,7 @@ namespace Net
 
 namespace BitTorrent
 {
+    class AnnounceScheduler;
     class InfoHash;
     class MagnetUri;
     class ResumeDataStorage;
@@ -163,6 +172,7 @@ namespace BitTorrent
         bool hasTag(const QString &tag) const override;
         bool addTag(const QString &tag) override;
         bool removeTag(const QString &tag) override;
+        const TagIndex &tagIndex() const override;
 
         bool isAutoTMMDisabledByDefault() const override;
         void setAutoTMMDisabledByDefault(bool value) override;
@@ -311,6 +321,15 @@ namespace BitTorrent
         void setUploadRateForSlowTorrents(int rateInKibiBytes) override;
         int slowTorrentsInactivityTimer() const override;
         void setSlowTorrentsInactivityTimer(int timeInSeconds) override;
+        bool isDynamicQueueingEnabled() const override;
+        void setDynamicQueueingEnabled(bool enabled) override;
+        int dynamicQueueingInterval() const override;
+        void setDynamicQueueingInterval(int minutes) override;
+        QVector<DemandQueueEntry> dynamicQueueingReport() const override;
+        bool isUploadAllocationEnabled() const override;
+        void setUploadAllocationEnabled(bool enabled) override;
+        PieceAvailabilityStats pieceAvailabilityStats(const TorrentID &id) override;
+        QVector<PieceAvailabilityStats> rareDataRanking() override;
         int outgoingPortsMin() const override;
         void setOutgoingPortsMin(int min) override;
         int outgoingPortsMax() const override;
@@ -330,6 +349,12 @@ namespace BitTorrent
         bool isReannounceWhenAddressChangedEnabled() const override;
         void setReannounceWhenAddressChangedEnabled(bool enabled) override;
         void reannounceToAllTrackers() const override;
+        int announceJitterWindow() const override;
+        void setAnnounceJitterWindow(int value) override;
+        int maxAnnouncesPerTrackerHost() const override;
+        void setMaxAnnouncesPerTrackerHost(int value) override;
+        QVector<ScheduledAnnounce> scheduledAnnounces() const override;
+        QVector<TrackerHostStatus> trackerHostStatuses() const override;
         int stopTrackerTimeout() const override;
         void setStopTrackerTimeout(int value) override;
         int maxConnections() const override;
@@ -382,6 +407,8 @@ namespace BitTorrent
         qsizetype torrentsCount() const override;
         const SessionStatus &status() const override;
         const CacheStatus &cacheStatus() const override;
+        MemoryStatus memoryStatus() const override;
+        const TransferHistory &transferHistory() const override;
         bool isListening() const override;
 
         MaxRatioAction maxRatioAction() const override;
@@ -404,6 +431,7 @@ namespace BitTorrent
         void bottomTorrentsQueuePos(const QVector<TorrentID> &ids) override;
 
         // Torrent interface
+        StringPool &stringPool();
         void handleTorrentNeedSaveResumeData(const TorrentImpl *torrent);
         void handleTorrentSaveResumeDataRequested(const TorrentImpl *torrent);
         void handleTorrentSaveResumeDataFailed(const TorrentImpl *torrent);
@@ -450,6 +478,9 @@ namespace BitTorrent
         void readAlerts();
         void enqueueRefresh();
         void processShareLimits();
+        void rotateSeedingTorrents();
+        void allocateUploadBandwidth();
+        void recordTorrentsTransferHistory();
         void generateResumeData();
         void handleIPFilterParsed(int ruleCount);
         void handleIPFilterError();
@@ -538,11 +569,13 @@ namespace BitTorrent
         void handleStorageMovedFailedAlert(const lt::storage_moved_failed_alert *p);
         void handleSocks5Alert(const lt::socks5_alert *p) const;
         void handleTrackerAlert(const lt::tracker_alert *a);
+        void handleTrackerHostFailure(TorrentImpl *torrent, const QString &trackerURL, const QString &message);
 #ifdef QBT_USES_LIBTORRENT2
         void handleTorrentConflictAlert(const lt::torrent_conflict_alert *a);
 #endif
 
         TorrentImpl *createTorrent(const lt::torrent_handle &nativeHandle, const LoadTorrentParams &params);
+        void refreshPieceAvailabilityStats(const TorrentImpl *torrent);
 
         void saveResumeData();
         void saveTorrentsQueue();
@@ -559,6 +592,9 @@ namespace BitTorrent
 
         void saveStatistics() const;
         void loadStatistics();
+        void recordTransferHistory();
+        void saveTransferHistory() const;
+        void loadTransferHistory();
 
         // BitTorrent
         lt::session *m_nativeSession = nullptr;
@@ -603,6 +639,9 @@ namespace BitTorrent
         CachedSettingValue<int> m_downloadRateForSlowTorrents;
         CachedSettingValue<int> m_uploadRateForSlowTorrents;
         CachedSettingValue<int> m_slowTorrentsInactivityTimer;
+        CachedSettingValue<bool> m_isDynamicQueueingEnabled;
+        CachedSettingValue<int> m_dynamicQueueingInterval;
+        CachedSettingValue<bool> m_isUploadAllocationEnabled;
         CachedSettingValue<int> m_outgoingPortsMin;
         CachedSettingValue<int> m_outgoingPortsMax;
         CachedSettingValue<int> m_UPnPLeaseDuration;
@@ -613,6 +652,8 @@ namespace BitTorrent
         CachedSettingValue<int> m_maxConcurrentHTTPAnnounces;
         CachedSettingValue<bool> m_isReannounceWhenAddressChangedEnabled;
         CachedSettingValue<int> m_stopTrackerTimeout;
+        CachedSettingValue<int> m_announceJitterWindow;
+        CachedSettingValue<int> m_maxAnnouncesPerTrackerHost;
         CachedSettingValue<int> m_maxConnections;
         CachedSettingValue<int> m_maxUploads;
         CachedSettingValue<int> m_maxConnectionsPerTorrent;
@@ -692,12 +733,20 @@ namespace BitTorrent
         mutable bool m_isStatisticsDirty = false;
         qint64 m_previouslyUploaded = 0;
         qint64 m_previouslyDownloaded = 0;
+        TransferHistory m_transferHistory;
+        // torrents having non-zero payload rates as of their last state update
+        QSet<const TorrentImpl *> m_transferringTorrents;
 
         bool m_torrentsQueueChanged = false;
         bool m_needSaveTorrentsQueue = false;
         bool m_refreshEnqueued = false;
         QTimer *m_seedingLimitTimer = nullptr;
         QTimer *m_resumeDataTimer = nullptr;
+        AnnounceScheduler *m_announceScheduler = nullptr;
+        QTimer *m_dynamicQueueingTimer = nullptr;
+        QTimer *m_uploadAllocationTimer = nullptr;
+        QTimer *m_transferHistorySaveTimer = nullptr;
+        QTimer *m_torrentsTransferHistoryTimer = nullptr;
         // IP filtering
         QPointer<FilterParserThread> m_filterParser;
         QPointer<BandwidthScheduler> m_bwScheduler;
@@ -712,6 +761,7 @@ namespace BitTorrent
         QHash<TorrentID, lt::torrent_handle> m_downloadedMetadata;
 
         QHash<TorrentID, TorrentImpl *> m_torrents;
+        TorrentsQueue m_torrentsQueue;
         QHash<TorrentID, TorrentImpl *> m_hybridTorrentsByAltID;
         QHash<TorrentID, LoadTorrentParams> m_loadingTorrents;
         QHash<QString, AddTorrentParams> m_downloadedTorrents;
@@ -719,11 +769,23 @@ namespace BitTorrent
         QSet<TorrentID> m_needSaveResumeDataTorrents;
         QHash<TorrentID, TorrentID> m_changedTorrentIDs;
         QMap<QString, CategoryOptions> m_categories;
-        QSet<QString> m_tags;
+        TagIndex m_tags;
+        StringPool m_stringPool;
 
-        // This field holds amounts of peers reported by trackers in their responses to announces
-        // (torrent.tracker_name.tracker_local_endpoint.num_peers)
-        QHash<lt::torrent_handle, QHash<std::string, QMap<TrackerEntry::Endpoint, int>>> m_updatedTrackerEntries;
+        // Tracker entries updated from tracker alerts since the last refresh
+        QHash<Torrent *, QHash<QString, TrackerEntry>> m_updatedTrackerEntries;
+        // Torrents which received announce replies, so swarm counts should be fetched for them
+        QSet<lt::torrent_handle> m_trackerScrapeDataRequests;
+        TrackerHostStatistics m_trackerHostStatistics;
+
+        DemandQueueScheduler m_demandQueueScheduler;
+        // position of the next batch of queued by demand torrents to be scraped
+        int m_demandQueueScrapeOffset = 0;
+
+        UploadAllocator m_uploadAllocator;
+
+        QHash<TorrentID, PieceAvailabilityStats> m_pieceAvailabilityStats;
+        QSet<TorrentID> m_pieceAvailabilityStatsRequests;
 
         // I/O errored torrents
         QSet<TorrentID> m_recentErroredTorrents;
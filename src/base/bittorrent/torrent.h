@@ -53,6 +53,7 @@ namespace BitTorrent
     class TorrentInfo;
     struct PeerAddress;
     struct TrackerEntry;
+    struct TransferAmount;
 
     // Using `Q_ENUM_NS()` without a wrapper namespace in our case is not advised
     // since `Q_NAMESPACE` cannot be used when the same namespace resides at different files.
@@ -204,6 +205,8 @@ namespace BitTorrent
         virtual bool addTag(const QString &tag) = 0;
         virtual bool removeTag(const QString &tag) = 0;
         virtual void removeAllTags() = 0;
+        // bits indexed by Session::tagIndex(), may be shorter than its capacity
+        virtual const QBitArray &tagBits() const = 0;
 
         virtual int piecesCount() const = 0;
         virtual int piecesHave() const = 0;
@@ -241,6 +244,8 @@ namespace BitTorrent
         virtual QString error() const = 0;
         virtual qlonglong totalDownload() const = 0;
         virtual qlonglong totalUpload() const = 0;
+        // Amount transferred within the given time range (seconds since epoch), see TorrentTransferHistory
+        virtual TransferAmount transferred(qint64 from, qint64 to) const = 0;
         virtual qlonglong activeTime() const = 0;
         virtual qlonglong finishedTime() const = 0;
         virtual qlonglong eta() const = 0;
@@ -0,0 +1,309 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrenteventbus.h"
+
+#include <algorithm>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/net/downloadmanager.h"
+#include "base/preferences.h"
+#include "base/settingvalue.h"
+#include "session.h"
+#include "torrent.h"
+
+#define SETTINGS_KEY(name) (u"BitTorrent/TorrentEvents/" name)
+
+namespace
+{
+    // events published within this interval (in ms) are delivered together
+    const int BATCH_INTERVAL = 500;
+    const int MAX_BATCH_SIZE = 100;
+    const int MIN_RETRY_DELAY = 1000;
+    const int MAX_RETRY_DELAY = 300000;
+
+    QString toString(const BitTorrent::TorrentEventType type)
+    {
+        switch (type)
+        {
+        case BitTorrent::TorrentEventType::Added:
+            return u"added"_qs;
+        case BitTorrent::TorrentEventType::MetadataReceived:
+            return u"metadata_received"_qs;
+        case BitTorrent::TorrentEventType::Finished:
+            return u"finished"_qs;
+        case BitTorrent::TorrentEventType::Errored:
+            return u"errored"_qs;
+        case BitTorrent::TorrentEventType::Removed:
+            return u"removed"_qs;
+        case BitTorrent::TorrentEventType::Moved:
+            return u"moved"_qs;
+        case BitTorrent::TorrentEventType::TrackerError:
+            return u"tracker_error"_qs;
+        }
+
+        Q_ASSERT(false);
+        return {};
+    }
+}
+
+using namespace BitTorrent;
+
+QJsonObject TorrentEvent::toJSON() const
+{
+    QJsonObject jsonObj
+    {
+        {u"id"_qs, id},
+        {u"type"_qs, toString(type)},
+        {u"timestamp"_qs, timestamp.toSecsSinceEpoch()},
+        {u"hash"_qs, torrentID.toString()},
+        {u"name"_qs, name}
+    };
+
+    if (!details.isEmpty())
+        jsonObj[u"details"_qs] = details;
+
+    return jsonObj;
+}
+
+TorrentEventBus *TorrentEventBus::m_instance = nullptr;
+
+TorrentEventBus::TorrentEventBus(const QStringList &webhookURLs, const int bufferSize, QObject *parent)
+    : QObject {parent}
+    , m_bufferSize {bufferSize}
+{
+    m_batchTimer.setSingleShot(true);
+    m_batchTimer.setInterval(BATCH_INTERVAL);
+    connect(&m_batchTimer, &QTimer::timeout, this, &TorrentEventBus::flush);
+
+    for (const QString &url : webhookURLs)
+    {
+        if (!Net::DownloadManager::hasSupportedScheme(url))
+        {
+            LogMsg(tr("Ignoring invalid torrent events webhook. URL: \"%1\"").arg(url), Log::WARNING);
+            continue;
+        }
+
+        m_webhooks.insert(url, {url});
+    }
+}
+
+void TorrentEventBus::initInstance()
+{
+    if (m_instance)
+        return;
+
+    const QStringList webhookURLs = SettingValue<QStringList>(SETTINGS_KEY(u"WebhookURLs"_qs));
+    const int bufferSize = SettingValue<int>(SETTINGS_KEY(u"BufferSize"_qs)).get(1000);
+    m_instance = new TorrentEventBus(webhookURLs, std::clamp(bufferSize, MAX_BATCH_SIZE, 100000));
+    m_instance->watchSession(Session::instance());
+}
+
+void TorrentEventBus::freeInstance()
+{
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+TorrentEventBus *TorrentEventBus::instance()
+{
+    return m_instance;
+}
+
+qint64 TorrentEventBus::lastEventID() const
+{
+    return m_lastEventID;
+}
+
+QVector<TorrentEvent> TorrentEventBus::events(const qint64 sinceID, const int maxCount, bool *eventsLost) const
+{
+    // IDs start over in every session, so an ID that wasn't issued yet comes from an earlier one
+    const bool isStaleID = (sinceID > m_lastEventID);
+    const qint64 firstID = isStaleID ? 1 : std::max<qint64>((sinceID + 1), 1);
+    const qint64 oldestID = m_events.empty() ? (m_lastEventID + 1) : m_events.front().id;
+
+    if (eventsLost)
+        *eventsLost = isStaleID || (firstID < oldestID);
+
+    const auto begin = m_events.cbegin() + std::max<qint64>((firstID - oldestID), 0);
+    const auto end = begin + std::clamp<qint64>(maxCount, 0, (m_events.cend() - begin));
+    return QVector<TorrentEvent>(begin, end);
+}
+
+void TorrentEventBus::watchSession(const Session *session)
+{
+    connect(session, &Session::torrentAdded, this, [this](const Torrent *torrent)
+    {
+        publish(TorrentEventType::Added, torrent);
+    });
+    connect(session, &Session::torrentMetadataReceived, this, [this](const Torrent *torrent)
+    {
+        publish(TorrentEventType::MetadataReceived, torrent);
+    });
+    connect(session, &Session::torrentFinished, this, [this](const Torrent *torrent)
+    {
+        publish(TorrentEventType::Finished, torrent);
+    });
+    connect(session, &Session::fullDiskError, this, [this](const Torrent *torrent, const QString &msg)
+    {
+        m_erroredTorrents.insert(torrent->id());
+        publish(TorrentEventType::Errored, torrent, msg);
+    });
+    connect(session, &Session::torrentsUpdated, this, &TorrentEventBus::handleTorrentsUpdated);
+    connect(session, &Session::torrentAboutToBeRemoved, this, [this](const Torrent *torrent)
+    {
+        m_erroredTorrents.remove(torrent->id());
+        publish(TorrentEventType::Removed, torrent);
+    });
+    connect(session, &Session::torrentSavePathChanged, this, [this](const Torrent *torrent)
+    {
+        publish(TorrentEventType::Moved, torrent, torrent->savePath().toString());
+    });
+    connect(session, &Session::trackerError, this, [this](const Torrent *torrent, const QString &tracker)
+    {
+        publish(TorrentEventType::TrackerError, torrent, tracker);
+    });
+}
+
+void TorrentEventBus::handleTorrentsUpdated(const QVector<Torrent *> &torrents)
+{
+    // Torrents may get into the error state without a disk error (e.g. when their files are missing)
+    for (const Torrent *torrent : torrents)
+    {
+        if (torrent->state() != TorrentState::Error)
+        {
+            m_erroredTorrents.remove(torrent->id());
+            continue;
+        }
+
+        if (!m_erroredTorrents.contains(torrent->id()))
+        {
+            m_erroredTorrents.insert(torrent->id());
+            publish(TorrentEventType::Errored, torrent, torrent->error());
+        }
+    }
+}
+
+void TorrentEventBus::publish(const TorrentEventType type, const Torrent *torrent, const QString &details)
+{
+    publish(type, torrent->id(), torrent->name(), details);
+}
+
+void TorrentEventBus::publish(const TorrentEventType type, const TorrentID &torrentID, const QString &name, const QString &details)
+{
+    m_events.push_back({++m_lastEventID, type, QDateTime::currentDateTimeUtc(), torrentID, name, details});
+    // drop the oldest events rather than let slow consumers hold an unbounded backlog
+    while (m_events.size() > static_cast<std::size_t>(m_bufferSize))
+        m_events.pop_front();
+
+    if ((m_lastEventID - m_lastPublishedID) >= MAX_BATCH_SIZE)
+        flush();
+    else if (!m_batchTimer.isActive())
+        m_batchTimer.start();
+}
+
+void TorrentEventBus::flush()
+{
+    m_batchTimer.stop();
+
+    const QVector<TorrentEvent> batch = events(m_lastPublishedID, (m_lastEventID - m_lastPublishedID));
+    m_lastPublishedID = m_lastEventID;
+    if (batch.isEmpty())
+        return;
+
+    emit eventsPublished(batch);
+
+    for (Webhook &webhook : m_webhooks)
+    {
+        if (!webhook.isBusy)
+            deliver(webhook);
+    }
+}
+
+void TorrentEventBus::deliver(Webhook &webhook)
+{
+    bool eventsLost = false;
+    const QVector<TorrentEvent> batch = events(webhook.lastDeliveredID
+            , std::min<qint64>(MAX_BATCH_SIZE, (m_lastPublishedID - webhook.lastDeliveredID)), &eventsLost);
+    webhook.isBusy = !batch.isEmpty();
+    if (!webhook.isBusy)
+        return;
+
+    QJsonArray jsonEvents;
+    for (const TorrentEvent &event : batch)
+        jsonEvents.append(event.toJSON());
+
+    const QJsonObject payload
+    {
+        {u"events"_qs, jsonEvents},
+        {u"lost"_qs, eventsLost}
+    };
+
+    const QString url = webhook.url;
+    const qint64 lastEventID = batch.last().id;
+    Net::DownloadManager::instance()->download(
+            Net::DownloadRequest(url).postData(QJsonDocument(payload).toJson(QJsonDocument::Compact))
+                .contentType(u"application/json"_qs).limit(1024 * 1024)
+            , Preferences::instance()->useProxyForGeneralPurposes()
+            , this, [this, url, lastEventID](const Net::DownloadResult &result)
+    {
+        handleDeliveryFinished(url, lastEventID, result);
+    });
+}
+
+void TorrentEventBus::handleDeliveryFinished(const QString &url, const qint64 lastEventID, const Net::DownloadResult &result)
+{
+    Webhook &webhook = m_webhooks[url];
+
+    if (result.status == Net::DownloadStatus::Success)
+    {
+        webhook.lastDeliveredID = lastEventID;
+        webhook.retryDelay = 0;
+        // send the events published in the meantime, if any
+        deliver(webhook);
+        return;
+    }
+
+    if (webhook.retryDelay == 0)
+    {
+        LogMsg(tr("Failed to deliver torrent events to webhook. URL: \"%1\". Error: \"%2\"")
+               .arg(url, result.errorString), Log::WARNING);
+    }
+
+    // keep the webhook busy until the retry, the events published meanwhile are sent along
+    webhook.retryDelay = std::clamp((webhook.retryDelay * 2), MIN_RETRY_DELAY, MAX_RETRY_DELAY);
+    QTimer::singleShot(webhook.retryDelay, this, [this, url]()
+    {
+        deliver(m_webhooks[url]);
+    });
+}
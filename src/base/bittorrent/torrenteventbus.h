@@ -0,0 +1,134 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <deque>
+
+#include <QtGlobal>
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+
+#include "infohash.h"
+
+class QJsonObject;
+
+namespace Net
+{
+    struct DownloadResult;
+}
+
+namespace BitTorrent
+{
+    class Session;
+    class Torrent;
+
+    enum class TorrentEventType
+    {
+        Added,
+        MetadataReceived,
+        Finished,
+        Errored,
+        Removed,
+        Moved,
+        TrackerError
+    };
+
+    struct TorrentEvent
+    {
+        qint64 id = 0;
+        TorrentEventType type = TorrentEventType::Added;
+        QDateTime timestamp;
+        TorrentID torrentID;
+        QString name;
+        QString details;
+
+        QJsonObject toJSON() const;
+    };
+
+    // Publishes torrent lifecycle events of the session.
+    // Events are kept in a bounded buffer that consumers poll using the ID of the last event they got,
+    // and are also sent in batches to the configured webhooks. If a consumer falls too far behind,
+    // the oldest events are dropped and the consumer is told that it has lost events.
+    class TorrentEventBus final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(TorrentEventBus)
+
+    public:
+        TorrentEventBus(const QStringList &webhookURLs, int bufferSize, QObject *parent = nullptr);
+
+        // the instance publishes the events of BitTorrent::Session
+        static void initInstance();
+        static void freeInstance();
+        static TorrentEventBus *instance();
+
+        qint64 lastEventID() const;
+        // returns at most `maxCount` events published after `sinceID`
+        QVector<TorrentEvent> events(qint64 sinceID, int maxCount, bool *eventsLost = nullptr) const;
+
+        void publish(TorrentEventType type, const TorrentID &torrentID, const QString &name, const QString &details = {});
+
+    signals:
+        void eventsPublished(const QVector<BitTorrent::TorrentEvent> &events);
+
+    private:
+        struct Webhook
+        {
+            QString url;
+            qint64 lastDeliveredID = 0;
+            int retryDelay = 0;
+            bool isBusy = false;
+        };
+
+        void watchSession(const Session *session);
+        void publish(TorrentEventType type, const Torrent *torrent, const QString &details = {});
+        void handleTorrentsUpdated(const QVector<Torrent *> &torrents);
+        void flush();
+        void deliver(Webhook &webhook);
+        void handleDeliveryFinished(const QString &url, qint64 lastEventID, const Net::DownloadResult &result);
+
+        static TorrentEventBus *m_instance;
+
+        const int m_bufferSize;
+
+        std::deque<TorrentEvent> m_events;
+        qint64 m_lastEventID = 0;
+        qint64 m_lastPublishedID = 0;
+        QTimer m_batchTimer;
+        QHash<QString, Webhook> m_webhooks;
+        // torrents whose error has been published already
+        QSet<TorrentID> m_erroredTorrents;
+    };
+}
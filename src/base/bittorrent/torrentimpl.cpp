@@ -57,11 +57,13 @@
 #include "base/preferences.h"
 #include "base/utils/fs.h"
 #include "base/utils/io.h"
+#include "base/utils/random.h"
 #include "base/utils/string.h"
 #include "common.h"
 #include "downloadpriority.h"
 #include "extensiondata.h"
 #include "loadtorrentparams.h"
+#include "memorystatus.h"
 #include "ltqbitarray.h"
 #include "ltqhash.h"
 #include "lttypecast.h"
@@ -80,122 +82,150 @@ namespace
         return entry;
     }
 
+    int trackerProtocolVersion(const lt::tracker_alert *alert)
+    {
 #ifdef QBT_USES_LIBTORRENT2
-    void updateTrackerEntry(TrackerEntry &trackerEntry, const lt::announce_entry &nativeEntry
-            , const lt::info_hash_t &hashes, const QMap<TrackerEntry::Endpoint, int> &updateInfo)
+        lt::protocol_version version = lt::protocol_version::V1;
+        switch (alert->type())
+        {
+        case lt::tracker_announce_alert::alert_type:
+            version = static_cast<const lt::tracker_announce_alert *>(alert)->version;
+            break;
+        case lt::tracker_reply_alert::alert_type:
+            version = static_cast<const lt::tracker_reply_alert *>(alert)->version;
+            break;
+        case lt::tracker_warning_alert::alert_type:
+            version = static_cast<const lt::tracker_warning_alert *>(alert)->version;
+            break;
+        case lt::tracker_error_alert::alert_type:
+            version = static_cast<const lt::tracker_error_alert *>(alert)->version;
+            break;
+        case lt::scrape_reply_alert::alert_type:
+            version = static_cast<const lt::scrape_reply_alert *>(alert)->version;
+            break;
+        default:
+            break;
+        }
+        return (version == lt::protocol_version::V1) ? 1 : 2;
 #else
-    void updateTrackerEntry(TrackerEntry &trackerEntry, const lt::announce_entry &nativeEntry
-            , const QMap<TrackerEntry::Endpoint, int> &updateInfo)
+        Q_UNUSED(alert);
+        return 1;
 #endif
-    {
-        Q_ASSERT(trackerEntry.url == QString::fromStdString(nativeEntry.url));
+    }
 
-        trackerEntry.tier = nativeEntry.tier;
+    void updateEndpointStats(TrackerEntry::EndpointStats &endpointStats, const lt::tracker_alert *alert)
+    {
+        switch (alert->type())
+        {
+        case lt::tracker_announce_alert::alert_type:
+            endpointStats.status = TrackerEntry::Updating;
+            endpointStats.message.clear();
+            break;
+        case lt::tracker_reply_alert::alert_type:
+            endpointStats.status = TrackerEntry::Working;
+            endpointStats.numPeers = static_cast<const lt::tracker_reply_alert *>(alert)->num_peers;
+            break;
+        case lt::tracker_warning_alert::alert_type:
+            endpointStats.status = TrackerEntry::Working;
+            endpointStats.message = QString::fromUtf8(static_cast<const lt::tracker_warning_alert *>(alert)->warning_message());
+            break;
+        case lt::tracker_error_alert::alert_type:
+            {
+                const auto *errorAlert = static_cast<const lt::tracker_error_alert *>(alert);
+                const QString failureReason = QString::fromUtf8(errorAlert->failure_reason());
+                endpointStats.status = TrackerEntry::NotWorking;
+                endpointStats.message = (!failureReason.isEmpty()
+                        ? failureReason : QString::fromLocal8Bit(errorAlert->error.message().c_str()));
+            }
+            break;
+        case lt::scrape_reply_alert::alert_type:
+            {
+                const auto *scrapeAlert = static_cast<const lt::scrape_reply_alert *>(alert);
+                endpointStats.numSeeds = scrapeAlert->complete;
+                endpointStats.numLeeches = scrapeAlert->incomplete;
+            }
+            break;
+        default:
+            break;
+        }
+    }
 
-        int numUpdating = 0;
-        int numWorking = 0;
-        int numNotWorking = 0;
-        QString firstTrackerMessage;
-        QString firstErrorMessage;
+    // Swarm counts received within announce replies aren't reported by alerts
+    // so they are taken from announce entry when it is available
 #ifdef QBT_USES_LIBTORRENT2
-        const auto numEndpoints = static_cast<qsizetype>(nativeEntry.endpoints.size() * ((hashes.has_v1() && hashes.has_v2()) ? 2 : 1));
+    void updateTrackerEntryScrapeData(TrackerEntry &trackerEntry, const lt::announce_entry &nativeEntry, const lt::info_hash_t &hashes)
+    {
         for (const lt::announce_endpoint &endpoint : nativeEntry.endpoints)
         {
             for (const auto protocolVersion : {lt::protocol_version::V1, lt::protocol_version::V2})
             {
-                if (hashes.has(protocolVersion))
-                {
-                    const lt::announce_infohash &infoHash = endpoint.info_hashes[protocolVersion];
-
-                    TrackerEntry::EndpointStats trackerEndpoint;
-                    trackerEndpoint.numPeers = updateInfo.value(endpoint.local_endpoint, trackerEndpoint.numPeers);
-                    trackerEndpoint.numSeeds = infoHash.scrape_complete;
-                    trackerEndpoint.numLeeches = infoHash.scrape_incomplete;
-                    trackerEndpoint.numDownloaded = infoHash.scrape_downloaded;
-
-                    if (infoHash.updating)
-                    {
-                        trackerEndpoint.status = TrackerEntry::Updating;
-                        ++numUpdating;
-                    }
-                    else if (infoHash.fails > 0)
-                    {
-                        trackerEndpoint.status = TrackerEntry::NotWorking;
-                        ++numNotWorking;
-                    }
-                    else if (nativeEntry.verified)
-                    {
-                        trackerEndpoint.status = TrackerEntry::Working;
-                        ++numWorking;
-                    }
-                    else
-                    {
-                        trackerEndpoint.status = TrackerEntry::NotContacted;
-                    }
-
-                    const QString trackerMessage = QString::fromStdString(infoHash.message);
-                    const QString errorMessage = QString::fromLocal8Bit(infoHash.last_error.message().c_str());
-                    trackerEndpoint.message = (!trackerMessage.isEmpty() ? trackerMessage : errorMessage);
-
-                    trackerEntry.stats[endpoint.local_endpoint][(protocolVersion == lt::protocol_version::V1) ? 1 : 2] = trackerEndpoint;
-                    trackerEntry.numPeers = std::max(trackerEntry.numPeers, trackerEndpoint.numPeers);
-                    trackerEntry.numSeeds = std::max(trackerEntry.numSeeds, trackerEndpoint.numSeeds);
-                    trackerEntry.numLeeches = std::max(trackerEntry.numLeeches, trackerEndpoint.numLeeches);
-                    trackerEntry.numDownloaded = std::max(trackerEntry.numDownloaded, trackerEndpoint.numDownloaded);
-
-                    if (firstTrackerMessage.isEmpty())
-                        firstTrackerMessage = trackerMessage;
-                    if (firstErrorMessage.isEmpty())
-                        firstErrorMessage = errorMessage;
-                }
+                if (!hashes.has(protocolVersion))
+                    continue;
+
+                const lt::announce_infohash &infoHash = endpoint.info_hashes[protocolVersion];
+                TrackerEntry::EndpointStats &endpointStats = trackerEntry.stats[endpoint.local_endpoint][(protocolVersion == lt::protocol_version::V1) ? 1 : 2];
+                endpointStats.numSeeds = infoHash.scrape_complete;
+                endpointStats.numLeeches = infoHash.scrape_incomplete;
+                endpointStats.numDownloaded = infoHash.scrape_downloaded;
             }
         }
+    }
 #else
-        const auto numEndpoints = static_cast<qsizetype>(nativeEntry.endpoints.size());
+    void updateTrackerEntryScrapeData(TrackerEntry &trackerEntry, const lt::announce_entry &nativeEntry)
+    {
         for (const lt::announce_endpoint &endpoint : nativeEntry.endpoints)
         {
-            TrackerEntry::EndpointStats trackerEndpoint;
-            trackerEndpoint.numPeers = updateInfo.value(endpoint.local_endpoint, trackerEndpoint.numPeers);
-            trackerEndpoint.numSeeds = endpoint.scrape_complete;
-            trackerEndpoint.numLeeches = endpoint.scrape_incomplete;
-            trackerEndpoint.numDownloaded = endpoint.scrape_downloaded;
-
-            if (endpoint.updating)
-            {
-                trackerEndpoint.status = TrackerEntry::Updating;
-                ++numUpdating;
-            }
-            else if (endpoint.fails > 0)
-            {
-                trackerEndpoint.status = TrackerEntry::NotWorking;
-                ++numNotWorking;
-            }
-            else if (nativeEntry.verified)
-            {
-                trackerEndpoint.status = TrackerEntry::Working;
-                ++numWorking;
-            }
-            else
-            {
-                trackerEndpoint.status = TrackerEntry::NotContacted;
-            }
+            TrackerEntry::EndpointStats &endpointStats = trackerEntry.stats[endpoint.local_endpoint][1];
+            endpointStats.numSeeds = endpoint.scrape_complete;
+            endpointStats.numLeeches = endpoint.scrape_incomplete;
+            endpointStats.numDownloaded = endpoint.scrape_downloaded;
+        }
+    }
+#endif
 
-            const QString trackerMessage = QString::fromStdString(endpoint.message);
-            const QString errorMessage = QString::fromLocal8Bit(endpoint.last_error.message().c_str());
-            trackerEndpoint.message = (!trackerMessage.isEmpty() ? trackerMessage : errorMessage);
+    // Calculates overall tracker status from the stats of its endpoints
+    void updateTrackerEntryStatus(TrackerEntry &trackerEntry)
+    {
+        int numEndpoints = 0;
+        int numUpdating = 0;
+        int numWorking = 0;
+        int numNotWorking = 0;
+        QString firstTrackerMessage;
+        QString firstErrorMessage;
 
-            trackerEntry.stats[endpoint.local_endpoint][1] = trackerEndpoint;
-            trackerEntry.numPeers = std::max(trackerEntry.numPeers, trackerEndpoint.numPeers);
-            trackerEntry.numSeeds = std::max(trackerEntry.numSeeds, trackerEndpoint.numSeeds);
-            trackerEntry.numLeeches = std::max(trackerEntry.numLeeches, trackerEndpoint.numLeeches);
-            trackerEntry.numDownloaded = std::max(trackerEntry.numDownloaded, trackerEndpoint.numDownloaded);
+        trackerEntry.numPeers = -1;
+        trackerEntry.numSeeds = -1;
+        trackerEntry.numLeeches = -1;
+        trackerEntry.numDownloaded = -1;
 
-            if (firstTrackerMessage.isEmpty())
-                firstTrackerMessage = trackerMessage;
-            if (firstErrorMessage.isEmpty())
-                firstErrorMessage = errorMessage;
+        for (const QHash<int, TrackerEntry::EndpointStats> &endpointStats : asConst(trackerEntry.stats))
+        {
+            for (const TrackerEntry::EndpointStats &stats : endpointStats)
+            {
+                ++numEndpoints;
+                if (stats.status == TrackerEntry::Updating)
+                    ++numUpdating;
+                else if (stats.status == TrackerEntry::Working)
+                    ++numWorking;
+                else if (stats.status == TrackerEntry::NotWorking)
+                    ++numNotWorking;
+
+                trackerEntry.numPeers = std::max(trackerEntry.numPeers, stats.numPeers);
+                trackerEntry.numSeeds = std::max(trackerEntry.numSeeds, stats.numSeeds);
+                trackerEntry.numLeeches = std::max(trackerEntry.numLeeches, stats.numLeeches);
+                trackerEntry.numDownloaded = std::max(trackerEntry.numDownloaded, stats.numDownloaded);
+
+                if (stats.status == TrackerEntry::NotWorking)
+                {
+                    if (firstErrorMessage.isEmpty())
+                        firstErrorMessage = stats.message;
+                }
+                else if (firstTrackerMessage.isEmpty())
+                {
+                    firstTrackerMessage = stats.message;
+                }
+            }
         }
-#endif
 
         if (numEndpoints > 0)
         {
@@ -230,6 +260,32 @@ namespace
     {
         return ((value < 0) || (value == std::numeric_limits<int>::max())) ? 0 : value;
     }
+
+    // Returns the time libtorrent is going to announce to the tracker next
+    lt::time_point nextAnnounceTime(const lt::announce_entry &nativeEntry, const BitTorrent::InfoHash &infoHash)
+    {
+        // not announced yet
+        if (nativeEntry.endpoints.empty())
+            return lt::time_point::min();
+
+        lt::time_point result = lt::time_point::max();
+#ifdef QBT_USES_LIBTORRENT2
+        const lt::info_hash_t hashes = infoHash;
+        for (const lt::announce_endpoint &endpoint : nativeEntry.endpoints)
+        {
+            for (const auto protocolVersion : {lt::protocol_version::V1, lt::protocol_version::V2})
+            {
+                if (hashes.has(protocolVersion))
+                    result = std::min<lt::time_point>(result, endpoint.info_hashes[protocolVersion].next_announce);
+            }
+        }
+#else
+        Q_UNUSED(infoHash);
+        for (const lt::announce_endpoint &endpoint : nativeEntry.endpoints)
+            result = std::min<lt::time_point>(result, endpoint.next_announce);
+#endif
+        return result;
+    }
 }
 
 // TorrentImpl
@@ -246,10 +302,9 @@ TorrentImpl::TorrentImpl(SessionImpl *session, lt::session *nativeSession
     , m_infoHash(m_nativeHandle.info_hash())
 #endif
     , m_name(params.name)
-    , m_savePath(params.savePath)
-    , m_downloadPath(params.downloadPath)
-    , m_category(params.category)
-    , m_tags(params.tags)
+    , m_savePath(session->stringPool().intern(params.savePath))
+    , m_downloadPath(session->stringPool().intern(params.downloadPath))
+    , m_category(session->stringPool().intern(params.category))
     , m_ratioLimit(params.ratioLimit)
     , m_seedingTimeLimit(params.seedingTimeLimit)
     , m_operatingMode(params.operatingMode)
@@ -261,6 +316,7 @@ TorrentImpl::TorrentImpl(SessionImpl *session, lt::session *nativeSession
     , m_ltAddTorrentParams(params.ltAddTorrentParams)
     , m_downloadLimit(cleanLimitValue(m_ltAddTorrentParams.download_limit))
     , m_uploadLimit(cleanLimitValue(m_ltAddTorrentParams.upload_limit))
+    , m_transferHistory(TorrentTransferHistory::fromData(params.transferHistory))
 {
     if (m_ltAddTorrentParams.ti)
     {
@@ -279,7 +335,6 @@ TorrentImpl::TorrentImpl(SessionImpl *session, lt::session *nativeSession
                         , LT::toNative(m_ltAddTorrentParams.file_priorities.empty() ? DownloadPriority::Normal : DownloadPriority::Ignored));
 
         m_completedFiles.fill(static_cast<bool>(m_ltAddTorrentParams.flags & lt::torrent_flags::seed_mode), filesCount);
-        m_filesProgress.resize(filesCount);
 
         for (int i = 0; i < filesCount; ++i)
         {
@@ -298,10 +353,21 @@ TorrentImpl::TorrentImpl(SessionImpl *session, lt::session *nativeSession
 
     setStopCondition(params.stopCondition);
 
+    for (const QString &tag : params.tags)
+    {
+        const int tagIndex = m_session->tagIndex().indexOf(tag);
+        if (tagIndex < 0)
+            continue;
+
+        if (m_tags.size() <= tagIndex)
+            m_tags.resize(tagIndex + 1);
+        m_tags.setBit(tagIndex);
+    }
+
     const auto *extensionData = static_cast<ExtensionData *>(m_ltAddTorrentParams.userdata);
     m_trackerEntries.reserve(static_cast<decltype(m_trackerEntries)::size_type>(extensionData->trackers.size()));
     for (const lt::announce_entry &announceEntry : extensionData->trackers)
-        m_trackerEntries.append({QString::fromStdString(announceEntry.url), announceEntry.tier});
+        m_trackerEntries.append({m_session->stringPool().intern(QString::fromStdString(announceEntry.url)), announceEntry.tier});
     m_urlSeeds.reserve(static_cast<decltype(m_urlSeeds)::size_type>(extensionData->urlSeeds.size()));
     for (const std::string &urlSeed : extensionData->urlSeeds)
         m_urlSeeds.append(QString::fromStdString(urlSeed));
@@ -431,7 +497,7 @@ void TorrentImpl::setSavePath(const Path &path)
     if (resolvedPath == savePath())
         return;
 
-    m_savePath = resolvedPath;
+    m_savePath = m_session->stringPool().intern(resolvedPath);
 
     m_session->handleTorrentNeedSaveResumeData(this);
 
@@ -454,7 +520,7 @@ void TorrentImpl::setDownloadPath(const Path &path)
     if (resolvedPath == m_downloadPath)
         return;
 
-    m_downloadPath = resolvedPath;
+    m_downloadPath = m_session->stringPool().intern(resolvedPath);
 
     m_session->handleTorrentNeedSaveResumeData(this);
 
@@ -500,8 +566,8 @@ void TorrentImpl::setAutoTMMEnabled(bool enabled)
     m_useAutoTMM = enabled;
     if (!m_useAutoTMM)
     {
-        m_savePath = m_session->categorySavePath(category());
-        m_downloadPath = m_session->categoryDownloadPath(category());
+        m_savePath = m_session->stringPool().intern(m_session->categorySavePath(category()));
+        m_downloadPath = m_session->stringPool().intern(m_session->categoryDownloadPath(category()));
     }
 
     m_session->handleTorrentNeedSaveResumeData(this);
@@ -553,8 +619,11 @@ void TorrentImpl::addTrackers(QVector<TrackerEntry> trackers)
         return;
 
     trackers = QVector<TrackerEntry>(newTrackers.cbegin(), newTrackers.cend());
-    for (const TrackerEntry &tracker : trackers)
+    for (TrackerEntry &tracker : trackers)
+    {
+        tracker.url = m_session->stringPool().intern(tracker.url);
         m_nativeHandle.add_tracker(makeNativeAnnounceEntry(tracker.url, tracker.tier));
+    }
 
     m_trackerEntries.append(trackers);
     std::sort(m_trackerEntries.begin(), m_trackerEntries.end()
@@ -596,8 +665,11 @@ void TorrentImpl::replaceTrackers(QVector<TrackerEntry> trackers)
 
     std::vector<lt::announce_entry> nativeTrackers;
     nativeTrackers.reserve(trackers.size());
-    for (const TrackerEntry &tracker : trackers)
+    for (TrackerEntry &tracker : trackers)
+    {
+        tracker.url = m_session->stringPool().intern(tracker.url);
         nativeTrackers.emplace_back(makeNativeAnnounceEntry(tracker.url, tracker.tier));
+    }
 
     m_nativeHandle.replace_trackers(nativeTrackers);
     m_trackerEntries = trackers;
@@ -733,7 +805,7 @@ bool TorrentImpl::connectPeer(const PeerAddress &peerAddress)
 
 bool TorrentImpl::needSaveResumeData() const
 {
-    return m_nativeStatus.need_save_resume;
+    return m_nativeStatus.need_save_resume || m_isTransferHistoryDirty;
 }
 
 void TorrentImpl::saveResumeData(lt::resume_data_flags_t flags)
@@ -791,12 +863,13 @@ bool TorrentImpl::belongsToCategory(const QString &category) const
 
 TagSet TorrentImpl::tags() const
 {
-    return m_tags;
+    return m_session->tagIndex().toTagSet(m_tags);
 }
 
 bool TorrentImpl::hasTag(const QString &tag) const
 {
-    return m_tags.contains(tag);
+    const int tagIndex = m_session->tagIndex().indexOf(tag);
+    return (tagIndex >= 0) && (tagIndex < m_tags.size()) && m_tags.testBit(tagIndex);
 }
 
 bool TorrentImpl::addTag(const QString &tag)
@@ -811,7 +884,10 @@ bool TorrentImpl::addTag(const QString &tag)
         if (!m_session->addTag(tag))
             return false;
     }
-    m_tags.insert(tag);
+    const int tagIndex = m_session->tagIndex().indexOf(tag);
+    if (m_tags.size() <= tagIndex)
+        m_tags.resize(tagIndex + 1);
+    m_tags.setBit(tagIndex);
     m_session->handleTorrentNeedSaveResumeData(this);
     m_session->handleTorrentTagAdded(this, tag);
     return true;
@@ -819,13 +895,13 @@ bool TorrentImpl::addTag(const QString &tag)
 
 bool TorrentImpl::removeTag(const QString &tag)
 {
-    if (m_tags.remove(tag))
-    {
-        m_session->handleTorrentNeedSaveResumeData(this);
-        m_session->handleTorrentTagRemoved(this, tag);
-        return true;
-    }
-    return false;
+    if (!hasTag(tag))
+        return false;
+
+    m_tags.clearBit(m_session->tagIndex().indexOf(tag));
+    m_session->handleTorrentNeedSaveResumeData(this);
+    m_session->handleTorrentTagRemoved(this, tag);
+    return true;
 }
 
 void TorrentImpl::removeAllTags()
@@ -834,6 +910,11 @@ void TorrentImpl::removeAllTags()
         removeTag(tag);
 }
 
+const QBitArray &TorrentImpl::tagBits() const
+{
+    return m_tags;
+}
+
 QDateTime TorrentImpl::addedTime() const
 {
     return QDateTime::fromSecsSinceEpoch(m_nativeStatus.added_time);
@@ -898,8 +979,9 @@ bool TorrentImpl::isQueued() const
 {
     // Torrent is Queued if it isn't in Paused state but paused internally
     return (!isPaused()
-            && (m_nativeStatus.flags & lt::torrent_flags::auto_managed)
-            && (m_nativeStatus.flags & lt::torrent_flags::paused));
+            && (m_isQueuedByDemand
+                || ((m_nativeStatus.flags & lt::torrent_flags::auto_managed)
+                    && (m_nativeStatus.flags & lt::torrent_flags::paused))));
 }
 
 bool TorrentImpl::isChecking() const
@@ -1132,6 +1214,11 @@ qlonglong TorrentImpl::totalUpload() const
     return m_nativeStatus.all_time_upload;
 }
 
+TransferAmount TorrentImpl::transferred(const qint64 from, const qint64 to) const
+{
+    return m_transferHistory.transferred(from, to);
+}
+
 qlonglong TorrentImpl::activeTime() const
 {
     return lt::total_seconds(m_nativeStatus.active_duration);
@@ -1188,14 +1275,18 @@ QVector<qreal> TorrentImpl::filesProgress() const
     if (!hasMetadata())
         return {};
 
-    const int count = m_filesProgress.size();
-    Q_ASSERT(count == filesCount());
-    if (Q_UNLIKELY(count != filesCount()))
-        return {};
-
+    const int count = filesCount();
     if (m_completedFiles.count(true) == count)
         return QVector<qreal>(count, 1);
 
+    // Per-file progress is only tracked once somebody asks for it
+    if (m_filesProgress.isEmpty())
+        materializeFilesProgress();
+
+    Q_ASSERT(m_filesProgress.size() == count);
+    if (Q_UNLIKELY(m_filesProgress.size() != count))
+        return {};
+
     QVector<qreal> result;
     result.reserve(count);
     for (int i = 0; i < count; ++i)
@@ -1443,7 +1534,7 @@ bool TorrentImpl::setCategory(const QString &category)
             return false;
 
         const QString oldCategory = m_category;
-        m_category = category;
+        m_category = m_session->stringPool().intern(category);
         m_session->handleTorrentNeedSaveResumeData(this);
         m_session->handleTorrentCategoryChanged(this, oldCategory);
 
@@ -1464,6 +1555,99 @@ void TorrentImpl::forceReannounce(const int index)
     m_nativeHandle.force_reannounce(0, index);
 }
 
+void TorrentImpl::setQueuedByDemand(const bool queued)
+{
+    if ((queued == m_isQueuedByDemand) || (m_maintenanceJob != MaintenanceJob::None))
+        return;
+
+    m_isQueuedByDemand = queued;
+    if (queued)
+    {
+        // Taken out of auto management so libtorrent doesn't give the slot back to it
+        setAutoManaged(false);
+        m_nativeHandle.pause();
+    }
+    else
+    {
+        setAutoManaged(m_operatingMode == TorrentOperatingMode::AutoManaged);
+    }
+
+    updateState();
+}
+
+void TorrentImpl::scrapeTrackers()
+{
+    m_nativeHandle.scrape_tracker();
+}
+
+void TorrentImpl::postponeAnnounces(const QSet<QString> &trackerURLs, const int seconds)
+{
+    // Only the torrents using the trackers query the worker thread for their announce times
+    QSet<QString> usedTrackerURLs;
+    for (const TrackerEntry &trackerEntry : asConst(m_trackerEntries))
+    {
+        if (trackerURLs.contains(trackerEntry.url))
+            usedTrackerURLs.insert(trackerEntry.url);
+    }
+    if (usedTrackerURLs.isEmpty())
+        return;
+
+    // Torrents get different delays, so that their announces don't all fire together when the backoff is over
+    const int delay = seconds + static_cast<int>(Utils::Random::rand(0, std::max((seconds / 4), 1)));
+
+    // Native tracker indexes are looked up by URL since the trackers of the same tier may be ordered differently
+    m_session->invokeAsync([nativeHandle = m_nativeHandle, infoHash = m_infoHash, trackerURLs = std::move(usedTrackerURLs), seconds, delay]
+    {
+        try
+        {
+            // The announces that aren't due within the backoff are left as they are
+            const lt::time_point deadline = lt::clock_type::now() + lt::seconds(seconds);
+            const std::vector<lt::announce_entry> nativeTrackers = nativeHandle.trackers();
+            for (std::size_t i = 0; i < nativeTrackers.size(); ++i)
+            {
+                const lt::announce_entry &nativeEntry = nativeTrackers[i];
+                if (trackerURLs.contains(QString::fromStdString(nativeEntry.url))
+                        && (nextAnnounceTime(nativeEntry, infoHash) < deadline))
+                {
+                    nativeHandle.force_reannounce(delay, static_cast<int>(i));
+                }
+            }
+        }
+        catch (const std::exception &) {}
+    });
+}
+
+void TorrentImpl::forceReannounceExcept(const QSet<QString> &trackerURLs)
+{
+    const auto isExcluded = [&trackerURLs](const TrackerEntry &trackerEntry)
+    {
+        return trackerURLs.contains(trackerEntry.url);
+    };
+
+    // Native trackers need to be looked up only when some but not all of them are excluded
+    if (std::none_of(m_trackerEntries.cbegin(), m_trackerEntries.cend(), isExcluded))
+    {
+        m_nativeHandle.force_reannounce(0, -1, lt::torrent_handle::ignore_min_interval);
+        return;
+    }
+    if (std::all_of(m_trackerEntries.cbegin(), m_trackerEntries.cend(), isExcluded))
+        return;
+
+    m_session->invokeAsync([nativeHandle = m_nativeHandle, trackerURLs]
+    {
+        try
+        {
+            const std::vector<lt::announce_entry> nativeTrackers = nativeHandle.trackers();
+            for (std::size_t i = 0; i < nativeTrackers.size(); ++i)
+            {
+                if (!trackerURLs.contains(QString::fromStdString(nativeTrackers[i].url)))
+                    nativeHandle.force_reannounce(0, static_cast<int>(i), lt::torrent_handle::ignore_min_interval);
+            }
+        }
+        catch (const std::exception &) {}
+    });
+}
+
 void TorrentImpl::forceDHTAnnounce()
 {
     m_nativeHandle.force_dht_announce();
@@ -1482,10 +1666,19 @@ void TorrentImpl::forceRecheck()
     m_hasMissingFiles = false;
     m_unchecked = false;
 
+    // the torrent gets its slot back, the next rotation decides whether it keeps it
+    if (m_isQueuedByDemand && !isPaused())
+    {
+        m_isQueuedByDemand = false;
+        setAutoManaged(m_operatingMode == TorrentOperatingMode::AutoManaged);
+        if (m_operatingMode == TorrentOperatingMode::Forced)
+            m_nativeHandle.resume();
+    }
+
     m_completedFiles.fill(false);
     m_filesProgress.fill(0);
     m_pieces.fill(false);
-    m_nativeStatus.pieces.clear_all();
+    m_nativeStatus.pieces.clear();
     m_nativeStatus.num_pieces = 0;
 
     if (isPaused())
@@ -1569,27 +1762,86 @@ void TorrentImpl::fileSearchFinished(const Path &savePath, const PathList &fileN
     endReceivedMetadataHandling(savePath, fileNames);
 }
 
-TrackerEntry TorrentImpl::updateTrackerEntry(const lt::announce_entry &announceEntry, const QMap<TrackerEntry::Endpoint, int> &updateInfo)
+TrackerEntry TorrentImpl::updateTrackerEntry(const lt::tracker_alert *alert)
 {
+    const QString trackerURL = QString::fromUtf8(alert->tracker_url());
     const auto it = std::find_if(m_trackerEntries.begin(), m_trackerEntries.end()
-            , [&announceEntry](const TrackerEntry &trackerEntry)
+            , [&trackerURL](const TrackerEntry &trackerEntry)
     {
-        return (trackerEntry.url == QString::fromStdString(announceEntry.url));
+        return (trackerEntry.url == trackerURL);
     });
 
-    Q_ASSERT(it != m_trackerEntries.end());
-    // TODO: use [[unlikely]] in C++20
-    if (Q_UNLIKELY(it == m_trackerEntries.end()))
+    // The tracker could be already removed when the alert is received
+    if (it == m_trackerEntries.end())
+        return {};
+
+    updateEndpointStats(it->stats[alert->local_endpoint][trackerProtocolVersion(alert)], alert);
+    updateTrackerEntryStatus(*it);
+    return *it;
+}
+
+TrackerEntry TorrentImpl::updateTrackerEntryScrapeData(const lt::announce_entry &announceEntry)
+{
+    const QString trackerURL = QString::fromStdString(announceEntry.url);
+    const auto it = std::find_if(m_trackerEntries.begin(), m_trackerEntries.end()
+            , [&trackerURL](const TrackerEntry &trackerEntry)
+    {
+        return (trackerEntry.url == trackerURL);
+    });
+
+    if (it == m_trackerEntries.end())
         return {};
 
 #ifdef QBT_USES_LIBTORRENT2
-    ::updateTrackerEntry(*it, announceEntry, nativeHandle().info_hashes(), updateInfo);
+    ::updateTrackerEntryScrapeData(*it, announceEntry, nativeHandle().info_hashes());
 #else
-    ::updateTrackerEntry(*it, announceEntry, updateInfo);
+    ::updateTrackerEntryScrapeData(*it, announceEntry);
 #endif
+    updateTrackerEntryStatus(*it);
     return *it;
 }
 
+void TorrentImpl::collectMemoryStatus(MemoryStatus &status) const
+{
+    const auto bitsToBytes = [](const qint64 bits) { return (bits + 7) / 8; };
+    const auto stringBytes = [](const QString &str) { return static_cast<qint64>(str.capacity() * sizeof(QChar)); };
+
+    ++status.torrentsCount;
+
+    status.nativeStatus += sizeof(m_nativeStatus)
+            + static_cast<qint64>(m_nativeStatus.name.capacity() + m_nativeStatus.save_path.capacity()
+                + m_nativeStatus.current_tracker.capacity())
+            + bitsToBytes(m_nativeStatus.pieces.size()) + bitsToBytes(m_nativeStatus.verified_pieces.size());
+
+    status.pieces += bitsToBytes(m_pieces.size());
+
+    status.filePaths += m_filePaths.capacity() * sizeof(Path)
+            + m_indexMap.capacity() * (sizeof(lt::file_index_t) + sizeof(int));
+    for (const Path &filePath : m_filePaths)
+        status.filePaths += stringBytes(filePath.data());
+
+    status.filePriorities += m_filePriorities.capacity() * sizeof(DownloadPriority)
+            + bitsToBytes(m_completedFiles.size());
+    status.filesProgress += m_filesProgress.capacity() * sizeof(std::int64_t);
+
+    // tracker URLs are shared via session string pool
+    status.trackers += m_trackerEntries.capacity() * sizeof(TrackerEntry);
+
+    status.urlSeeds += m_urlSeeds.capacity() * sizeof(QUrl);
+    for (const QUrl &urlSeed : m_urlSeeds)
+        status.urlSeeds += urlSeed.toEncoded().size();
+
+    status.addTorrentParams += sizeof(m_ltAddTorrentParams)
+            + bitsToBytes(m_ltAddTorrentParams.have_pieces.size())
+            + bitsToBytes(m_ltAddTorrentParams.verified_pieces.size())
+            + static_cast<qint64>(m_ltAddTorrentParams.file_priorities.capacity() * sizeof(lt::download_priority_t))
+            + static_cast<qint64>(m_ltAddTorrentParams.piece_priorities.capacity() * sizeof(lt::download_priority_t));
+    for (const std::string &tracker : m_ltAddTorrentParams.trackers)
+        status.addTorrentParams += static_cast<qint64>(tracker.capacity());
+    for (const std::string &urlSeed : m_ltAddTorrentParams.url_seeds)
+        status.addTorrentParams += static_cast<qint64>(urlSeed.capacity());
+}
+
 std::shared_ptr<const libtorrent::torrent_info> TorrentImpl::nativeTorrentInfo() const
 {
     if (m_nativeStatus.torrent_file.expired())
@@ -1611,7 +1863,7 @@ void TorrentImpl::endReceivedMetadataHandling(const Path &savePath, const PathLi
                                 , LT::toNative(p.file_priorities.empty() ? DownloadPriority::Normal : DownloadPriority::Ignored));
 
     m_completedFiles.fill(static_cast<bool>(p.flags & lt::torrent_flags::seed_mode), filesCount());
-    m_filesProgress.resize(filesCount());
+    m_filesProgress.clear();
     updateProgress();
 
     for (int i = 0; i < fileNames.size(); ++i)
@@ -1662,7 +1914,7 @@ void TorrentImpl::reload()
     m_completedFiles.fill(false);
     m_filesProgress.fill(0);
     m_pieces.fill(false);
-    m_nativeStatus.pieces.clear_all();
+    m_nativeStatus.pieces.clear();
     m_nativeStatus.num_pieces = 0;
 
     const auto queuePos = m_nativeHandle.queue_position();
@@ -1674,7 +1926,8 @@ void TorrentImpl::reload()
             | lt::torrent_flags::override_trackers
             | lt::torrent_flags::override_web_seeds;
 
-    if (m_isStopped)
+    // the torrent queued by demand stays out of auto management, so it isn't run while reported as Queued
+    if (m_isStopped || m_isQueuedByDemand)
     {
         p.flags |= lt::torrent_flags::paused;
         p.flags &= ~lt::torrent_flags::auto_managed;
@@ -1691,6 +1944,8 @@ void TorrentImpl::reload()
     auto *const extensionData = new ExtensionData;
     p.userdata = LTClientData(extensionData);
     m_nativeHandle = m_nativeSession->add_torrent(p);
+    // the add parameters carry the torrent own limit only, so the allocated one is applied again
+    applyUploadLimit();
 
     m_nativeStatus = extensionData->status;
 
@@ -1707,6 +1962,7 @@ void TorrentImpl::pause()
     {
         m_stopCondition = StopCondition::None;
         m_isStopped = true;
+        m_isQueuedByDemand = false;
         m_session->handleTorrentNeedSaveResumeData(this);
         m_session->handleTorrentPaused(this);
     }
@@ -1729,6 +1985,7 @@ void TorrentImpl::resume(const TorrentOperatingMode mode)
     }
 
     m_operatingMode = mode;
+    m_isQueuedByDemand = false;
 
     if (m_hasMissingFiles)
     {
@@ -1843,6 +2100,7 @@ void TorrentImpl::handleTorrentCheckedAlert(const lt::torrent_checked_alert *p)
             {
                 // torrent is internally paused using NativeTorrentExtension after files checked
                 // so we need to resume it if there is no corresponding "stop condition" set
+                m_isQueuedByDemand = false;
                 setAutoManaged(m_operatingMode == TorrentOperatingMode::AutoManaged);
                 if (m_operatingMode == TorrentOperatingMode::Forced)
                     m_nativeHandle.resume();
@@ -1984,11 +2242,13 @@ void TorrentImpl::prepareResumeData(const lt::add_torrent_params &params)
 
     // We shouldn't save upload_mode flag to allow torrent operate normally on next run
     m_ltAddTorrentParams.flags &= ~lt::torrent_flags::upload_mode;
+    // Allocated upload limit is recalculated at runtime so only user defined one is stored
+    m_ltAddTorrentParams.upload_limit = ((m_uploadLimit > 0) ? m_uploadLimit : -1);
 
     LoadTorrentParams resumeData;
     resumeData.name = m_name;
     resumeData.category = m_category;
-    resumeData.tags = m_tags;
+    resumeData.tags = tags();
     resumeData.contentLayout = m_contentLayout;
     resumeData.ratioLimit = m_ratioLimit;
     resumeData.seedingTimeLimit = m_seedingTimeLimit;
@@ -1998,6 +2258,8 @@ void TorrentImpl::prepareResumeData(const lt::add_torrent_params &params)
     resumeData.stopCondition = m_stopCondition;
     resumeData.operatingMode = m_operatingMode;
     resumeData.ltAddTorrentParams = m_ltAddTorrentParams;
+    resumeData.transferHistory = m_transferHistory.toData();
+    m_isTransferHistoryDirty = false;
     resumeData.useAutoTMM = m_useAutoTMM;
     if (!resumeData.useAutoTMM)
     {
@@ -2296,6 +2558,8 @@ void TorrentImpl::updateStatus(const lt::torrent_status &nativeStatus)
 
     if (m_nativeStatus.num_pieces != oldStatus.num_pieces)
         updateProgress();
+    else
+        m_nativeStatus.pieces.clear();
 
     updateState();
 
@@ -2322,17 +2586,29 @@ void TorrentImpl::updateProgress()
     if (Q_UNLIKELY(!hasMetadata()))
         return;
 
-    Q_ASSERT(!m_filesProgress.isEmpty());
-    if (Q_UNLIKELY(m_filesProgress.isEmpty()))
-        m_filesProgress.resize(filesCount());
-
+    // Keep only the compact QBitArray copy of the pieces,
+    // there is no need to hold the native bitfield between updates
     const QBitArray oldPieces = std::exchange(m_pieces, LT::toQBitArray(m_nativeStatus.pieces));
-    const QBitArray newPieces = m_pieces ^ oldPieces;
+    m_nativeStatus.pieces.clear();
+
+    if (m_filesProgress.isEmpty())
+        return;
+
+    addPiecesToFilesProgress(m_pieces ^ oldPieces);
+}
+
+void TorrentImpl::materializeFilesProgress() const
+{
+    m_filesProgress.fill(0, filesCount());
+    addPiecesToFilesProgress(m_pieces);
+}
 
+void TorrentImpl::addPiecesToFilesProgress(const QBitArray &pieces) const
+{
     const int64_t pieceSize = m_torrentInfo.pieceLength();
-    for (qsizetype index = 0; index < newPieces.size(); ++index)
+    for (qsizetype index = 0; index < pieces.size(); ++index)
     {
-        if (!newPieces.at(index))
+        if (!pieces.at(index))
             continue;
 
         int64_t size = m_torrentInfo.pieceLength(index);
@@ -2391,10 +2667,29 @@ void TorrentImpl::setUploadLimit(const int limit)
         return;
 
     m_uploadLimit = cleanValue;
-    m_nativeHandle.set_upload_limit(m_uploadLimit);
+    applyUploadLimit();
     m_session->handleTorrentNeedSaveResumeData(this);
 }
 
+void TorrentImpl::setAllocatedUploadLimit(const int limit)
+{
+    const int cleanValue = cleanLimitValue(limit);
+    if (cleanValue == m_allocatedUploadLimit)
+        return;
+
+    m_allocatedUploadLimit = cleanValue;
+    applyUploadLimit();
+}
+
+void TorrentImpl::applyUploadLimit()
+{
+    int limit = m_uploadLimit;
+    if ((m_allocatedUploadLimit > 0) && ((limit <= 0) || (m_allocatedUploadLimit < limit)))
+        limit = m_allocatedUploadLimit;
+
+    m_nativeHandle.set_upload_limit(limit);
+}
+
 void TorrentImpl::setDownloadLimit(const int limit)
 {
     const int cleanValue = cleanLimitValue(limit);
@@ -2611,6 +2906,31 @@ void TorrentImpl::fetchPieceAvailability(std::function<void (QVector<int>)> resu
     , std::move(resultHandler));
 }
 
+void TorrentImpl::fetchPieceAvailabilityStats(std::function<void (PieceAvailabilityStats)> resultHandler) const
+{
+    // Summarize the availability in the worker thread so that only the compact result is passed back
+    invokeAsync([nativeHandle = m_nativeHandle, havePieces = pieces(), peersCount = peersCount()]() -> PieceAvailabilityStats
+    {
+        try
+        {
+            std::vector<int> piecesAvailability;
+            nativeHandle.piece_availability(piecesAvailability);
+            return computePieceAvailabilityStats(piecesAvailability, havePieces, peersCount);
+        }
+        catch (const std::exception &) {}
+
+        return {};
+    }
+    , std::move(resultHandler));
+}
+
+void TorrentImpl::recordTransferHistory(const qint64 time)
+{
+    // buckets of all torrents are completed at once, so the history is left to the periodic resume data saving
+    if (m_transferHistory.record(time, totalUpload(), totalDownload()))
+        m_isTransferHistoryDirty = true;
+}
+
 void TorrentImpl::fetchDownloadingPieces(std::function<void (QBitArray)> resultHandler) const
 {
     invokeAsync([nativeHandle = m_nativeHandle, torrentInfo = m_torrentInfo]() -> QBitArray
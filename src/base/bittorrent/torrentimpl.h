@@ -50,16 +50,19 @@
 #include "base/path.h"
 #include "base/tagset.h"
 #include "infohash.h"
+#include "pieceavailabilitystats.h"
 #include "speedmonitor.h"
 #include "torrent.h"
 #include "torrentcontentlayout.h"
 #include "torrentinfo.h"
+#include "torrenttransferhistory.h"
 #include "trackerentry.h"
 
 namespace BitTorrent
 {
     class SessionImpl;
     struct LoadTorrentParams;
+    struct MemoryStatus;
 
     enum class MoveStorageMode
     {
@@ -123,6 +126,7 @@ namespace BitTorrent
         bool addTag(const QString &tag) override;
         bool removeTag(const QString &tag) override;
         void removeAllTags() override;
+        const QBitArray &tagBits() const override;
 
         int filesCount() const override;
         int piecesCount() const override;
@@ -163,6 +167,7 @@ namespace BitTorrent
         QString error() const override;
         qlonglong totalDownload() const override;
         qlonglong totalUpload() const override;
+        TransferAmount transferred(qint64 from, qint64 to) const override;
         qlonglong activeTime() const override;
         qlonglong finishedTime() const override;
         qlonglong eta() const override;
@@ -254,7 +259,16 @@ namespace BitTorrent
         void saveResumeData(lt::resume_data_flags_t flags = {});
         void handleMoveStorageJobFinished(const Path &path, bool hasOutstandingJob);
         void fileSearchFinished(const Path &savePath, const PathList &fileNames);
-        TrackerEntry updateTrackerEntry(const lt::announce_entry &announceEntry, const QMap<TrackerEntry::Endpoint, int> &updateInfo);
+        TrackerEntry updateTrackerEntry(const lt::tracker_alert *alert);
+        TrackerEntry updateTrackerEntryScrapeData(const lt::announce_entry &announceEntry);
+        void postponeAnnounces(const QSet<QString> &trackerURLs, int seconds);
+        void forceReannounceExcept(const QSet<QString> &trackerURLs);
+        void setQueuedByDemand(bool queued);
+        void scrapeTrackers();
+        void setAllocatedUploadLimit(int limit);
+        void fetchPieceAvailabilityStats(std::function<void (PieceAvailabilityStats)> resultHandler) const;
+        void recordTransferHistory(qint64 time);
+        void collectMemoryStatus(MemoryStatus &status) const;
 
     private:
         using EventTrigger = std::function<void ()>;
@@ -263,6 +277,8 @@ namespace BitTorrent
 
         void updateStatus(const lt::torrent_status &nativeStatus);
         void updateProgress();
+        void materializeFilesProgress() const;
+        void addPiecesToFilesProgress(const QBitArray &pieces) const;
         void updateState();
 
         void handleFastResumeRejectedAlert(const lt::fastresume_rejected_alert *p);
@@ -292,6 +308,7 @@ namespace BitTorrent
         void moveStorage(const Path &newPath, MoveStorageMode mode);
         void manageIncompleteFiles();
         void applyFirstLastPiecePriority(bool enabled);
+        void applyUploadLimit();
 
         void prepareResumeData(const lt::add_torrent_params &params);
         void endReceivedMetadataHandling(const Path &savePath, const PathList &fileNames);
@@ -335,7 +352,7 @@ namespace BitTorrent
         Path m_savePath;
         Path m_downloadPath;
         QString m_category;
-        TagSet m_tags;
+        QBitArray m_tags;  // indexes in the session TagIndex
         qreal m_ratioLimit;
         int m_seedingTimeLimit;
         TorrentOperatingMode m_operatingMode;
@@ -345,6 +362,8 @@ namespace BitTorrent
         bool m_hasFirstLastPiecePriority = false;
         bool m_useAutoTMM;
         bool m_isStopped;
+        // seeding slot is taken away by dynamic queueing
+        bool m_isQueuedByDemand = false;
         StopCondition m_stopCondition = StopCondition::None;
 
         bool m_unchecked = false;
@@ -353,8 +372,13 @@ namespace BitTorrent
 
         int m_downloadLimit = 0;
         int m_uploadLimit = 0;
+        // share of the session upload bandwidth given by upload allocation
+        int m_allocatedUploadLimit = 0;
+
+        TorrentTransferHistory m_transferHistory;
+        bool m_isTransferHistoryDirty = false;
 
         QBitArray m_pieces;
-        QVector<std::int64_t> m_filesProgress;
+        mutable QVector<std::int64_t> m_filesProgress;
     };
 }
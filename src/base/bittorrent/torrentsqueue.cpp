@@ -0,0 +1,134 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "torrentsqueue.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace BitTorrent;
+
+int TorrentsQueue::position(const TorrentID &id) const
+{
+    return m_positions.value(id, -1);
+}
+
+bool TorrentsQueue::setPosition(const TorrentID &id, const int position)
+{
+    const int oldPosition = m_positions.value(id, -1);
+    if (oldPosition == position)
+        return false;
+
+    if (position < 0)
+    {
+        remove(id);
+        return true;
+    }
+
+    if (oldPosition >= 0)
+    {
+        m_torrents.erase(oldPosition);
+        markChanged(oldPosition);
+    }
+
+    // The torrent that occupied the position is expected to report its new position along with this one
+    auto [iter, isInserted] = m_torrents.try_emplace(position, id);
+    if (!isInserted)
+    {
+        m_positions.remove(iter->second);
+        iter->second = id;
+    }
+
+    m_positions[id] = position;
+    markChanged(position);
+    return true;
+}
+
+void TorrentsQueue::remove(const TorrentID &id)
+{
+    const auto iter = m_positions.find(id);
+    if (iter == m_positions.end())
+        return;
+
+    m_torrents.erase(iter.value());
+    markChanged(iter.value());
+    m_positions.erase(iter);
+}
+
+int TorrentsQueue::count() const
+{
+    return m_positions.size();
+}
+
+bool TorrentsQueue::isEmpty() const
+{
+    return m_positions.isEmpty();
+}
+
+QVector<TorrentID> TorrentsQueue::toVector() const
+{
+    if (m_torrents.empty())
+        return {};
+
+    QVector<TorrentID> result;
+    result.resize(m_torrents.crbegin()->first + 1);
+    for (const auto &[position, id] : m_torrents)
+        result[position] = id;
+    return result;
+}
+
+bool TorrentsQueue::isChanged() const
+{
+    return (m_changedFrom >= 0);
+}
+
+std::pair<int, int> TorrentsQueue::changedRange() const
+{
+    if (!isChanged())
+        return {-1, -1};
+
+    const int lastPosition = m_torrents.empty() ? 0 : m_torrents.crbegin()->first;
+    return {m_changedFrom, std::min(m_changedTo, lastPosition)};
+}
+
+void TorrentsQueue::markAllChanged()
+{
+    m_changedFrom = 0;
+    m_changedTo = std::numeric_limits<int>::max();
+}
+
+void TorrentsQueue::resetChanged()
+{
+    m_changedFrom = -1;
+    m_changedTo = -1;
+}
+
+void TorrentsQueue::markChanged(const int position)
+{
+    m_changedFrom = (m_changedFrom < 0) ? position : std::min(m_changedFrom, position);
+    m_changedTo = std::max(m_changedTo, position);
+}
@@ -0,0 +1,72 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <map>
+#include <utility>
+
+#include <QHash>
+#include <QVector>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    // Mirrors libtorrent queue positions, so that the queue can be persisted
+    // without scanning all the torrents. Keeps track of the positions changed
+    // since the last save to allow storing only the modified part of the queue.
+    class TorrentsQueue
+    {
+    public:
+        // Returns -1 if the torrent isn't queued
+        int position(const TorrentID &id) const;
+        // Negative position removes the torrent from the queue. Returns true if the position has changed.
+        bool setPosition(const TorrentID &id, int position);
+        void remove(const TorrentID &id);
+
+        int count() const;
+        bool isEmpty() const;
+
+        // Torrent IDs indexed by their queue positions
+        QVector<TorrentID> toVector() const;
+
+        bool isChanged() const;
+        // Returns the first and the last position changed since the last resetChanged() call
+        std::pair<int, int> changedRange() const;
+        void markAllChanged();
+        void resetChanged();
+
+    private:
+        void markChanged(int position);
+
+        std::map<int, TorrentID> m_torrents;
+        QHash<TorrentID, int> m_positions;
+        int m_changedFrom = -1;
+        int m_changedTo = -1;
+    };
+}
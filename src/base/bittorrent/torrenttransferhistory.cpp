@@ -0,0 +1,366 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "torrenttransferhistory.h"
+
+#include <algorithm>
+
+namespace
+{
+    const quint8 DATA_VERSION = 1;
+
+    struct TierSpec
+    {
+        qint64 interval;
+        qint64 capacity;
+    };
+
+    const std::array<TierSpec, 2> TIER_SPECS
+    {{
+        {(60 * 60), (7 * 24)}, // hourly for a week
+        {(24 * 60 * 60), 365} // daily for a year
+    }};
+
+    // Old buckets are dropped in batches to not reencode the history each time
+    qint64 trimThreshold(const TierSpec &spec)
+    {
+        return spec.capacity + (spec.capacity / 8);
+    }
+
+    void appendVarint(QByteArray &data, quint64 value)
+    {
+        while (value >= 0x80)
+        {
+            data.append(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        data.append(static_cast<char>(value));
+    }
+
+    bool readVarint(const char *&pos, const char *end, quint64 &value)
+    {
+        value = 0;
+        for (int shift = 0; (pos != end) && (shift < 64); shift += 7)
+        {
+            const auto byte = static_cast<quint8>(*pos++);
+            value |= (static_cast<quint64>(byte & 0x7F) << shift);
+            if (!(byte & 0x80))
+                return true;
+        }
+
+        return false;
+    }
+
+    // Encoded bucket is either a run of empty buckets (even token with the run length)
+    // or a non-empty bucket (odd token with the uploaded amount followed by the downloaded one)
+    struct Token
+    {
+        quint64 emptyRunLength = 0;
+        BitTorrent::TransferAmount amount;
+    };
+
+    bool readToken(const char *&pos, const char *end, Token &token)
+    {
+        quint64 value = 0;
+        if (!readVarint(pos, end, value))
+            return false;
+
+        if (!(value & 1))
+        {
+            token = {(value >> 1), {}};
+            return true;
+        }
+
+        quint64 downloaded = 0;
+        if (!readVarint(pos, end, downloaded))
+            return false;
+
+        token = {0, {static_cast<qint64>(value >> 1), static_cast<qint64>(downloaded)}};
+        return true;
+    }
+
+    bool isEmpty(const BitTorrent::TransferAmount &amount)
+    {
+        return (amount.uploaded == 0) && (amount.downloaded == 0);
+    }
+}
+
+using namespace BitTorrent;
+
+TorrentTransferHistory TorrentTransferHistory::fromData(const QByteArray &data)
+{
+    const char *pos = data.constData();
+    const char *end = pos + data.size();
+    if ((pos == end) || (static_cast<quint8>(*pos++) != DATA_VERSION))
+        return {};
+
+    const auto readValue = [&pos, end](qint64 &value) -> bool
+    {
+        quint64 rawValue = 0;
+        if (!readVarint(pos, end, rawValue))
+            return false;
+
+        // 0 stands for the missing value
+        value = static_cast<qint64>(rawValue) - 1;
+        return true;
+    };
+
+    TorrentTransferHistory result;
+    if (!readValue(result.m_lastUploaded) || !readValue(result.m_lastDownloaded))
+        return {};
+
+    for (Tier &tier : result.m_tiers)
+    {
+        qint64 encodedSize = 0;
+        if (!readValue(tier.firstBucket) || !readValue(tier.lastBucket)
+                || !readValue(tier.pending.uploaded) || !readValue(tier.pending.downloaded)
+                || !readValue(encodedSize) || (encodedSize < 0) || (encodedSize > (end - pos)))
+        {
+            return {};
+        }
+
+        tier.encoded = QByteArray(pos, static_cast<int>(encodedSize));
+        pos += encodedSize;
+
+        // find the trailing run of empty buckets to keep extending it
+        const char *tokenPos = tier.encoded.constData();
+        const char *encodedEnd = tokenPos + tier.encoded.size();
+        while (tokenPos != encodedEnd)
+        {
+            const char *tokenStart = tokenPos;
+            Token token;
+            if (!readToken(tokenPos, encodedEnd, token))
+                return {};
+
+            tier.emptyRunOffset = (token.emptyRunLength > 0) ? static_cast<int>(tokenStart - tier.encoded.constData()) : -1;
+            tier.emptyRunLength = token.emptyRunLength;
+        }
+    }
+
+    return result;
+}
+
+QByteArray TorrentTransferHistory::toData() const
+{
+    QByteArray data;
+    data.append(static_cast<char>(DATA_VERSION));
+
+    const auto appendValue = [&data](const qint64 value)
+    {
+        appendVarint(data, static_cast<quint64>(value + 1));
+    };
+
+    appendValue(m_lastUploaded);
+    appendValue(m_lastDownloaded);
+    for (const Tier &tier : m_tiers)
+    {
+        appendValue(tier.firstBucket);
+        appendValue(tier.lastBucket);
+        appendValue(tier.pending.uploaded);
+        appendValue(tier.pending.downloaded);
+        appendValue(tier.encoded.size());
+        data.append(tier.encoded);
+    }
+
+    return data;
+}
+
+bool TorrentTransferHistory::record(const qint64 time, const qint64 totalUploaded, const qint64 totalDownloaded)
+{
+    // counters may be reset, e.g. when the torrent is added again
+    const bool hasBaseline = (m_lastUploaded >= 0) && (m_lastDownloaded >= 0)
+            && (totalUploaded >= m_lastUploaded) && (totalDownloaded >= m_lastDownloaded);
+    const TransferAmount amount = hasBaseline
+            ? TransferAmount {(totalUploaded - m_lastUploaded), (totalDownloaded - m_lastDownloaded)}
+            : TransferAmount {};
+    m_lastUploaded = totalUploaded;
+    m_lastDownloaded = totalDownloaded;
+
+    bool hasCompletedBucket = false;
+    for (int i = 0; i < static_cast<int>(m_tiers.size()); ++i)
+        hasCompletedBucket = record(m_tiers[i], i, time, amount) || hasCompletedBucket;
+
+    return hasCompletedBucket;
+}
+
+TransferAmount TorrentTransferHistory::transferred(const qint64 from, const qint64 to) const
+{
+    // use the finest tier which covers the range
+    for (int i = 0; i < static_cast<int>(m_tiers.size()); ++i)
+    {
+        const Tier &tier = m_tiers[i];
+        const bool isLastTier = (i == (static_cast<int>(m_tiers.size()) - 1));
+        if (isLastTier || ((tier.firstBucket >= 0) && (from >= (tier.firstBucket * TIER_SPECS[i].interval))))
+            return transferred(tier, i, from, to);
+    }
+
+    return {};
+}
+
+bool TorrentTransferHistory::record(Tier &tier, const int tierIndex, const qint64 time, const TransferAmount &amount)
+{
+    const TierSpec &spec = TIER_SPECS[tierIndex];
+    // clock may go backwards so never go back to the older buckets
+    const qint64 bucket = std::max((time / spec.interval), tier.lastBucket);
+
+    bool hasCompletedBucket = false;
+    if (tier.lastBucket < 0)
+    {
+        tier.firstBucket = bucket;
+        tier.lastBucket = bucket;
+    }
+    else if (bucket > tier.lastBucket)
+    {
+        hasCompletedBucket = !isEmpty(tier.pending);
+        if ((bucket - tier.lastBucket) > spec.capacity)
+        {
+            // nothing of the history remains
+            tier.encoded.clear();
+            tier.emptyRunOffset = -1;
+            tier.firstBucket = bucket;
+        }
+        else
+        {
+            appendBucket(tier, tier.pending);
+            appendEmptyBuckets(tier, static_cast<quint64>(bucket - tier.lastBucket - 1));
+        }
+
+        tier.lastBucket = bucket;
+        tier.pending = {};
+        if ((tier.lastBucket - tier.firstBucket) > trimThreshold(spec))
+            trim(tier, tierIndex);
+    }
+
+    tier.pending.uploaded += amount.uploaded;
+    tier.pending.downloaded += amount.downloaded;
+    return hasCompletedBucket;
+}
+
+void TorrentTransferHistory::appendBucket(Tier &tier, const TransferAmount &amount)
+{
+    if (isEmpty(amount))
+    {
+        appendEmptyBuckets(tier, 1);
+        return;
+    }
+
+    appendVarint(tier.encoded, ((static_cast<quint64>(amount.uploaded) << 1) | 1));
+    appendVarint(tier.encoded, static_cast<quint64>(amount.downloaded));
+    tier.emptyRunOffset = -1;
+}
+
+void TorrentTransferHistory::appendEmptyBuckets(Tier &tier, const quint64 count)
+{
+    if (count == 0)
+        return;
+
+    if (tier.emptyRunOffset >= 0)
+    {
+        tier.encoded.truncate(tier.emptyRunOffset);
+        tier.emptyRunLength += count;
+    }
+    else
+    {
+        tier.emptyRunOffset = tier.encoded.size();
+        tier.emptyRunLength = count;
+    }
+
+    appendVarint(tier.encoded, (tier.emptyRunLength << 1));
+}
+
+void TorrentTransferHistory::trim(Tier &tier, const int tierIndex)
+{
+    const TierSpec &spec = TIER_SPECS[tierIndex];
+    quint64 excessCount = static_cast<quint64>(tier.lastBucket - tier.firstBucket - spec.capacity);
+
+    const char *pos = tier.encoded.constData();
+    const char *end = pos + tier.encoded.size();
+    Token token;
+    while ((excessCount > 0) && (pos != end))
+    {
+        if (!readToken(pos, end, token))
+            break;
+
+        if (token.emptyRunLength > excessCount)
+        {
+            // drop the beginning of the run only
+            QByteArray encoded;
+            appendVarint(encoded, ((token.emptyRunLength - excessCount) << 1));
+            encoded.append(pos, static_cast<int>(end - pos));
+            tier.encoded = encoded;
+            tier.firstBucket += static_cast<qint64>(excessCount);
+            tier.emptyRunOffset = -1;
+            return;
+        }
+
+        const quint64 droppedCount = std::max<quint64>(1, token.emptyRunLength);
+        excessCount -= droppedCount;
+        tier.firstBucket += static_cast<qint64>(droppedCount);
+    }
+
+    tier.encoded.remove(0, static_cast<int>(pos - tier.encoded.constData()));
+    tier.emptyRunOffset = -1;
+}
+
+TransferAmount TorrentTransferHistory::transferred(const Tier &tier, const int tierIndex, const qint64 from, const qint64 to)
+{
+    const TierSpec &spec = TIER_SPECS[tierIndex];
+    TransferAmount result;
+    if ((tier.lastBucket < 0) || (to <= from))
+        return result;
+
+    const qint64 fromBucket = from / spec.interval;
+    const qint64 toBucket = (to - 1) / spec.interval;
+
+    qint64 bucket = tier.firstBucket;
+    const char *pos = tier.encoded.constData();
+    const char *end = pos + tier.encoded.size();
+    Token token;
+    while ((bucket <= toBucket) && (pos != end) && readToken(pos, end, token))
+    {
+        if (token.emptyRunLength > 0)
+        {
+            bucket += static_cast<qint64>(token.emptyRunLength);
+            continue;
+        }
+
+        if (bucket >= fromBucket)
+        {
+            result.uploaded += token.amount.uploaded;
+            result.downloaded += token.amount.downloaded;
+        }
+        ++bucket;
+    }
+
+    if ((tier.lastBucket >= fromBucket) && (tier.lastBucket <= toBucket))
+    {
+        result.uploaded += tier.pending.uploaded;
+        result.downloaded += tier.pending.downloaded;
+    }
+
+    return result;
+}
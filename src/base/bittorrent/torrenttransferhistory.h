@@ -0,0 +1,85 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <array>
+
+#include <QtGlobal>
+#include <QByteArray>
+
+namespace BitTorrent
+{
+    struct TransferAmount
+    {
+        qint64 uploaded = 0;
+        qint64 downloaded = 0;
+    };
+
+    // Compact history of the amount of data transferred by a torrent.
+    // It consists of hourly buckets for the last week and daily ones for the last year.
+    // Buckets hold the amounts transferred within them, which are kept encoded as variable length
+    // integers with runs of empty buckets collapsed, so the history of an idle torrent takes a few bytes only.
+    class TorrentTransferHistory
+    {
+    public:
+        static TorrentTransferHistory fromData(const QByteArray &data);
+        QByteArray toData() const;
+
+        // Adds the data transferred since the previous call according to the all-time counters.
+        // Returns true when some non-empty bucket is completed, so the history should be stored.
+        bool record(qint64 time, qint64 totalUploaded, qint64 totalDownloaded);
+
+        // Returns the amount transferred within the given time range (seconds since epoch),
+        // the range is extended to the boundaries of the buckets it overlaps
+        TransferAmount transferred(qint64 from, qint64 to) const;
+
+    private:
+        struct Tier
+        {
+            qint64 firstBucket = -1;
+            qint64 lastBucket = -1;
+            // the last bucket is not encoded yet
+            TransferAmount pending;
+            // completed buckets [firstBucket, lastBucket)
+            QByteArray encoded;
+            // position of the encoded run of empty buckets at the end, to extend it instead of adding another one
+            int emptyRunOffset = -1;
+            quint64 emptyRunLength = 0;
+        };
+
+        static bool record(Tier &tier, int tierIndex, qint64 time, const TransferAmount &amount);
+        static void appendBucket(Tier &tier, const TransferAmount &amount);
+        static void appendEmptyBuckets(Tier &tier, quint64 count);
+        static void trim(Tier &tier, int tierIndex);
+        static TransferAmount transferred(const Tier &tier, int tierIndex, qint64 from, qint64 to);
+
+        std::array<Tier, 2> m_tiers;
+        qint64 m_lastUploaded = -1;
+        qint64 m_lastDownloaded = -1;
+    };
+}
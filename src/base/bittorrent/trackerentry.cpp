@@ -29,6 +29,7 @@
 #include "trackerentry.h"
 
 #include <QList>
+#include <QUrl>
 #include <QVector>
 
 QVector<BitTorrent::TrackerEntry> BitTorrent::parseTrackerEntries(const QStringView str)
@@ -56,6 +57,12 @@ QVector<BitTorrent::TrackerEntry> BitTorrent::parseTrackerEntries(const QStringV
     return entries;
 }
 
+QString BitTorrent::trackerHostFromURL(const QString &url)
+{
+    const QString host = QUrl(url).host();
+    return host.isEmpty() ? url : host;
+}
+
 bool BitTorrent::operator==(const TrackerEntry &left, const TrackerEntry &right)
 {
     return (left.url == right.url);
@@ -77,6 +77,8 @@ namespace BitTorrent
     };
 
     QVector<TrackerEntry> parseTrackerEntries(QStringView str);
+    // Returns the host part of tracker URL or the URL itself if it cannot be parsed
+    QString trackerHostFromURL(const QString &url);
 
     bool operator==(const TrackerEntry &left, const TrackerEntry &right);
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
@@ -0,0 +1,203 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "trackerhoststatistics.h"
+
+#include <algorithm>
+
+#include "trackerentry.h"
+
+namespace
+{
+    // The number of consecutive failures after which the host is backed off
+    const int BACKOFF_FAILURES_THRESHOLD = 3;
+    const qint64 MIN_BACKOFF = 60 * 1000;
+    const qint64 MAX_BACKOFF = 60 * 60 * 1000;
+    const int LATENCY_SAMPLES_COUNT = 128;
+
+    int percentile(QVector<int> samples, const int percent)
+    {
+        if (samples.isEmpty())
+            return -1;
+
+        const auto nth = samples.begin() + ((samples.size() - 1) * percent / 100);
+        std::nth_element(samples.begin(), nth, samples.end());
+        return *nth;
+    }
+}
+
+using namespace BitTorrent;
+
+void TrackerHostStatistics::handleAnnounceStarted(const TorrentID &id, const QString &trackerURL)
+{
+    hostData(trackerURL);
+    m_pendingAnnounces[id].insert(trackerURL, QDateTime::currentMSecsSinceEpoch());
+}
+
+void TrackerHostStatistics::handleAnnounceReplied(const TorrentID &id, const QString &trackerURL)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    HostData &data = hostData(trackerURL);
+    ++data.announces;
+    data.failureStreak = 0;
+    data.backoffLevel = 0;
+    data.backoffEnd = 0;
+    addLatencySample(data, id, trackerURL, now);
+}
+
+bool TrackerHostStatistics::handleAnnounceFailed(const TorrentID &id, const QString &trackerURL, const QString &message)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    HostData &data = hostData(trackerURL);
+    ++data.announces;
+    ++data.failures;
+    ++data.failureStreak;
+    data.lastError = message;
+    data.lastErrorTime = now;
+
+    if (const auto iter = m_pendingAnnounces.find(id); iter != m_pendingAnnounces.end())
+    {
+        iter->remove(trackerURL);
+        if (iter->isEmpty())
+            m_pendingAnnounces.erase(iter);
+    }
+
+    // Failures of announces which were sent before the backoff period don't prolong it
+    if ((data.failureStreak < BACKOFF_FAILURES_THRESHOLD) || (now < data.backoffEnd))
+        return false;
+
+    const qint64 backoff = (data.backoffLevel < 16) ? (MIN_BACKOFF << data.backoffLevel) : MAX_BACKOFF;
+    data.backoffEnd = now + std::min(backoff, MAX_BACKOFF);
+    ++data.backoffLevel;
+    return true;
+}
+
+void TrackerHostStatistics::removeTorrent(const TorrentID &id)
+{
+    m_pendingAnnounces.remove(id);
+}
+
+QString TrackerHostStatistics::trackerHost(const QString &trackerURL) const
+{
+    const auto iter = m_trackerHosts.constFind(trackerURL);
+    if (iter != m_trackerHosts.cend())
+        return iter.value();
+
+    const QString host = trackerHostFromURL(trackerURL);
+    m_trackerHosts.insert(trackerURL, host);
+    return host;
+}
+
+int TrackerHostStatistics::backoffRemaining(const QString &trackerURL) const
+{
+    const auto hostIter = m_trackerHosts.constFind(trackerURL);
+    if (hostIter == m_trackerHosts.cend())
+        return 0;
+
+    const qint64 remaining = m_hosts.value(hostIter.value()).backoffEnd - QDateTime::currentMSecsSinceEpoch();
+    return (remaining > 0) ? static_cast<int>((remaining + 999) / 1000) : 0;
+}
+
+QSet<QString> TrackerHostStatistics::trackerURLs(const QString &host) const
+{
+    return m_hosts.value(host).trackerURLs;
+}
+
+TrackerHostStatus TrackerHostStatistics::status(const QString &host) const
+{
+    const auto iter = m_hosts.constFind(host);
+    if (iter == m_hosts.cend())
+        return {host};
+
+    return makeStatus(host, iter.value());
+}
+
+QVector<TrackerHostStatus> TrackerHostStatistics::statuses() const
+{
+    QVector<TrackerHostStatus> result;
+    result.reserve(m_hosts.size());
+    for (auto iter = m_hosts.cbegin(); iter != m_hosts.cend(); ++iter)
+        result.append(makeStatus(iter.key(), iter.value()));
+    return result;
+}
+
+TrackerHostStatistics::HostData &TrackerHostStatistics::hostData(const QString &trackerURL)
+{
+    HostData &data = m_hosts[trackerHost(trackerURL)];
+    data.trackerURLs.insert(trackerURL);
+    return data;
+}
+
+void TrackerHostStatistics::addLatencySample(HostData &data, const TorrentID &id, const QString &trackerURL, const qint64 now)
+{
+    const auto iter = m_pendingAnnounces.find(id);
+    if (iter == m_pendingAnnounces.end())
+        return;
+
+    const auto startTimeIter = iter->constFind(trackerURL);
+    if (startTimeIter != iter->cend())
+    {
+        const int latency = static_cast<int>(now - startTimeIter.value());
+        if (data.latencies.size() < LATENCY_SAMPLES_COUNT)
+        {
+            data.latencies.append(latency);
+        }
+        else
+        {
+            data.latencies[data.latencyPos] = latency;
+            data.latencyPos = (data.latencyPos + 1) % LATENCY_SAMPLES_COUNT;
+        }
+
+        iter->erase(startTimeIter);
+    }
+
+    if (iter->isEmpty())
+        m_pendingAnnounces.erase(iter);
+}
+
+TrackerHostStatus TrackerHostStatistics::makeStatus(const QString &host, const HostData &data) const
+{
+    TrackerHostStatus status;
+    status.host = host;
+    status.announces = data.announces;
+    status.failures = data.failures;
+    status.successRate = (data.announces > 0)
+            ? (static_cast<qreal>(data.announces - data.failures) / data.announces)
+            : 0;
+    status.latencyP50 = percentile(data.latencies, 50);
+    status.latencyP90 = percentile(data.latencies, 90);
+    status.latencyP99 = percentile(data.latencies, 99);
+    status.failureStreak = data.failureStreak;
+    status.lastError = data.lastError;
+    if (data.lastErrorTime > 0)
+        status.lastErrorTime = QDateTime::fromMSecsSinceEpoch(data.lastErrorTime);
+    if (data.backoffEnd > QDateTime::currentMSecsSinceEpoch())
+        status.backoffEnd = QDateTime::fromMSecsSinceEpoch(data.backoffEnd);
+    return status;
+}
@@ -0,0 +1,101 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    struct TrackerHostStatus
+    {
+        QString host;
+        qint64 announces = 0;
+        qint64 failures = 0;
+        qreal successRate = 0;
+        // announce reply time percentiles in milliseconds, -1 if there are no samples
+        int latencyP50 = -1;
+        int latencyP90 = -1;
+        int latencyP99 = -1;
+        int failureStreak = 0;
+        QString lastError;
+        QDateTime lastErrorTime;
+        QDateTime backoffEnd;
+    };
+
+    // Aggregates announce results by tracker host. When a host keeps failing,
+    // announces to it are backed off exponentially for all torrents sharing it.
+    class TrackerHostStatistics
+    {
+    public:
+        void handleAnnounceStarted(const TorrentID &id, const QString &trackerURL);
+        // Tracker responded, either with peers or with torrent specific failure reason
+        void handleAnnounceReplied(const TorrentID &id, const QString &trackerURL);
+        // Tracker could not be reached. Returns true if a new backoff period has been started.
+        bool handleAnnounceFailed(const TorrentID &id, const QString &trackerURL, const QString &message);
+        void removeTorrent(const TorrentID &id);
+
+        // Tracker URLs are shared between many torrents, so each of them is parsed only once
+        QString trackerHost(const QString &trackerURL) const;
+        // Returns the number of seconds announces to the tracker host should be delayed
+        int backoffRemaining(const QString &trackerURL) const;
+        QSet<QString> trackerURLs(const QString &host) const;
+
+        TrackerHostStatus status(const QString &host) const;
+        QVector<TrackerHostStatus> statuses() const;
+
+    private:
+        struct HostData
+        {
+            qint64 announces = 0;
+            qint64 failures = 0;
+            int failureStreak = 0;
+            int backoffLevel = 0;
+            qint64 backoffEnd = 0;
+            QString lastError;
+            qint64 lastErrorTime = 0;
+            QVector<int> latencies;
+            int latencyPos = 0;
+            QSet<QString> trackerURLs;
+        };
+
+        HostData &hostData(const QString &trackerURL);
+        void addLatencySample(HostData &data, const TorrentID &id, const QString &trackerURL, qint64 now);
+        TrackerHostStatus makeStatus(const QString &host, const HostData &data) const;
+
+        QHash<QString, HostData> m_hosts;
+        mutable QHash<QString, QString> m_trackerHosts;  // <tracker URL, tracker host>
+        // announces which are not replied yet
+        QHash<TorrentID, QHash<QString, qint64>> m_pendingAnnounces;
+    };
+}
@@ -0,0 +1,308 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "transferhistory.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QIODevice>
+
+#include "sessionstatus.h"
+
+namespace
+{
+    const quint32 FILE_MAGIC = 0x51425448; // "QBTH"
+    const quint32 FILE_VERSION = 1;
+
+    struct TierSpec
+    {
+        int interval;
+        int capacity;
+    };
+
+    const std::array<TierSpec, 3> TIER_SPECS
+    {{
+        {1, (60 * 60)}, // 1 hour
+        {60, (24 * 60)}, // 1 day
+        {(60 * 60), (365 * 24)} // 1 year
+    }};
+
+    // Gaps up to this length (seconds) are caused by the irregular updates
+    // rather than by missing data so they are filled by the next sample
+    const qint64 MAX_FILLED_GAP = 10;
+
+    quint32 toStoredRate(const quint64 rate)
+    {
+        return static_cast<quint32>(std::min<quint64>(rate, std::numeric_limits<quint32>::max()));
+    }
+}
+
+using namespace BitTorrent;
+
+int TransferHistorySeries::samplesCount() const
+{
+    return (metricsCount > 0) ? (values.size() / metricsCount) : 0;
+}
+
+quint32 TransferHistorySeries::value(const int sample, const int metric) const
+{
+    return values[(sample * metricsCount) + metric];
+}
+
+TransferHistory::TransferHistory()
+    : m_global {makeChannel(MetricsCount)}
+{
+}
+
+void TransferHistory::record(const qint64 time, const SessionStatus &status)
+{
+    std::array<quint64, MetricsCount> rates {};
+    rates[Upload] = std::max<qint64>(0, status.uploadRate);
+    rates[Download] = std::max<qint64>(0, status.downloadRate);
+    rates[PayloadUpload] = std::max<qint64>(0, status.payloadUploadRate);
+    rates[PayloadDownload] = std::max<qint64>(0, status.payloadDownloadRate);
+    rates[OverheadUpload] = std::max<qint64>(0, status.ipOverheadUploadRate);
+    rates[OverheadDownload] = std::max<qint64>(0, status.ipOverheadDownloadRate);
+    rates[DHTUpload] = std::max<qint64>(0, status.dhtUploadRate);
+    rates[DHTDownload] = std::max<qint64>(0, status.dhtDownloadRate);
+    rates[TrackerUpload] = std::max<qint64>(0, status.trackerUploadRate);
+    rates[TrackerDownload] = std::max<qint64>(0, status.trackerDownloadRate);
+
+    record(m_global, time, rates.data());
+}
+
+void TransferHistory::recordCategories(const qint64 time, const QHash<QString, CategoryRates> &rates)
+{
+    for (auto iter = m_categories.begin(); iter != m_categories.end();)
+    {
+        if (rates.contains(iter.key()))
+            ++iter;
+        else
+            iter = m_categories.erase(iter);
+    }
+
+    for (auto iter = rates.cbegin(); iter != rates.cend(); ++iter)
+    {
+        auto channelIter = m_categories.find(iter.key());
+        if (channelIter == m_categories.end())
+            channelIter = m_categories.insert(iter.key(), makeChannel(CategoryMetricsCount));
+
+        std::array<quint64, CategoryMetricsCount> categoryRates {};
+        for (int i = 0; i < CategoryMetricsCount; ++i)
+            categoryRates[i] = std::max<qint64>(0, iter.value()[i]);
+
+        record(channelIter.value(), time, categoryRates.data());
+    }
+}
+
+TransferHistorySeries TransferHistory::series(const Resolution resolution, const qint64 from, const QString &category) const
+{
+    const Channel *channel = &m_global;
+    if (!category.isEmpty())
+    {
+        const auto channelIter = m_categories.constFind(category);
+        if (channelIter == m_categories.cend())
+            return {};
+
+        channel = &channelIter.value();
+    }
+
+    return series(channel->tiers[static_cast<int>(resolution)], channel->metricsCount, from);
+}
+
+QStringList TransferHistory::categories() const
+{
+    return m_categories.keys();
+}
+
+QByteArray TransferHistory::serialize() const
+{
+    QByteArray data;
+    QDataStream out {&data, QIODevice::WriteOnly};
+    out.setVersion(QDataStream::Qt_5_12);
+
+    const auto writeChannel = [&out](const Channel &channel)
+    {
+        out << static_cast<qint32>(channel.metricsCount);
+        for (const Tier &tier : channel.tiers)
+            out << tier.firstSlot << tier.lastSlot << tier.values;
+    };
+
+    out << FILE_MAGIC << FILE_VERSION;
+    writeChannel(m_global);
+    out << static_cast<quint32>(m_categories.size());
+    for (auto iter = m_categories.cbegin(); iter != m_categories.cend(); ++iter)
+    {
+        out << iter.key();
+        writeChannel(iter.value());
+    }
+
+    return qCompress(data);
+}
+
+bool TransferHistory::load(const QByteArray &data)
+{
+    const QByteArray uncompressedData = qUncompress(data);
+    QDataStream in {uncompressedData};
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if ((magic != FILE_MAGIC) || (version != FILE_VERSION))
+        return false;
+
+    const auto readChannel = [&in](const int expectedMetricsCount, Channel &channel) -> bool
+    {
+        qint32 metricsCount = 0;
+        in >> metricsCount;
+        if (metricsCount != expectedMetricsCount)
+            return false;
+
+        channel = makeChannel(metricsCount);
+        for (Tier &tier : channel.tiers)
+        {
+            QVector<quint32> values;
+            in >> tier.firstSlot >> tier.lastSlot >> values;
+            if ((in.status() != QDataStream::Ok) || (values.size() != tier.values.size()))
+                return false;
+
+            tier.values = values;
+        }
+
+        return true;
+    };
+
+    Channel global;
+    if (!readChannel(MetricsCount, global))
+        return false;
+
+    quint32 categoriesCount = 0;
+    in >> categoriesCount;
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    QHash<QString, Channel> categories;
+    for (quint32 i = 0; i < categoriesCount; ++i)
+    {
+        QString name;
+        in >> name;
+        if (!readChannel(CategoryMetricsCount, categories[name]))
+            return false;
+    }
+
+    m_global = global;
+    m_categories = categories;
+    return true;
+}
+
+TransferHistory::Channel TransferHistory::makeChannel(const int metricsCount)
+{
+    Channel channel;
+    channel.metricsCount = metricsCount;
+    for (std::size_t i = 0; i < channel.tiers.size(); ++i)
+    {
+        Tier &tier = channel.tiers[i];
+        tier.interval = TIER_SPECS[i].interval;
+        tier.capacity = TIER_SPECS[i].capacity;
+        tier.values.fill(0, (tier.capacity * metricsCount));
+        tier.sums.fill(0, metricsCount);
+    }
+
+    return channel;
+}
+
+void TransferHistory::record(Channel &channel, const qint64 time, const quint64 *rates)
+{
+    for (Tier &tier : channel.tiers)
+        record(tier, channel.metricsCount, time, rates);
+}
+
+void TransferHistory::record(Tier &tier, const int metricsCount, const qint64 time, const quint64 *rates)
+{
+    // clock may go backwards so never go back to the older slots
+    const qint64 slot = std::max((time / tier.interval), tier.lastSlot);
+
+    if (slot != tier.lastSlot)
+    {
+        if (tier.lastSlot >= 0)
+        {
+            const qint64 gap = slot - tier.lastSlot - 1;
+            const bool isFilled = ((gap * tier.interval) <= MAX_FILLED_GAP);
+            for (qint64 missingSlot = std::max((tier.lastSlot + 1), (slot - tier.capacity)); missingSlot < slot; ++missingSlot)
+            {
+                quint32 *missingValues = tier.values.data() + ((missingSlot % tier.capacity) * metricsCount);
+                for (int i = 0; i < metricsCount; ++i)
+                    missingValues[i] = (isFilled ? toStoredRate(rates[i]) : 0);
+            }
+        }
+        else
+        {
+            tier.firstSlot = slot;
+        }
+
+        tier.lastSlot = slot;
+        tier.sums.fill(0);
+        tier.samplesCount = 0;
+    }
+
+    // the last slot holds the average of the samples received so far
+    ++tier.samplesCount;
+    quint32 *slotValues = tier.values.data() + ((slot % tier.capacity) * metricsCount);
+    for (int i = 0; i < metricsCount; ++i)
+    {
+        tier.sums[i] += rates[i];
+        slotValues[i] = toStoredRate(tier.sums[i] / tier.samplesCount);
+    }
+}
+
+TransferHistorySeries TransferHistory::series(const Tier &tier, const int metricsCount, const qint64 from)
+{
+    TransferHistorySeries result;
+    result.interval = tier.interval;
+    result.metricsCount = metricsCount;
+    if (tier.lastSlot < 0)
+        return result;
+
+    const qint64 firstSlot = std::max({tier.firstSlot, (tier.lastSlot - tier.capacity + 1), (from / tier.interval)});
+    if (firstSlot > tier.lastSlot)
+        return result;
+
+    result.startTime = firstSlot * tier.interval;
+    result.values.reserve(static_cast<int>(tier.lastSlot - firstSlot + 1) * metricsCount);
+    for (qint64 slot = firstSlot; slot <= tier.lastSlot; ++slot)
+    {
+        const quint32 *slotValues = tier.values.constData() + ((slot % tier.capacity) * metricsCount);
+        for (int i = 0; i < metricsCount; ++i)
+            result.values.append(slotValues[i]);
+    }
+
+    return result;
+}
@@ -0,0 +1,136 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <array>
+
+#include <QtGlobal>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+class QByteArray;
+
+namespace BitTorrent
+{
+    struct SessionStatus;
+
+    struct TransferHistorySeries
+    {
+        // Time (seconds since epoch) of the first sample
+        qint64 startTime = 0;
+        // Time between the samples (seconds)
+        int interval = 0;
+        int metricsCount = 0;
+        // Samples ordered by time, each one consists of metricsCount rates (bytes per second)
+        QVector<quint32> values;
+
+        int samplesCount() const;
+        quint32 value(int sample, int metric) const;
+    };
+
+    // Keeps the history of transfer rates with decreasing resolution for older data:
+    // per second samples for the last hour, per minute ones for the last day
+    // and per hour ones for the last year
+    class TransferHistory
+    {
+    public:
+        enum Metric
+        {
+            Upload = 0,
+            Download,
+            PayloadUpload,
+            PayloadDownload,
+            OverheadUpload,
+            OverheadDownload,
+            DHTUpload,
+            DHTDownload,
+            TrackerUpload,
+            TrackerDownload,
+
+            MetricsCount
+        };
+
+        enum CategoryMetric
+        {
+            CategoryPayloadUpload = 0,
+            CategoryPayloadDownload,
+
+            CategoryMetricsCount
+        };
+
+        enum class Resolution
+        {
+            Second = 0,
+            Minute,
+            Hour
+        };
+
+        using CategoryRates = std::array<qint64, CategoryMetricsCount>;
+
+        TransferHistory();
+
+        void record(qint64 time, const SessionStatus &status);
+        // Categories which are not in the list are removed from the history
+        void recordCategories(qint64 time, const QHash<QString, CategoryRates> &rates);
+
+        TransferHistorySeries series(Resolution resolution, qint64 from, const QString &category = {}) const;
+        QStringList categories() const;
+
+        // Compact (compressed binary) representation to be stored in a file
+        QByteArray serialize() const;
+        bool load(const QByteArray &data);
+
+    private:
+        struct Tier
+        {
+            int interval = 0;
+            int capacity = 0;
+            qint64 firstSlot = -1;
+            qint64 lastSlot = -1;
+            QVector<quint32> values;
+            // accumulated rates of the last slot
+            QVector<quint64> sums;
+            int samplesCount = 0;
+        };
+
+        struct Channel
+        {
+            int metricsCount = 0;
+            std::array<Tier, 3> tiers;
+        };
+
+        static Channel makeChannel(int metricsCount);
+        static void record(Channel &channel, qint64 time, const quint64 *rates);
+        static void record(Tier &tier, int metricsCount, qint64 time, const quint64 *rates);
+        static TransferHistorySeries series(const Tier &tier, int metricsCount, qint64 from);
+
+        Channel m_global;
+        QHash<QString, Channel> m_categories;
+    };
+}
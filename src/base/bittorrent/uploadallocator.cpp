@@ -0,0 +1,146 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "uploadallocator.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "base/global.h"
+#include "torrent.h"
+
+namespace
+{
+    // The part of the budget shared equally, so that torrents without demand can still upload
+    const qreal RESERVED_SHARE = 0.1;
+    const int MIN_UPLOAD_LIMIT = 1024;
+
+    struct Candidate
+    {
+        BitTorrent::UploadCandidate params;
+        qint64 limit = 0;
+    };
+}
+
+using namespace BitTorrent;
+
+QHash<TorrentID, int> UploadAllocator::allocate(const QVector<Torrent *> &torrents, const int budget)
+{
+    QVector<UploadCandidate> candidates;
+    candidates.reserve(torrents.size());
+    for (const Torrent *torrent : torrents)
+    {
+        if (torrent->isPaused() || torrent->isQueued() || !torrent->hasMetadata())
+            continue;
+
+        // Leechers of the swarms where our data is rare need it the most
+        UploadCandidate candidate {torrent->id()};
+        candidate.weight = torrent->leechsCount() / (1 + std::max<qreal>(0, torrent->distributedCopies()));
+
+        // Torrent which didn't use its previous allocation gets as much as it can use
+        const int previousLimit = m_allocations.value(candidate.torrentID);
+        const int uploadRate = torrent->uploadPayloadRate();
+        if ((previousLimit > 0) && (uploadRate < (previousLimit * 4 / 5)))
+            candidate.cap = std::max(MIN_UPLOAD_LIMIT, (uploadRate * 2));
+
+        candidates.append(candidate);
+    }
+
+    m_allocations = distribute(candidates, budget);
+    return m_allocations;
+}
+
+void UploadAllocator::reset()
+{
+    m_allocations.clear();
+}
+
+QHash<TorrentID, int> UploadAllocator::distribute(const QVector<UploadCandidate> &candidateParams, const int budget)
+{
+    QVector<Candidate> candidates;
+    candidates.reserve(candidateParams.size());
+    qreal totalWeight = 0;
+    for (const UploadCandidate &params : candidateParams)
+    {
+        totalWeight += std::max<qreal>(0, params.weight);
+        candidates.append({params, 0});
+    }
+
+    if (candidates.isEmpty() || (totalWeight <= 0))
+        return {};
+
+    const qint64 floorLimit = std::max<qint64>(MIN_UPLOAD_LIMIT, (budget * RESERVED_SHARE / candidates.size()));
+    qint64 remaining = std::max<qint64>(0, (budget - (floorLimit * candidates.size())));
+    for (Candidate &candidate : candidates)
+    {
+        candidate.limit = floorLimit;
+        candidate.params.cap = std::max(candidate.params.cap, floorLimit);
+    }
+
+    // Distribute the rest by weight, the share a torrent can't use goes to the others
+    QVector<Candidate *> unsaturated;
+    for (Candidate &candidate : candidates)
+    {
+        if (candidate.params.weight > 0)
+            unsaturated.append(&candidate);
+    }
+
+    while ((remaining > 0) && !unsaturated.isEmpty())
+    {
+        bool hasSaturated = false;
+        for (auto iter = unsaturated.begin(); iter != unsaturated.end();)
+        {
+            Candidate *candidate = *iter;
+            const auto share = static_cast<qint64>(remaining * candidate->params.weight / totalWeight);
+            if ((candidate->limit + share) < candidate->params.cap)
+            {
+                ++iter;
+                continue;
+            }
+
+            remaining -= (candidate->params.cap - candidate->limit);
+            totalWeight -= candidate->params.weight;
+            candidate->limit = candidate->params.cap;
+            iter = unsaturated.erase(iter);
+            hasSaturated = true;
+        }
+
+        if (hasSaturated)
+            continue;
+
+        for (Candidate *candidate : asConst(unsaturated))
+            candidate->limit += static_cast<qint64>(remaining * candidate->params.weight / totalWeight);
+        remaining = 0;
+    }
+
+    QHash<TorrentID, int> result;
+    result.reserve(candidates.size());
+    for (const Candidate &candidate : asConst(candidates))
+        result.insert(candidate.params.torrentID, static_cast<int>(std::min<qint64>(candidate.limit, std::numeric_limits<int>::max())));
+
+    return result;
+}
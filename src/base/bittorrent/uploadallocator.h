@@ -0,0 +1,67 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <limits>
+
+#include <QtGlobal>
+#include <QHash>
+#include <QVector>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    class Torrent;
+
+    struct UploadCandidate
+    {
+        TorrentID torrentID;
+        // share of the budget above the equal part
+        qreal weight = 0;
+        // the most the torrent can use (bytes per second)
+        qint64 cap = std::numeric_limits<int>::max();
+    };
+
+    // Splits the upload bandwidth between torrents according to the demand for their data,
+    // so that starved swarms get more of the limited upstream than over-seeded ones
+    class UploadAllocator
+    {
+    public:
+        // Returns upload limits (bytes per second) of the torrents which upload bandwidth is allocated to
+        QHash<TorrentID, int> allocate(const QVector<Torrent *> &torrents, int budget);
+        void reset();
+
+        // Gives each candidate an equal part of the budget and splits the rest by weight,
+        // the part a candidate can't use because of its cap goes to the others
+        static QHash<TorrentID, int> distribute(const QVector<UploadCandidate> &candidates, int budget);
+
+    private:
+        QHash<TorrentID, int> m_allocations;
+    };
+}
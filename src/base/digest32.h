@@ -28,15 +28,19 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+
 #include <libtorrent/sha1_hash.hpp>
 
 #include <QtGlobal>
-#include <QByteArray>
 #include <QHash>
-#include <QSharedData>
-#include <QSharedDataPointer>
 #include <QString>
 
+// Plain value type: the digest is stored inline, so creating, copying and hashing it never allocates.
+// The hex representation is computed on demand.
 template <int N>
 class Digest32
 {
@@ -44,11 +48,10 @@ public:
     using UnderlyingType = lt::digest32<N>;
 
     Digest32() = default;
-    Digest32(const Digest32 &other) = default;
-    Digest32(Digest32 &&other) = default;
 
     Digest32(const UnderlyingType &nativeDigest)
-        : m_dataPtr {new Data(nativeDigest)}
+        : m_isValid {true}
+        , m_nativeDigest {nativeDigest}
     {
     }
 
@@ -59,82 +62,78 @@ public:
 
     bool isValid() const
     {
-        return m_dataPtr->isValid();
+        return m_isValid;
     }
 
-    Digest32 &operator=(const Digest32 &other) = default;
-    Digest32 &operator=(Digest32 &&other) = default;
-
     operator UnderlyingType() const
     {
-        return m_dataPtr->nativeDigest();
+        return m_nativeDigest;
     }
 
     QString toString() const
     {
-        return m_dataPtr->hashString();
-    }
+        if (!isValid())
+            return {};
 
-    static Digest32 fromString(const QString &digestString)
-    {
-        return Digest32(QSharedDataPointer<Data>(new Data(digestString)));
-    }
+        const char hexDigits[] = "0123456789abcdef";
+        const auto *raw = reinterpret_cast<const uchar *>(m_nativeDigest.data());
 
-private:
-    class Data;
+        QString hexString {(length() * 2), Qt::Uninitialized};
+        QChar *out = hexString.data();
+        for (int i = 0; i < length(); ++i)
+        {
+            *out++ = QLatin1Char(hexDigits[raw[i] >> 4]);
+            *out++ = QLatin1Char(hexDigits[raw[i] & 0xF]);
+        }
+        return hexString;
+    }
 
-    explicit Digest32(QSharedDataPointer<Data> dataPtr)
-        : m_dataPtr {dataPtr}
+    static Digest32 fromString(const QString &digestString)
     {
-    }
+        if (digestString.size() != (length() * 2))
+            return {};
 
-    QSharedDataPointer<Data> m_dataPtr {new Data};
-};
+        std::array<char, length()> raw;
+        const QChar *in = digestString.constData();
+        for (int i = 0; i < length(); ++i)
+        {
+            const int high = hexValue(in[2 * i]);
+            const int low = hexValue(in[(2 * i) + 1]);
+            if ((high < 0) || (low < 0))
+                return {};
 
-template <int N>
-class Digest32<N>::Data : public QSharedData
-{
-public:
-    Data() = default;
+            raw[i] = static_cast<char>((high << 4) | low);
+        }
 
-    explicit Data(UnderlyingType nativeDigest)
-        : m_isValid {true}
-        , m_nativeDigest {nativeDigest}
-    {
+        UnderlyingType nativeDigest;
+        nativeDigest.assign(raw.data());
+        return nativeDigest;
     }
 
-    explicit Data(const QString &digestString)
+    std::size_t hash(const std::size_t seed = 0) const
     {
-        if (digestString.size() != (length() * 2))
-            return;
-
-        const QByteArray raw = QByteArray::fromHex(digestString.toLatin1());
-        if (raw.size() != length())  // QByteArray::fromHex() will skip over invalid characters
-            return;
-
-        m_isValid = true;
-        m_hashString = digestString;
-        m_nativeDigest.assign(raw.constData());
+        // digests are uniformly distributed already, so mixing a prefix of the digest with the seed is enough
+        quint64 prefix = 0;
+        std::memcpy(&prefix, m_nativeDigest.data(), sizeof(prefix));
+        prefix = (prefix ^ seed) * 0x9E3779B97F4A7C15;
+        return static_cast<std::size_t>(prefix ^ (prefix >> 32));
     }
 
-    bool isValid() const { return m_isValid; }
-    UnderlyingType nativeDigest() const { return m_nativeDigest; }
-
-    QString hashString() const
+private:
+    static int hexValue(const QChar c)
     {
-        if (m_hashString.isEmpty() && isValid())
-        {
-            const QByteArray raw = QByteArray::fromRawData(m_nativeDigest.data(), length());
-            m_hashString = QString::fromLatin1(raw.toHex());
-        }
-
-        return m_hashString;
+        const char16_t value = c.unicode();
+        if ((value >= u'0') && (value <= u'9'))
+            return (value - u'0');
+        if ((value >= u'a') && (value <= u'f'))
+            return (value - u'a' + 10);
+        if ((value >= u'A') && (value <= u'F'))
+            return (value - u'A' + 10);
+        return -1;
     }
 
-private:
     bool m_isValid = false;
     UnderlyingType m_nativeDigest;
-    mutable QString m_hashString;
 };
 
 template <int N>
@@ -161,12 +160,24 @@ bool operator<(const Digest32<N> &left, const Digest32<N> &right)
 template <int N>
 std::size_t qHash(const Digest32<N> &key, const std::size_t seed = 0)
 {
-    return ::qHash(static_cast<typename Digest32<N>::UnderlyingType>(key), seed);
+    return key.hash(seed);
 }
 #else
 template <int N>
 uint qHash(const Digest32<N> &key, const uint seed = 0)
 {
-    return static_cast<uint>((std::hash<typename Digest32<N>::UnderlyingType> {})(key)) ^ seed;
+    return static_cast<uint>(key.hash(seed));
 }
 #endif
+
+namespace std
+{
+    template <int N>
+    struct hash<Digest32<N>>
+    {
+        std::size_t operator()(const Digest32<N> &key) const noexcept
+        {
+            return key.hash();
+        }
+    };
+}
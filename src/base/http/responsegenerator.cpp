@@ -34,6 +34,20 @@
 #include "base/http/types.h"
 #include "base/utils/gzip.h"
 
+namespace
+{
+    int compressionLevel(const qsizetype contentSize)
+    {
+        // large responses (e.g. full sync data of big sessions) dominate the response time when compressed thoroughly,
+        // while the lower levels lose only a few percent of the ratio on such repetitive JSON
+        if (contentSize >= (4 * 1024 * 1024))
+            return 1;
+        if (contentSize >= (256 * 1024))
+            return 4;
+        return 6;
+    }
+}
+
 QByteArray Http::toByteArray(Response response)
 {
     compressContent(response);
@@ -97,7 +111,7 @@ void Http::compressContent(Response &response)
 
     // try compressing
     bool ok = false;
-    const QByteArray compressedData = Utils::Gzip::compress(response.content, 6, &ok);
+    const QByteArray compressedData = Utils::Gzip::compress(response.content, compressionLevel(contentSize), &ok);
     if (!ok)
         return;
 
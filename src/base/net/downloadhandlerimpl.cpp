@@ -29,12 +29,14 @@
 
 #include "downloadhandlerimpl.h"
 
+#include <algorithm>
+
+#include <QSaveFile>
 #include <QTemporaryFile>
+#include <QTimer>
 #include <QUrl>
 
-#include "base/3rdparty/expected.hpp"
 #include "base/utils/fs.h"
-#include "base/utils/io.h"
 #include "base/utils/misc.h"
 
 #ifdef QT_NO_COMPRESS
@@ -42,18 +44,12 @@
 #endif
 
 const int MAX_REDIRECTIONS = 20;  // the common value for web browsers
+const int MAX_RETRIES = 3;
 
 namespace
 {
-    nonstd::expected<Path, QString> saveToTempFile(const QByteArray &data)
-    {
-        QTemporaryFile file {Utils::Fs::tempPath().data()};
-        if (!file.open() || (file.write(data) != data.length()) || !file.flush())
-            return nonstd::make_unexpected(file.errorString());
-
-        file.setAutoRemove(false);
-        return Path(file.fileName());
-    }
+    const int RETRY_BASE_DELAY = 1000;  // in ms, doubled on every retry
+    const int MAX_RETRY_AFTER = 60;  // in seconds
 }
 
 Net::DownloadHandlerImpl::DownloadHandlerImpl(DownloadManager *manager
@@ -89,6 +85,8 @@ void Net::DownloadHandlerImpl::assignNetworkReply(QNetworkReply *reply)
     m_reply->setParent(this);
     if (m_downloadRequest.limit() > 0)
         connect(m_reply, &QNetworkReply::downloadProgress, this, &DownloadHandlerImpl::checkDownloadSize);
+    if (m_downloadRequest.saveToFile())
+        connect(m_reply, &QNetworkReply::readyRead, this, &DownloadHandlerImpl::writeReceivedData);
     connect(m_reply, &QNetworkReply::finished, this, &DownloadHandlerImpl::processFinishedDownload);
 }
 
@@ -112,10 +110,25 @@ void Net::DownloadHandlerImpl::processFinishedDownload()
 {
     qDebug("Download finished: %s", qUtf8Printable(url()));
 
+    // The download was aborted because of an error that is already set
+    if (m_result.status == DownloadStatus::Failed)
+    {
+        discardOutputFile();
+        finish();
+        return;
+    }
+
     // Check if the request was successful
     if (m_reply->error() != QNetworkReply::NoError)
     {
+        if (shouldRetry())
+        {
+            scheduleRetry();
+            return;
+        }
+
         // Failure
+        discardOutputFile();
         qDebug("Download failure (%s), reason: %s", qUtf8Printable(url()), qUtf8Printable(errorCodeToString(m_reply->error())));
         setError(errorCodeToString(m_reply->error()));
         finish();
@@ -132,35 +145,168 @@ void Net::DownloadHandlerImpl::processFinishedDownload()
 
     // Success
 #ifdef QT_NO_COMPRESS
-    m_result.data = (m_reply->rawHeader("Content-Encoding") == "gzip")
+    const QByteArray data = (m_reply->rawHeader("Content-Encoding") == "gzip")
                     ? Utils::Gzip::decompress(m_reply->readAll())
                     : m_reply->readAll();
 #else
-    m_result.data = m_reply->readAll();
+    const QByteArray data = m_reply->readAll();
 #endif
 
     if (m_downloadRequest.saveToFile())
+    {
+        // the rest of the data was written as it arrived
+        if (writeToOutputFile(data))
+            commitOutputFile();
+    }
+    else
+    {
+        m_result.data = data;
+    }
+
+    finish();
+}
+
+void Net::DownloadHandlerImpl::writeReceivedData()
+{
+    if (m_result.status == DownloadStatus::Failed)
+        return;
+
+    // The body of a redirection is of no use
+    if (m_reply->attribute(QNetworkRequest::RedirectionTargetAttribute).isValid())
+        return;
+
+#ifdef QT_NO_COMPRESS
+    // gzip encoded data is decompressed once it is complete
+    if (m_reply->rawHeader("Content-Encoding") == "gzip")
+        return;
+#endif
+
+    if (!writeToOutputFile(m_reply->readAll()))
+        m_reply->abort();
+}
+
+bool Net::DownloadHandlerImpl::writeToOutputFile(const QByteArray &data)
+{
+    if (!m_outputFile)
     {
         const Path destinationPath = m_downloadRequest.destFileName();
         if (destinationPath.isEmpty())
         {
-            const nonstd::expected<Path, QString> result = saveToTempFile(m_result.data);
-            if (result)
-                m_result.filePath = result.value();
-            else
-                setError(tr("I/O Error: %1").arg(result.error()));
+            auto *tempFile = new QTemporaryFile(Utils::Fs::tempPath().data(), this);
+            m_outputFile = tempFile;
+            if (!tempFile->open())
+            {
+                setError(tr("I/O Error: %1").arg(tempFile->errorString()));
+                discardOutputFile();
+                return false;
+            }
         }
         else
         {
-            const nonstd::expected<void, QString> result = Utils::IO::saveToFile(destinationPath, m_result.data);
-            if (result)
-                m_result.filePath = destinationPath;
-            else
-                setError(tr("I/O Error: %1").arg(result.error()));
+            m_outputFile = new QSaveFile(destinationPath.data(), this);
+            if (!m_outputFile->open(QIODevice::WriteOnly))
+            {
+                setError(tr("I/O Error: %1").arg(m_outputFile->errorString()));
+                discardOutputFile();
+                return false;
+            }
         }
     }
 
-    finish();
+    if (m_outputFile->write(data) != data.size())
+    {
+        setError(tr("I/O Error: %1").arg(m_outputFile->errorString()));
+        discardOutputFile();
+        return false;
+    }
+
+    return true;
+}
+
+void Net::DownloadHandlerImpl::commitOutputFile()
+{
+    Q_ASSERT(m_outputFile);
+
+    if (auto *saveFile = qobject_cast<QSaveFile *>(m_outputFile))
+    {
+        if (!saveFile->commit())
+        {
+            setError(tr("I/O Error: %1").arg(saveFile->errorString()));
+            discardOutputFile();
+            return;
+        }
+
+        m_result.filePath = m_downloadRequest.destFileName();
+    }
+    else
+    {
+        auto *tempFile = static_cast<QTemporaryFile *>(m_outputFile);
+        if (!tempFile->flush())
+        {
+            setError(tr("I/O Error: %1").arg(tempFile->errorString()));
+            discardOutputFile();
+            return;
+        }
+
+        tempFile->setAutoRemove(false);
+        m_result.filePath = Path(tempFile->fileName());
+    }
+
+    delete m_outputFile;
+    m_outputFile = nullptr;
+}
+
+// Removes the partially written file, if any
+void Net::DownloadHandlerImpl::discardOutputFile()
+{
+    delete m_outputFile;
+    m_outputFile = nullptr;
+}
+
+bool Net::DownloadHandlerImpl::shouldRetry() const
+{
+    // POST requests may have taken effect already
+    if ((m_retryCount >= MAX_RETRIES) || !m_downloadRequest.postData().isNull())
+        return false;
+
+    switch (m_reply->error())
+    {
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::ServiceUnavailableError:
+        return true;
+    default:
+        break;
+    }
+
+    // "429 Too Many Requests" is what the servers throttling the clients respond with
+    const int httpStatusCode = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    return (httpStatusCode == 429) || (httpStatusCode == 502) || (httpStatusCode == 504);
+}
+
+void Net::DownloadHandlerImpl::scheduleRetry()
+{
+    // Prefer the delay asked by the server (in seconds)
+    bool ok = false;
+    const int retryAfter = m_reply->rawHeader("Retry-After").toInt(&ok);
+    const int delay = (ok && (retryAfter >= 0))
+            ? (std::min(retryAfter, MAX_RETRY_AFTER) * 1000)
+            : (RETRY_BASE_DELAY << m_retryCount);
+    ++m_retryCount;
+    qDebug("Download failure (%s), retrying in %d ms...", qUtf8Printable(url()), delay);
+
+    discardOutputFile();
+    m_reply->deleteLater();
+    m_reply = nullptr;
+
+    // The request goes through the queue of the service again
+    QTimer::singleShot(delay, this, [this]()
+    {
+        m_manager->retry(this);
+    });
 }
 
 void Net::DownloadHandlerImpl::checkDownloadSize(const qint64 bytesReceived, const qint64 bytesTotal)
@@ -174,11 +320,11 @@ void Net::DownloadHandlerImpl::checkDownloadSize(const qint64 bytesReceived, con
 
     if ((bytesTotal > m_downloadRequest.limit()) || (bytesReceived > m_downloadRequest.limit()))
     {
-        m_reply->abort();
+        // the error is reported once the aborted reply is finished
         setError(tr("The file size (%1) exceeds the download limit (%2)")
                  .arg(Utils::Misc::friendlyUnit(bytesTotal)
                       , Utils::Misc::friendlyUnit(m_downloadRequest.limit())));
-        finish();
+        m_reply->abort();
     }
 }
 
@@ -33,6 +33,7 @@
 
 #include "base/net/downloadmanager.h"
 
+class QFileDevice;
 class QObject;
 class QUrl;
 
@@ -57,6 +58,12 @@ namespace Net
     private:
         void processFinishedDownload();
         void checkDownloadSize(qint64 bytesReceived, qint64 bytesTotal);
+        void writeReceivedData();
+        bool writeToOutputFile(const QByteArray &data);
+        void commitOutputFile();
+        void discardOutputFile();
+        bool shouldRetry() const;
+        void scheduleRetry();
         void handleRedirection(const QUrl &newUrl);
         void setError(const QString &error);
         void finish();
@@ -65,9 +72,12 @@ namespace Net
 
         DownloadManager *m_manager = nullptr;
         QNetworkReply *m_reply = nullptr;
+        // the data is written to the file as it arrives when saveToFile is set
+        QFileDevice *m_outputFile = nullptr;
         const DownloadRequest m_downloadRequest;
         const bool m_useProxy = false;
         short m_redirectionCount = 0;
+        short m_retryCount = 0;
         DownloadResult m_result;
     };
 }
@@ -48,10 +48,16 @@
 #include "downloadhandlerimpl.h"
 #include "proxyconfigurationmanager.h"
 
+#define SETTINGS_KEY(name) (u"Network/DownloadManager/" name)
+
 namespace
 {
     // Disguise as Firefox to avoid web server banning
     const char DEFAULT_USER_AGENT[] = "Mozilla/5.0 (X11; Linux x86_64; rv:68.0) Gecko/20100101 Firefox/68.0";
+
+    // QNetworkAccessManager opens at most 6 connections per host and queues the rest internally,
+    // so the requests beyond that are kept in our own queue instead
+    const int MAX_CONNECTIONS_PER_HOST = 6;
 }
 
 class Net::DownloadManager::NetworkCookieJar final : public QNetworkCookieJar
@@ -120,6 +126,9 @@ Net::DownloadManager::DownloadManager(QObject *parent)
     : QObject(parent)
     , m_networkCookieJar {new NetworkCookieJar(this)}
     , m_networkManager {new QNetworkAccessManager(this)}
+    , m_maxRequests {SETTINGS_KEY(u"MaxRequests"_qs), 32, [](const int value) { return std::max(1, value); }}
+    , m_maxRequestsPerHost {SETTINGS_KEY(u"MaxRequestsPerHost"_qs), 4
+            , [](const int value) { return std::clamp(value, 1, MAX_CONNECTIONS_PER_HOST); }}
 {
     m_networkManager->setCookieJar(m_networkCookieJar);
     connect(m_networkManager, &QNetworkAccessManager::sslErrors, this, &Net::DownloadManager::ignoreSslErrors);
@@ -149,34 +158,24 @@ Net::DownloadManager *Net::DownloadManager::instance()
 
 Net::DownloadHandler *Net::DownloadManager::download(const DownloadRequest &downloadRequest, const bool useProxy)
 {
-    // Process download request
     const ServiceID id = ServiceID::fromURL(downloadRequest.url());
-    const bool isSequentialService = m_sequentialServices.contains(id);
 
     auto downloadHandler = new DownloadHandlerImpl(this, downloadRequest, useProxy);
-    connect(downloadHandler, &DownloadHandler::finished, this
-            , [this, downloadHandler]
-    {
-        handleDownloadFinished(downloadHandler);
-    });
     connect(downloadHandler, &DownloadHandler::finished, downloadHandler, &QObject::deleteLater);
     connect(downloadHandler, &QObject::destroyed, this, [this, id, downloadHandler]()
     {
-        m_waitingJobs[id].removeOne(downloadHandler);
-    });
+        const auto waitingJobsIter = m_waitingJobs.find(id);
+        if ((waitingJobsIter == m_waitingJobs.end()) || !waitingJobsIter.value().removeOne(downloadHandler))
+            return;
 
-    if (isSequentialService && m_busyServices.contains(id))
-    {
-        m_waitingJobs[id].enqueue(downloadHandler);
-    }
-    else
-    {
-        qDebug("Downloading %s...", qUtf8Printable(downloadRequest.url()));
-        if (isSequentialService)
-            m_busyServices.insert(id);
-        processRequest(downloadHandler);
-    }
+        if (waitingJobsIter.value().isEmpty())
+        {
+            m_waitingJobs.erase(waitingJobsIter);
+            m_waitingServices.removeOne(id);
+        }
+    });
 
+    enqueue(downloadHandler);
     return downloadHandler;
 }
 
@@ -185,6 +184,14 @@ void Net::DownloadManager::registerSequentialService(const Net::ServiceID &servi
     m_sequentialServices.insert(serviceID);
 }
 
+QHash<Net::ServiceID, Net::ServiceStatistics> Net::DownloadManager::serviceStatistics() const
+{
+    QHash<ServiceID, ServiceStatistics> statistics = m_statistics;
+    for (auto it = m_waitingJobs.cbegin(); it != m_waitingJobs.cend(); ++it)
+        statistics[it.key()].queuedRequests = it.value().size();
+    return statistics;
+}
+
 QList<QNetworkCookie> Net::DownloadManager::cookiesForUrl(const QUrl &url) const
 {
     return m_networkCookieJar->cookiesForUrl(url);
@@ -258,29 +265,66 @@ void Net::DownloadManager::applyProxySettings()
     }
 }
 
-void Net::DownloadManager::handleDownloadFinished(DownloadHandlerImpl *finishedHandler)
+int Net::DownloadManager::maxActiveRequests(const ServiceID &serviceID) const
 {
-    // QNetworkReply::url() may be different from that of the original request
-    // so we need QNetworkRequest::url() to properly process Sequential Services
-    // in the case when the redirection occurred.
-    const ServiceID id = ServiceID::fromURL(finishedHandler->url());
-    const auto waitingJobsIter = m_waitingJobs.find(id);
-    if ((waitingJobsIter == m_waitingJobs.end()) || waitingJobsIter.value().isEmpty())
+    return m_sequentialServices.contains(serviceID) ? 1 : m_maxRequestsPerHost.get();
+}
+
+void Net::DownloadManager::enqueue(DownloadHandlerImpl *downloadHandler)
+{
+    const ServiceID id = ServiceID::fromURL(downloadHandler->url());
+    QQueue<DownloadHandlerImpl *> &waitingJobs = m_waitingJobs[id];
+    if (waitingJobs.isEmpty())
+        m_waitingServices.enqueue(id);
+    waitingJobs.enqueue(downloadHandler);
+
+    processWaitingJobs();
+}
+
+void Net::DownloadManager::retry(DownloadHandlerImpl *downloadHandler)
+{
+    ++m_statistics[ServiceID::fromURL(downloadHandler->url())].retriedRequests;
+    enqueue(downloadHandler);
+}
+
+void Net::DownloadManager::processWaitingJobs()
+{
+    // Services take turns starting one job at a time,
+    // so that a long queue of one host doesn't hold up the others
+    bool isStarted = true;
+    while (isStarted && (m_activeRequests < m_maxRequests))
     {
-        // No more waiting jobs for given ServiceID
-        m_busyServices.remove(id);
-        return;
+        isStarted = false;
+        for (int i = m_waitingServices.size(); (i > 0) && (m_activeRequests < m_maxRequests); --i)
+        {
+            const ServiceID id = m_waitingServices.dequeue();
+            const auto waitingJobsIter = m_waitingJobs.find(id);
+            Q_ASSERT(waitingJobsIter != m_waitingJobs.end());
+
+            DownloadHandlerImpl *handler = (m_statistics.value(id).activeRequests < maxActiveRequests(id))
+                    ? waitingJobsIter.value().dequeue() : nullptr;
+            if (waitingJobsIter.value().isEmpty())
+                m_waitingJobs.erase(waitingJobsIter);
+            else
+                m_waitingServices.enqueue(id);
+
+            if (handler)
+            {
+                processRequest(handler);
+                isStarted = true;
+            }
+        }
     }
-
-    auto handler = waitingJobsIter.value().dequeue();
-    qDebug("Downloading %s...", qUtf8Printable(handler->url()));
-    processRequest(handler);
-    handler->disconnect(this);
 }
 
 void Net::DownloadManager::processRequest(DownloadHandlerImpl *downloadHandler)
 {
-    m_networkManager->setProxy((downloadHandler->useProxy() == true) ? m_proxy : QNetworkProxy(QNetworkProxy::NoProxy));
+    qDebug("Downloading %s...", qUtf8Printable(downloadHandler->url()));
+
+    // The proxy is shared by all the requests, so change it only when needed
+    const QNetworkProxy proxy = downloadHandler->useProxy() ? m_proxy : QNetworkProxy(QNetworkProxy::NoProxy);
+    if (m_networkManager->proxy() != proxy)
+        m_networkManager->setProxy(proxy);
 
     const DownloadRequest downloadRequest = downloadHandler->downloadRequest();
     QNetworkRequest request {downloadRequest.url()};
@@ -300,8 +344,50 @@ void Net::DownloadManager::processRequest(DownloadHandlerImpl *downloadHandler)
 #endif
     // Qt doesn't support Magnet protocol so we need to handle redirections manually
     request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
+#if (QT_VERSION < QT_VERSION_CHECK(6, 0, 0))
+    // Let the requests to the same HTTPS host share a single connection (it is the default in Qt 6)
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+#endif
+
+    QNetworkReply *reply = nullptr;
+    if (downloadRequest.postData().isNull())
+    {
+        reply = m_networkManager->get(request);
+    }
+    else
+    {
+        if (!downloadRequest.contentType().isEmpty())
+            request.setHeader(QNetworkRequest::ContentTypeHeader, downloadRequest.contentType());
+        reply = m_networkManager->post(request, downloadRequest.postData());
+    }
+
+    // The slot is released as soon as the reply is finished rather than when the handler is,
+    // since the handler may be waiting for a redirection to the same service.
+    // QNetworkReply::url() may be different from that of the original request
+    // so we need the URL of the handler to identify the service in the case when the redirection occurred.
+    const ServiceID id = ServiceID::fromURL(downloadHandler->url());
+    ++m_activeRequests;
+    ++m_statistics[id].activeRequests;
+    connect(reply, &QNetworkReply::downloadProgress, this
+            , [this, id, lastBytesReceived = qint64 {0}](const qint64 bytesReceived) mutable
+    {
+        m_statistics[id].bytesReceived += (bytesReceived - lastBytesReceived);
+        lastBytesReceived = bytesReceived;
+    });
+    connect(reply, &QNetworkReply::finished, this, [this, id, reply]()
+    {
+        ServiceStatistics &statistics = m_statistics[id];
+        --statistics.activeRequests;
+        if (reply->error() == QNetworkReply::NoError)
+            ++statistics.finishedRequests;
+        else
+            ++statistics.failedRequests;
+        --m_activeRequests;
+
+        processWaitingJobs();
+    });
 
-    downloadHandler->assignNetworkReply(m_networkManager->get(request));
+    downloadHandler->assignNetworkReply(reply);
 }
 
 void Net::DownloadManager::ignoreSslErrors(QNetworkReply *reply, const QList<QSslError> &errors)
@@ -375,6 +461,28 @@ Net::DownloadRequest &Net::DownloadRequest::destFileName(const Path &value)
     return *this;
 }
 
+QByteArray Net::DownloadRequest::postData() const
+{
+    return m_postData;
+}
+
+Net::DownloadRequest &Net::DownloadRequest::postData(const QByteArray &value)
+{
+    m_postData = value;
+    return *this;
+}
+
+QString Net::DownloadRequest::contentType() const
+{
+    return m_contentType;
+}
+
+Net::DownloadRequest &Net::DownloadRequest::contentType(const QString &value)
+{
+    m_contentType = value;
+    return *this;
+}
+
 Net::ServiceID Net::ServiceID::fromURL(const QUrl &url)
 {
     return {url.host(), url.port(80)};
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <QtGlobal>
+#include <QByteArray>
 #include <QHash>
 #include <QNetworkProxy>
 #include <QObject>
@@ -37,6 +38,7 @@
 #include <QSet>
 
 #include "base/path.h"
+#include "base/settingvalue.h"
 
 class QNetworkAccessManager;
 class QNetworkCookie;
@@ -92,12 +94,21 @@ namespace Net
         Path destFileName() const;
         DownloadRequest &destFileName(const Path &value);
 
+        // if postData is set, the request is sent using POST method
+        QByteArray postData() const;
+        DownloadRequest &postData(const QByteArray &value);
+
+        QString contentType() const;
+        DownloadRequest &contentType(const QString &value);
+
     private:
         QString m_url;
         QString m_userAgent;
         qint64 m_limit = 0;
         bool m_saveToFile = false;
         Path m_destFileName;
+        QByteArray m_postData;
+        QString m_contentType;
     };
 
     struct DownloadResult
@@ -110,6 +121,16 @@ namespace Net
         QString magnet;
     };
 
+    struct ServiceStatistics
+    {
+        int activeRequests = 0;
+        int queuedRequests = 0;
+        qint64 finishedRequests = 0;
+        qint64 failedRequests = 0;
+        qint64 retriedRequests = 0;
+        qint64 bytesReceived = 0;
+    };
+
     class DownloadHandler : public QObject
     {
         Q_OBJECT
@@ -142,6 +163,7 @@ namespace Net
         void download(const DownloadRequest &downloadRequest, bool useProxy, Context context, Func &&slot);
 
         void registerSequentialService(const ServiceID &serviceID);
+        QHash<ServiceID, ServiceStatistics> serviceStatistics() const;
 
         QList<QNetworkCookie> cookiesForUrl(const QUrl &url) const;
         bool setCookiesFromUrl(const QList<QNetworkCookie> &cookieList, const QUrl &url);
@@ -155,12 +177,16 @@ namespace Net
         void ignoreSslErrors(QNetworkReply *, const QList<QSslError> &);
 
     private:
+        friend class DownloadHandlerImpl;
         class NetworkCookieJar;
 
         explicit DownloadManager(QObject *parent = nullptr);
 
         void applyProxySettings();
-        void handleDownloadFinished(DownloadHandlerImpl *finishedHandler);
+        int maxActiveRequests(const ServiceID &serviceID) const;
+        void enqueue(DownloadHandlerImpl *downloadHandler);
+        void retry(DownloadHandlerImpl *downloadHandler);
+        void processWaitingJobs();
         void processRequest(DownloadHandlerImpl *downloadHandler);
 
         static DownloadManager *m_instance;
@@ -168,9 +194,15 @@ namespace Net
         QNetworkAccessManager *m_networkManager = nullptr;
         QNetworkProxy m_proxy;
 
+        CachedSettingValue<int> m_maxRequests;
+        CachedSettingValue<int> m_maxRequestsPerHost;
+        int m_activeRequests = 0;
+
         QSet<ServiceID> m_sequentialServices;
-        QSet<ServiceID> m_busyServices;
+        QHash<ServiceID, ServiceStatistics> m_statistics;
         QHash<ServiceID, QQueue<DownloadHandlerImpl *>> m_waitingJobs;
+        // services with waiting jobs, in the order they get their turn
+        QQueue<ServiceID> m_waitingServices;
     };
 
     template <typename Context, typename Func>
@@ -83,6 +83,7 @@ public:
     static void addRootFolder(PathList &filePaths, const Path &rootFolder);
 
     friend Path operator/(const Path &lhs, const Path &rhs);
+    friend class StringPool;
 
 private:
     // this constructor doesn't perform any checks
@@ -32,6 +32,7 @@
 #include <chrono>
 #include <memory>
 
+#include <QDataStream>
 #include <QFile>
 #include <QHash>
 
@@ -43,11 +44,29 @@
 
 using namespace std::chrono_literals;
 
+namespace
+{
+    const quint32 JOURNAL_MAGIC = 0x71624A4E;  // "qbJN"
+    const quint32 JOURNAL_VERSION = 1;
+    const QDataStream::Version JOURNAL_STREAM_VERSION = QDataStream::Qt_5_15;
+    // the configuration file is rewritten (and the journal discarded) once the journal exceeds this size
+    const qint64 MAX_JOURNAL_SIZE = 1024 * 1024;
+
+    enum class JournalOperation : quint8
+    {
+        Store = 1,
+        Remove = 2
+    };
+}
+
 SettingsStorage *SettingsStorage::m_instance = nullptr;
 
 SettingsStorage::SettingsStorage()
     : m_nativeSettingsName {u"qBittorrent"_qs}
 {
+    const Path settingsPath {Profile::instance()->applicationSettings(m_nativeSettingsName)->fileName()};
+    m_journalPath = settingsPath.removedExtension() + u".journal";
+
     readNativeSettings();
 
     m_timer.setSingleShot(true);
@@ -57,7 +76,15 @@ SettingsStorage::SettingsStorage()
 
 SettingsStorage::~SettingsStorage()
 {
-    save();
+    // fold the journal into the configuration file so it is up to date while the program isn't running
+    const QWriteLocker locker(&m_lock);
+    if (m_dirtyKeys.isEmpty() && (m_journalSize == 0))
+        return;
+
+    if (writeNativeSettings())
+        m_dirtyKeys.clear();
+    else if (!m_dirtyKeys.isEmpty())
+        writeJournal();
 }
 
 void SettingsStorage::initInstance()
@@ -79,16 +106,17 @@ SettingsStorage *SettingsStorage::instance()
 
 bool SettingsStorage::save()
 {
-    const QWriteLocker locker(&m_lock);  // guard for `m_dirty` too
-    if (!m_dirty) return true;
+    const QWriteLocker locker(&m_lock);  // guard for `m_dirtyKeys` too
+    if (m_dirtyKeys.isEmpty()) return true;
 
-    if (!writeNativeSettings())
+    const bool isJournalWritten = (m_journalSize < MAX_JOURNAL_SIZE) && writeJournal();
+    if (!isJournalWritten && !writeNativeSettings())
     {
         m_timer.start();
         return false;
     }
 
-    m_dirty = false;
+    m_dirtyKeys.clear();
     return true;
 }
 
@@ -104,7 +132,7 @@ void SettingsStorage::storeValueImpl(const QString &key, const QVariant &value)
     QVariant &currentValue = m_data[key];
     if (currentValue != value)
     {
-        m_dirty = true;
+        m_dirtyKeys.insert(key);
         currentValue = value;
         m_timer.start();
     }
@@ -157,10 +185,23 @@ void SettingsStorage::readNativeSettings()
     {
         deserialize(m_data, m_nativeSettingsName);
     }
+
+    // The journal is kept until "_new" file replaces the configuration file and it is never behind it,
+    // so the journal left over can be replayed on top of either of them
+    readJournal();
 }
 
-bool SettingsStorage::writeNativeSettings() const
+bool SettingsStorage::writeNativeSettings()
 {
+    // The journal is replayed on top of the configuration file if the program exits before it is removed,
+    // so it must contain the pending changes too. If it can't be updated it is dropped instead.
+    if ((m_journalSize > 0) && !m_dirtyKeys.isEmpty() && !writeJournal())
+    {
+        if (!Utils::Fs::removeFile(m_journalPath))
+            return false;
+        m_journalSize = 0;
+    }
+
     std::unique_ptr<QSettings> nativeSettings = Profile::instance()->applicationSettings(m_nativeSettingsName + u"_new");
 
     // QSettings deletes the file before writing it out. This can result in problems
@@ -168,6 +209,8 @@ bool SettingsStorage::writeNativeSettings() const
     // between deleting the file and recreating it. This is a safety measure.
     // Write everything to qBittorrent_new.ini/qBittorrent_new.conf and if it succeeds
     // replace qBittorrent.ini/qBittorrent.conf with it.
+    // "_new" file may be left over by a failed attempt, so it is written from scratch.
+    nativeSettings->clear();
     for (auto i = m_data.begin(); i != m_data.end(); ++i)
         nativeSettings->setValue(i.key(), i.value());
 
@@ -204,7 +247,138 @@ bool SettingsStorage::writeNativeSettings() const
 
     const Path finalPath {finalPathStr};
     Utils::Fs::removeFile(finalPath);
-    return Utils::Fs::renameFile(newPath, finalPath);
+    if (!Utils::Fs::renameFile(newPath, finalPath))
+    {
+        // "_new" file is restored on the next start, the journal is replayed on top of it
+        LogMsg(tr("Failed to replace the configuration file. File: \"%1\"").arg(finalPath.toString()), Log::WARNING);
+        return false;
+    }
+
+    // the configuration file contains everything the journal does now
+    Utils::Fs::removeFile(m_journalPath);
+    m_journalSize = 0;
+    return true;
+}
+
+void SettingsStorage::readJournal()
+{
+    QFile journalFile {m_journalPath.data()};
+    if (!journalFile.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream in {&journalFile};
+    in.setVersion(JOURNAL_STREAM_VERSION);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if ((in.status() != QDataStream::Ok) || (magic != JOURNAL_MAGIC) || (version != JOURNAL_VERSION))
+    {
+        LogMsg(tr("Ignoring invalid settings journal: %1").arg(m_journalPath.toString()), Log::WARNING);
+        journalFile.close();
+        Utils::Fs::removeFile(m_journalPath);
+        return;
+    }
+
+    // Every save appends one batch of records. A batch is applied only when it was read completely,
+    // so a batch cut short by a crash or a full disk is dropped as a whole.
+    qint64 validSize = journalFile.pos();
+    while (!in.atEnd())
+    {
+        quint32 recordCount = 0;
+        in >> recordCount;
+
+        // keys are unique within a batch
+        QVariantHash storedValues;
+        QStringList removedKeys;
+        for (quint32 i = 0; (i < recordCount) && (in.status() == QDataStream::Ok); ++i)
+        {
+            quint8 operation = 0;
+            QString key;
+            in >> operation >> key;
+            if (static_cast<JournalOperation>(operation) == JournalOperation::Store)
+            {
+                QVariant value;
+                in >> value;
+                storedValues[key] = value;
+            }
+            else if (static_cast<JournalOperation>(operation) == JournalOperation::Remove)
+            {
+                removedKeys.append(key);
+            }
+            else
+            {
+                in.setStatus(QDataStream::ReadCorruptData);
+            }
+        }
+
+        if (in.status() != QDataStream::Ok)
+        {
+            LogMsg(tr("Settings journal is truncated, discarding its incomplete tail. File: %1")
+                .arg(m_journalPath.toString()), Log::WARNING);
+            break;
+        }
+
+        for (auto iter = storedValues.cbegin(); iter != storedValues.cend(); ++iter)
+            m_data[iter.key()] = iter.value();
+        for (const QString &key : asConst(removedKeys))
+            m_data.remove(key);
+
+        validSize = journalFile.pos();
+    }
+
+    journalFile.close();
+    // drop the incomplete tail so later batches aren't appended after garbage
+    if (validSize < journalFile.size())
+        journalFile.resize(validSize);
+    m_journalSize = validSize;
+}
+
+bool SettingsStorage::writeJournal()
+{
+    QByteArray batch;
+    QDataStream out {&batch, QIODevice::WriteOnly};
+    out.setVersion(JOURNAL_STREAM_VERSION);
+
+    if (m_journalSize == 0)
+        out << JOURNAL_MAGIC << JOURNAL_VERSION;
+
+    out << static_cast<quint32>(m_dirtyKeys.size());
+    for (const QString &key : asConst(m_dirtyKeys))
+    {
+        const auto iter = m_data.constFind(key);
+        if (iter != m_data.cend())
+            out << static_cast<quint8>(JournalOperation::Store) << key << iter.value();
+        else
+            out << static_cast<quint8>(JournalOperation::Remove) << key;
+    }
+
+    if (out.status() != QDataStream::Ok)
+        return false;
+
+    QFile journalFile {m_journalPath.data()};
+    const QIODevice::OpenMode openMode = (m_journalSize == 0)
+        ? (QIODevice::WriteOnly | QIODevice::Truncate)
+        : (QIODevice::WriteOnly | QIODevice::Append);
+    if (!journalFile.open(openMode))
+    {
+        LogMsg(tr("Failed to open settings journal for writing. File: \"%1\". Error: \"%2\"")
+            .arg(m_journalPath.toString(), journalFile.errorString()), Log::WARNING);
+        return false;
+    }
+
+    if ((journalFile.write(batch) != batch.size()) || !journalFile.flush())
+    {
+        LogMsg(tr("Failed to write settings journal. File: \"%1\". Error: \"%2\"")
+            .arg(m_journalPath.toString(), journalFile.errorString()), Log::WARNING);
+        // don't leave a partial batch behind, the configuration file is going to be rewritten instead
+        journalFile.close();
+        journalFile.resize(m_journalSize);
+        return false;
+    }
+
+    m_journalSize += batch.size();
+    return true;
 }
 
 void SettingsStorage::removeValue(const QString &key)
@@ -216,7 +390,7 @@ void SettingsStorage::removeValue(const QString &key)
     if (m_data.remove(key) > 0)
 #endif
     {
-        m_dirty = true;
+        m_dirtyKeys.insert(key);
         m_timer.start();
     }
 }
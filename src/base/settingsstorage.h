@@ -33,11 +33,13 @@
 
 #include <QObject>
 #include <QReadWriteLock>
+#include <QSet>
 #include <QTimer>
 #include <QVariant>
 #include <QVariantHash>
 
 #include "base/interfaces/istringable.h"
+#include "base/path.h"
 #include "utils/string.h"
 
 template <typename T>
@@ -50,6 +52,10 @@ struct IsQFlags<QFlags<T>> : std::true_type {};
 // 1. If the `T` state is intended for users to edit (via a text editor), then
 //    implement `IStringable` interface
 // 2. Otherwise, use `Q_DECLARE_METATYPE(T)` and let `QMetaType` handle the serialization
+//
+// Changes are saved by appending the changed keys to a binary journal next to the configuration file,
+// the configuration file itself is only rewritten when the journal grows too large and on exit.
+// Values that are read frequently should be kept in a `CachedSettingValue` instead of being loaded every time.
 class SettingsStorage final : public QObject
 {
     Q_OBJECT
@@ -117,12 +123,16 @@ private:
     QVariant loadValueImpl(const QString &key, const QVariant &defaultValue = {}) const;
     void storeValueImpl(const QString &key, const QVariant &value);
     void readNativeSettings();
-    bool writeNativeSettings() const;
+    bool writeNativeSettings();
+    void readJournal();
+    bool writeJournal();
 
     static SettingsStorage *m_instance;
 
     const QString m_nativeSettingsName;
-    bool m_dirty = false;
+    Path m_journalPath;
+    qint64 m_journalSize = 0;
+    QSet<QString> m_dirtyKeys;
     QVariantHash m_data;
     QTimer m_timer;
     mutable QReadWriteLock m_lock;
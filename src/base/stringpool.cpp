@@ -0,0 +1,76 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "stringpool.h"
+
+#include "base/algorithm.h"
+
+QString StringPool::intern(const QString &str)
+{
+    if (str.isEmpty())
+        return {};
+
+    const auto iter = m_strings.constFind(str);
+    if (iter != m_strings.cend())
+        return *iter;
+
+    return *m_strings.insert(str);
+}
+
+Path StringPool::intern(const Path &path)
+{
+    if (path.isEmpty())
+        return {};
+
+    const auto iter = m_paths.constFind(path);
+    if (iter != m_paths.cend())
+        return *iter;
+
+    return *m_paths.insert(path);
+}
+
+void StringPool::squeeze()
+{
+    Algorithm::removeIf(m_strings, [](const QString &str) { return str.isDetached(); });
+    Algorithm::removeIf(m_paths, [](const Path &path) { return path.m_pathStr.isDetached(); });
+}
+
+qsizetype StringPool::count() const
+{
+    return m_strings.size() + m_paths.size();
+}
+
+qint64 StringPool::memoryUsage() const
+{
+    qint64 result = 0;
+    for (const QString &str : m_strings)
+        result += str.capacity() * sizeof(QChar);
+    for (const Path &path : m_paths)
+        result += path.m_pathStr.capacity() * sizeof(QChar);
+    return result;
+}
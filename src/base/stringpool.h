@@ -0,0 +1,55 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QSet>
+#include <QString>
+
+#include "base/path.h"
+
+// Keeps a single shared instance of each distinct value, so that values repeated
+// across many torrents (save paths, categories, tracker URLs) share their storage.
+// Interned values are implicitly shared with the pool, so comparing two equal
+// interned values doesn't need to look at their contents.
+class StringPool
+{
+public:
+    QString intern(const QString &str);
+    Path intern(const Path &path);
+
+    // Drops the values that are no longer referenced outside of the pool
+    void squeeze();
+
+    qsizetype count() const;
+    qint64 memoryUsage() const;
+
+private:
+    QSet<QString> m_strings;
+    QSet<Path> m_paths;
+};
@@ -0,0 +1,133 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "tagindex.h"
+
+#include <algorithm>
+
+int TagIndex::indexOf(const QString &tag) const
+{
+    return m_indexes.value(tag, -1);
+}
+
+bool TagIndex::contains(const QString &tag) const
+{
+    return m_indexes.contains(tag);
+}
+
+int TagIndex::insert(const QString &tag)
+{
+    if (const auto iter = m_indexes.constFind(tag); iter != m_indexes.cend())
+        return iter.value();
+
+    int index = 0;
+    if (m_freeIndexes.isEmpty())
+    {
+        index = m_tags.size();
+        m_tags.append(tag);
+    }
+    else
+    {
+        index = m_freeIndexes.takeLast();
+        m_tags[index] = tag;
+    }
+
+    m_indexes.insert(tag, index);
+    m_tagSet.insert(tag);
+
+    const auto pos = std::lower_bound(m_orderedIndexes.begin(), m_orderedIndexes.end(), tag
+            , [this](const int left, const QString &right) { return TagLessThan()(m_tags.at(left), right); });
+    m_orderedIndexes.insert(pos, index);
+
+    return index;
+}
+
+int TagIndex::remove(const QString &tag)
+{
+    const auto iter = m_indexes.find(tag);
+    if (iter == m_indexes.end())
+        return -1;
+
+    const int index = iter.value();
+    m_indexes.erase(iter);
+    m_tagSet.remove(tag);
+
+    m_orderedIndexes.removeOne(index);
+    m_tags[index].clear();
+    m_freeIndexes.append(index);
+    return index;
+}
+
+QString TagIndex::tag(const int index) const
+{
+    return m_tags.value(index);
+}
+
+const QSet<QString> &TagIndex::tags() const
+{
+    return m_tagSet;
+}
+
+QStringList TagIndex::tagList() const
+{
+    QStringList result;
+    result.reserve(m_orderedIndexes.size());
+    for (const int index : m_orderedIndexes)
+        result.append(m_tags.at(index));
+    return result;
+}
+
+int TagIndex::count() const
+{
+    return m_indexes.size();
+}
+
+int TagIndex::capacity() const
+{
+    return m_tags.size();
+}
+
+TagSet TagIndex::toTagSet(const QBitArray &bits) const
+{
+    int remaining = bits.count(true);
+    if (remaining == 0)
+        return {};
+
+    TagSet result;
+    for (const int index : m_orderedIndexes)
+    {
+        if ((index >= bits.size()) || !bits.testBit(index))
+            continue;
+
+        result.insert(result.end(), m_tags.at(index));
+        if (--remaining == 0)
+            break;
+    }
+
+    return result;
+}
@@ -28,8 +28,12 @@
 
 #include "torrentfilter.h"
 
+#include <QBitArray>
+
 #include "bittorrent/infohash.h"
+#include "bittorrent/session.h"
 #include "bittorrent/torrent.h"
+#include "tagindex.h"
 
 const std::optional<QString> TorrentFilter::AnyCategory;
 const std::optional<TorrentIDSet> TorrentFilter::AnyID;
@@ -142,6 +146,7 @@ bool TorrentFilter::setTag(const std::optional<QString> &tag)
     if (m_tag != tag)
     {
         m_tag = tag;
+        m_tagIndex = -1;
         return true;
     }
 
@@ -215,9 +220,14 @@ bool TorrentFilter::matchTag(const BitTorrent::Torrent *const torrent) const
     if (!m_tag)
         return true;
 
+    const QBitArray &tagBits = torrent->tagBits();
     // Empty tag is a special value to indicate we're filtering for untagged torrents.
     if (m_tag->isEmpty())
-        return torrent->tags().isEmpty();
+        return (tagBits.count(true) == 0);
+
+    const TagIndex &tagIndex = BitTorrent::Session::instance()->tagIndex();
+    if ((m_tagIndex < 0) || (tagIndex.tag(m_tagIndex) != *m_tag))
+        m_tagIndex = tagIndex.indexOf(*m_tag);
 
-    return torrent->hasTag(*m_tag);
+    return (m_tagIndex >= 0) && (m_tagIndex < tagBits.size()) && tagBits.testBit(m_tagIndex);
 }
@@ -106,5 +106,7 @@ private:
     Type m_type {All};
     std::optional<QString> m_category;
     std::optional<QString> m_tag;
+    // index of m_tag in the session TagIndex, it is checked on use since indexes of removed tags get reused
+    mutable int m_tagIndex = -1;
     std::optional<TorrentIDSet> m_idSet;
 };
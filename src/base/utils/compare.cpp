@@ -28,10 +28,37 @@
 
 #include "compare.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include <QChar>
 #include <QString>
 
-#ifndef QBT_USE_QCOLLATOR
+#ifdef QBT_USE_QCOLLATOR
+Utils::Compare::NaturalSortKey::NaturalSortKey(const QCollatorSortKey &key)
+    : m_key {key}
+{
+}
+
+int Utils::Compare::NaturalSortKey::compare(const NaturalSortKey &other) const
+{
+    if (!m_key || !other.m_key)
+        return (int {m_key.has_value()} - int {other.m_key.has_value()});
+    return m_key->compare(*other.m_key);
+}
+#else
+Utils::Compare::NaturalSortKey::NaturalSortKey(const QByteArray &key)
+    : m_key {key}
+{
+}
+
+int Utils::Compare::NaturalSortKey::compare(const NaturalSortKey &other) const
+{
+    const int commonSize = std::min(m_key.size(), other.m_key.size());
+    const int result = (commonSize > 0) ? std::memcmp(m_key.constData(), other.m_key.constData(), commonSize) : 0;
+    return (result != 0) ? result : (m_key.size() - other.m_key.size());
+}
+
 int Utils::Compare::naturalCompare(const QString &left, const QString &right, const Qt::CaseSensitivity caseSensitivity)
 {
     // Return value <0: `left` is smaller than `right`
@@ -93,4 +120,46 @@ int Utils::Compare::naturalCompare(const QString &left, const QString &right, co
         }
     }
 }
+
+Utils::Compare::NaturalSortKey Utils::Compare::naturalSortKey(const QString &str, const Qt::CaseSensitivity caseSensitivity)
+{
+    // The key is built so that comparing two keys bytewise yields the same order as naturalCompare():
+    // every non-digit character is stored as its big-endian UTF-16 code unit,
+    // every run of digits is stored as the zero digit of its script, then the run length and then the digits,
+    // so that numbers are ordered by their length first and digits are ordered the same way against other characters.
+
+    QByteArray key;
+    key.reserve(str.size() * 2);
+
+    const auto appendUInt16 = [&key](const ushort value)
+    {
+        key.append(static_cast<char>(value >> 8));
+        key.append(static_cast<char>(value & 0xFF));
+    };
+
+    int pos = 0;
+    while (pos < str.size())
+    {
+        const QChar c = str[pos];
+        if (!c.isDigit())
+        {
+            appendUInt16(((caseSensitivity == Qt::CaseSensitive) ? c : c.toLower()).unicode());
+            ++pos;
+            continue;
+        }
+
+        const int start = pos;
+        while ((pos < str.size()) && str[pos].isDigit())
+            ++pos;
+
+        const auto length = static_cast<quint32>(pos - start);
+        appendUInt16(c.unicode() - c.digitValue());
+        appendUInt16(length >> 16);
+        appendUInt16(length & 0xFFFF);
+        for (int i = start; i < pos; ++i)
+            appendUInt16(str[i].unicode());
+    }
+
+    return NaturalSortKey(key);
+}
 #endif
@@ -29,17 +29,51 @@
 #pragma once
 
 #include <Qt>
+#include <QMetaType>
 #include <QtGlobal>
 
+#include <optional>
+
 #if !defined(Q_OS_WIN) && (!defined(Q_OS_UNIX) || defined(Q_OS_MACOS) || defined(QT_FEATURE_icu))
 #define QBT_USE_QCOLLATOR
 #include <QCollator>
+#else
+#include <QByteArray>
 #endif
 
 class QString;
 
 namespace Utils::Compare
 {
+    // Precomputed representation of a string which compares in the same order as NaturalCompare
+    // compares the strings themselves. Intended for sorting and for caching alongside the string,
+    // so that the (relatively expensive) collation work is done once per string instead of once per comparison.
+    // A default constructed key is ordered before any other key.
+    class NaturalSortKey
+    {
+    public:
+        NaturalSortKey() = default;
+#ifdef QBT_USE_QCOLLATOR
+        explicit NaturalSortKey(const QCollatorSortKey &key);
+#else
+        explicit NaturalSortKey(const QByteArray &key);
+#endif
+
+        int compare(const NaturalSortKey &other) const;
+
+        friend bool operator<(const NaturalSortKey &left, const NaturalSortKey &right)
+        {
+            return (left.compare(right) < 0);
+        }
+
+    private:
+#ifdef QBT_USE_QCOLLATOR
+        std::optional<QCollatorSortKey> m_key;
+#else
+        QByteArray m_key;
+#endif
+    };
+
 #ifdef QBT_USE_QCOLLATOR
     template <Qt::CaseSensitivity caseSensitivity>
     class NaturalCompare
@@ -56,11 +90,17 @@ namespace Utils::Compare
             return m_collator.compare(left, right);
         }
 
+        NaturalSortKey sortKey(const QString &str) const
+        {
+            return NaturalSortKey(m_collator.sortKey(str));
+        }
+
     private:
         QCollator m_collator;
     };
 #else
     int naturalCompare(const QString &left, const QString &right, Qt::CaseSensitivity caseSensitivity);
+    NaturalSortKey naturalSortKey(const QString &str, Qt::CaseSensitivity caseSensitivity);
 
     template <Qt::CaseSensitivity caseSensitivity>
     class NaturalCompare
@@ -70,6 +110,11 @@ namespace Utils::Compare
         {
             return naturalCompare(left, right, caseSensitivity);
         }
+
+        NaturalSortKey sortKey(const QString &str) const
+        {
+            return naturalSortKey(str, caseSensitivity);
+        }
     };
 #endif
 
@@ -86,3 +131,5 @@ namespace Utils::Compare
         NaturalCompare<caseSensitivity> m_comparator;
     };
 }
+
+Q_DECLARE_METATYPE(Utils::Compare::NaturalSortKey)
@@ -29,74 +29,247 @@
 
 #include "gzip.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include <QByteArray>
+#include <QSemaphore>
+#include <QThreadPool>
 
 #ifndef ZLIB_CONST
 #define ZLIB_CONST  // make z_stream.next_in const
 #endif
 #include <zlib.h>
 
-QByteArray Utils::Gzip::compress(const QByteArray &data, const int level, bool *ok)
+namespace
 {
-    if (ok) *ok = false;
+    // windowBits = 15 + 16 to enable gzip
+    // From the zlib manual: windowBits can also be greater than 15 for optional gzip encoding. Add 16 to windowBits
+    // to write a simple gzip header and trailer around the compressed data instead of a zlib wrapper.
+    const int GZIP_WINDOW_BITS = 15 + 16;
+    // negative windowBits produce raw deflate data, used for the chunks of a parallel compression
+    const int RAW_WINDOW_BITS = -15;
+    const int MEM_LEVEL = 9;
 
-    if (data.isEmpty())
-        return {};
+    // inputs of this size and larger are split into chunks which are compressed concurrently
+    const qsizetype PARALLEL_THRESHOLD = 1024 * 1024;
+    const qsizetype CHUNK_SIZE = 256 * 1024;
+    // each chunk is primed with the tail of the preceding one so the compression ratio stays close to the serial one
+    const qsizetype DICTIONARY_SIZE = 32 * 1024;
 
-    const int BUFSIZE = 128 * 1024;
-    std::vector<char> tmpBuf(BUFSIZE);
+    // Setting up a deflate state allocates a few hundred kilobytes,
+    // so every thread keeps its streams and only resets them between uses
+    class DeflateStream
+    {
+    public:
+        explicit DeflateStream(const int windowBits)
+            : m_windowBits {windowBits}
+        {
+        }
 
-    z_stream strm {};
-    strm.zalloc = Z_NULL;
-    strm.zfree = Z_NULL;
-    strm.opaque = Z_NULL;
-    strm.next_in = reinterpret_cast<const Bytef *>(data.constData());
-    strm.avail_in = uInt(data.size());
-    strm.next_out = reinterpret_cast<Bytef *>(tmpBuf.data());
-    strm.avail_out = BUFSIZE;
+        ~DeflateStream()
+        {
+            if (m_level >= 0)
+                deflateEnd(&m_strm);
+        }
 
-    // windowBits = 15 + 16 to enable gzip
-    // From the zlib manual: windowBits can also be greater than 15 for optional gzip encoding. Add 16 to windowBits
-    // to write a simple gzip header and trailer around the compressed data instead of a zlib wrapper.
-    int result = deflateInit2(&strm, level, Z_DEFLATED, (15 + 16), 9, Z_DEFAULT_STRATEGY);
-    if (result != Z_OK)
-        return {};
+        z_stream *reset(const int level)
+        {
+            if (m_level == level)
+            {
+                if (deflateReset(&m_strm) == Z_OK)
+                    return &m_strm;
+            }
 
-    QByteArray output;
-    output.reserve(deflateBound(&strm, data.size()));
+            if (m_level >= 0)
+                deflateEnd(&m_strm);
+
+            m_strm = {};
+            m_level = -1;
+            if (deflateInit2(&m_strm, level, Z_DEFLATED, m_windowBits, MEM_LEVEL, Z_DEFAULT_STRATEGY) != Z_OK)
+                return nullptr;
+
+            m_level = level;
+            return &m_strm;
+        }
+
+    private:
+        const int m_windowBits;
+        int m_level = -1;
+        z_stream m_strm {};
+    };
+
+    thread_local DeflateStream gzipStream {GZIP_WINDOW_BITS};
+    thread_local DeflateStream rawStream {RAW_WINDOW_BITS};
 
-    // feed to deflate
-    while (strm.avail_in > 0)
+    // compress the whole of `data` into `output`, growing it if `deflateBound()` turns out to be insufficient
+    bool deflateAll(z_stream *strm, const char *data, const qsizetype size, const int flush, QByteArray &output)
     {
-        result = deflate(&strm, Z_NO_FLUSH);
+        // leave room for the empty stored block emitted by Z_SYNC_FLUSH
+        output.resize(static_cast<qsizetype>(deflateBound(strm, static_cast<uLong>(size))) + 16);
 
-        if (result != Z_OK)
+        strm->next_in = reinterpret_cast<const Bytef *>(data);
+        strm->avail_in = static_cast<uInt>(size);
+        strm->next_out = reinterpret_cast<Bytef *>(output.data());
+        strm->avail_out = static_cast<uInt>(output.size());
+
+        int result = Z_OK;
+        while (true)
         {
-            deflateEnd(&strm);
+            result = deflate(strm, flush);
+            if ((result != Z_OK) && (result != Z_STREAM_END) && (result != Z_BUF_ERROR))
+                return false;
+
+            // deflate() stops early only when it runs out of output space
+            if (strm->avail_out > 0)
+                break;
+
+            const qsizetype written = output.size();
+            output.resize(written * 2);
+            strm->next_out = reinterpret_cast<Bytef *>(output.data() + written);
+            strm->avail_out = static_cast<uInt>(output.size() - written);
+        }
+
+        output.truncate(output.size() - static_cast<qsizetype>(strm->avail_out));
+        return ((flush != Z_FINISH) || (result == Z_STREAM_END));
+    }
+
+    QByteArray compressSerial(const QByteArray &data, const int level, bool *ok)
+    {
+        z_stream *strm = gzipStream.reset(level);
+        if (!strm)
             return {};
+
+        QByteArray output;
+        if (!deflateAll(strm, data.constData(), data.size(), Z_FINISH, output))
+            return {};
+
+        if (ok) *ok = true;
+        return output;
+    }
+
+    struct ParallelCompression
+    {
+        ParallelCompression(const QByteArray &data, const int level)
+            : input {data}
+            , level {level}
+            , chunkCount {static_cast<int>((data.size() + CHUNK_SIZE - 1) / CHUNK_SIZE)}
+            , chunks(chunkCount)
+            , checksums(chunkCount)
+        {
         }
 
-        output.append(tmpBuf.data(), (BUFSIZE - strm.avail_out));
-        strm.next_out = reinterpret_cast<Bytef *>(tmpBuf.data());
-        strm.avail_out = BUFSIZE;
+        const QByteArray input;
+        const int level;
+        const int chunkCount;
+        std::vector<QByteArray> chunks;
+        std::vector<uLong> checksums;
+        std::atomic_int nextChunk {0};
+        std::atomic_bool failed {false};
+        QSemaphore finishedChunks;
+    };
+
+    void compressChunk(ParallelCompression &job, const int index)
+    {
+        const qsizetype offset = index * CHUNK_SIZE;
+        const qsizetype size = std::min(CHUNK_SIZE, (job.input.size() - offset));
+        const char *data = job.input.constData() + offset;
+        const bool isLast = (index == (job.chunkCount - 1));
+
+        job.checksums[index] = crc32(0, reinterpret_cast<const Bytef *>(data), static_cast<uInt>(size));
+
+        z_stream *strm = rawStream.reset(job.level);
+        if (!strm)
+        {
+            job.failed = true;
+            return;
+        }
+
+        if (offset > 0)
+        {
+            const qsizetype dictSize = std::min(DICTIONARY_SIZE, offset);
+            deflateSetDictionary(strm, reinterpret_cast<const Bytef *>(data - dictSize), static_cast<uInt>(dictSize));
+        }
+
+        // every chunk but the last ends on a byte boundary without marking the end of the deflate stream,
+        // so the chunks can simply be concatenated
+        if (!deflateAll(strm, data, size, (isLast ? Z_FINISH : Z_SYNC_FLUSH), job.chunks[index]))
+            job.failed = true;
     }
 
-    // flush the rest from deflate
-    while (result != Z_STREAM_END)
+    void compressChunks(ParallelCompression &job)
     {
-        result = deflate(&strm, Z_FINISH);
+        for (int index = job.nextChunk++; index < job.chunkCount; index = job.nextChunk++)
+        {
+            compressChunk(job, index);
+            job.finishedChunks.release();
+        }
+    }
 
-        output.append(tmpBuf.data(), (BUFSIZE - strm.avail_out));
-        strm.next_out = reinterpret_cast<Bytef *>(tmpBuf.data());
-        strm.avail_out = BUFSIZE;
+    void appendUInt32LE(QByteArray &output, const quint32 value)
+    {
+        for (int i = 0; i < 4; ++i)
+            output.append(static_cast<char>((value >> (i * 8)) & 0xFF));
     }
 
-    deflateEnd(&strm);
+    QByteArray compressParallel(const QByteArray &data, const int level, bool *ok)
+    {
+        // state is shared with the helper tasks since those may start only after all chunks are done
+        const auto job = std::make_shared<ParallelCompression>(data, level);
 
-    if (ok) *ok = true;
-    return output;
+        // the calling thread takes part as well, so the compression progresses even if the pool is busy
+        QThreadPool *threadPool = QThreadPool::globalInstance();
+        const int helperCount = std::min(job->chunkCount, threadPool->maxThreadCount()) - 1;
+        for (int i = 0; i < helperCount; ++i)
+        {
+            if (!threadPool->tryStart([job] { compressChunks(*job); }))
+                break;
+        }
+        compressChunks(*job);
+        job->finishedChunks.acquire(job->chunkCount);
+
+        if (job->failed)
+            return {};
+
+        qsizetype compressedSize = 0;
+        for (const QByteArray &chunk : job->chunks)
+            compressedSize += chunk.size();
+
+        QByteArray output;
+        output.reserve(10 + compressedSize + 8);
+
+        // [RFC 1952] 2.3. Member format: no flags, no modification time, unknown OS
+        output.append("\x1F\x8B\x08\x00\x00\x00\x00\x00\x00\xFF", 10);
+
+        uLong checksum = job->checksums[0];
+        output.append(job->chunks[0]);
+        for (int i = 1; i < job->chunkCount; ++i)
+        {
+            const qsizetype chunkSize = std::min(CHUNK_SIZE, (data.size() - (i * CHUNK_SIZE)));
+            checksum = crc32_combine(checksum, job->checksums[i], static_cast<z_off_t>(chunkSize));
+            output.append(job->chunks[i]);
+        }
+
+        appendUInt32LE(output, static_cast<quint32>(checksum));
+        appendUInt32LE(output, static_cast<quint32>(data.size()));
+
+        if (ok) *ok = true;
+        return output;
+    }
+}
+
+QByteArray Utils::Gzip::compress(const QByteArray &data, const int level, bool *ok)
+{
+    if (ok) *ok = false;
+
+    if (data.isEmpty())
+        return {};
+
+    if ((data.size() >= PARALLEL_THRESHOLD) && (QThreadPool::globalInstance()->maxThreadCount() > 1))
+        return compressParallel(data, level, ok);
+    return compressSerial(data, level, ok);
 }
 
 QByteArray Utils::Gzip::decompress(const QByteArray &data, bool *ok)
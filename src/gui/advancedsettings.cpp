@@ -141,12 +141,17 @@ namespace
         // seeding
         CHOKING_ALGORITHM,
         SEED_CHOKING_ALGORITHM,
+        DYNAMIC_QUEUEING,
+        DYNAMIC_QUEUEING_INTERVAL,
+        UPLOAD_ALLOCATION,
         // tracker
         ANNOUNCE_ALL_TRACKERS,
         ANNOUNCE_ALL_TIERS,
         ANNOUNCE_IP,
         MAX_CONCURRENT_HTTP_ANNOUNCES,
         STOP_TRACKER_TIMEOUT,
+        ANNOUNCE_JITTER_WINDOW,
+        MAX_ANNOUNCES_PER_TRACKER_HOST,
         PEER_TURNOVER,
         PEER_TURNOVER_CUTOFF,
         PEER_TURNOVER_INTERVAL,
@@ -275,6 +280,10 @@ void AdvancedSettings::saveAdvancedSettings() const
     session->setMaxConcurrentHTTPAnnounces(m_spinBoxMaxConcurrentHTTPAnnounces.value());
     // Stop tracker timeout
     session->setStopTrackerTimeout(m_spinBoxStopTrackerTimeout.value());
+    // Reannounce jitter window
+    session->setAnnounceJitterWindow(m_spinBoxAnnounceJitterWindow.value());
+    // Max simultaneous announces per tracker host
+    session->setMaxAnnouncesPerTrackerHost(m_spinBoxMaxAnnouncesPerTrackerHost.value());
     // Program notification
     app()->desktopIntegration()->setNotificationsEnabled(m_checkBoxProgramNotifications.isChecked());
 #ifdef QBT_USES_CUSTOMDBUSNOTIFICATIONS
@@ -300,6 +309,11 @@ void AdvancedSettings::saveAdvancedSettings() const
     session->setChokingAlgorithm(m_comboBoxChokingAlgorithm.currentData().value<BitTorrent::ChokingAlgorithm>());
     // Seed choking algorithm
     session->setSeedChokingAlgorithm(m_comboBoxSeedChokingAlgorithm.currentData().value<BitTorrent::SeedChokingAlgorithm>());
+    // Dynamic queueing
+    session->setDynamicQueueingEnabled(m_checkBoxDynamicQueueing.isChecked());
+    session->setDynamicQueueingInterval(m_spinBoxDynamicQueueingInterval.value());
+    // Upload allocation
+    session->setUploadAllocationEnabled(m_checkBoxUploadAllocation.isChecked());
 
     pref->setConfirmTorrentRecheck(m_checkBoxConfirmTorrentRecheck.isChecked());
 
@@ -693,6 +707,16 @@ void AdvancedSettings::loadAdvancedSettings()
     m_spinBoxStopTrackerTimeout.setSuffix(tr(" s", " seconds"));
     addRow(STOP_TRACKER_TIMEOUT, (tr("Stop tracker timeout") + u' ' + makeLink(u"https://www.libtorrent.org/reference-Settings.html#stop_tracker_timeout", u"(?)"))
            , &m_spinBoxStopTrackerTimeout);
+    // Reannounce jitter window
+    m_spinBoxAnnounceJitterWindow.setMaximum(3600);
+    m_spinBoxAnnounceJitterWindow.setValue(session->announceJitterWindow());
+    m_spinBoxAnnounceJitterWindow.setSuffix(tr(" s", " seconds"));
+    addRow(ANNOUNCE_JITTER_WINDOW, tr("Spread reannounces to all trackers over"), &m_spinBoxAnnounceJitterWindow);
+    // Max simultaneous announces per tracker host
+    m_spinBoxMaxAnnouncesPerTrackerHost.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxMaxAnnouncesPerTrackerHost.setValue(session->maxAnnouncesPerTrackerHost());
+    m_spinBoxMaxAnnouncesPerTrackerHost.setSpecialValueText(tr("Unlimited"));
+    addRow(MAX_ANNOUNCES_PER_TRACKER_HOST, tr("Max simultaneous reannounces per tracker host"), &m_spinBoxMaxAnnouncesPerTrackerHost);
 
     // Program notifications
     m_checkBoxProgramNotifications.setChecked(app()->desktopIntegration()->isNotificationsEnabled());
@@ -751,6 +775,18 @@ void AdvancedSettings::loadAdvancedSettings()
     m_comboBoxSeedChokingAlgorithm.setCurrentIndex(m_comboBoxSeedChokingAlgorithm.findData(QVariant::fromValue(session->seedChokingAlgorithm())));
     addRow(SEED_CHOKING_ALGORITHM, (tr("Upload choking algorithm") + u' ' + makeLink(u"https://www.libtorrent.org/reference-Settings.html#seed_choking_algorithm", u"(?)"))
             , &m_comboBoxSeedChokingAlgorithm);
+    // Dynamic queueing
+    m_checkBoxDynamicQueueing.setChecked(session->isDynamicQueueingEnabled());
+    addRow(DYNAMIC_QUEUEING, tr("Give active seeding slots to torrents in demand"), &m_checkBoxDynamicQueueing);
+    m_spinBoxDynamicQueueingInterval.setMinimum(1);
+    m_spinBoxDynamicQueueingInterval.setMaximum(24 * 60);
+    m_spinBoxDynamicQueueingInterval.setValue(session->dynamicQueueingInterval());
+    m_spinBoxDynamicQueueingInterval.setSuffix(tr(" min", " minutes"));
+    addRow(DYNAMIC_QUEUEING_INTERVAL, tr("Seeding slots rotation interval"), &m_spinBoxDynamicQueueingInterval);
+    // Upload allocation
+    m_checkBoxUploadAllocation.setChecked(session->isUploadAllocationEnabled());
+    m_checkBoxUploadAllocation.setToolTip(tr("Share the global upload rate limit between torrents according to the demand for their data"));
+    addRow(UPLOAD_ALLOCATION, tr("Allocate upload bandwidth by swarm demand"), &m_checkBoxUploadAllocation);
 
     // Torrent recheck confirmation
     m_checkBoxConfirmTorrentRecheck.setChecked(pref->confirmTorrentRecheck());
@@ -30,150 +30,150 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 
 #include <QDebug>
+#include <QtAlgorithms>
 #include <QVector>
 
 #include "base/global.h"
 
 namespace
 {
-    QColor dlPieceColor(const QColor &pieceColor)
+    // counts set bits in range [from, to) a whole word at a time
+    int countBits(const QBitArray &bits, int from, const int to)
     {
-        const QColor green {Qt::green};
-        return QColor::fromHsl(green.hslHue(), pieceColor.hslSaturation(), pieceColor.lightness());
-    }
-}
-
-DownloadedPiecesBar::DownloadedPiecesBar(QWidget *parent)
-    : base {parent}
-    , m_dlPieceColor {dlPieceColor(pieceColor())}
-{
-}
-
-QVector<float> DownloadedPiecesBar::bitfieldToFloatVector(const QBitArray &vecin, int reqSize)
-{
-    QVector<float> result(reqSize, 0.0);
-    if (vecin.isEmpty()) return result;
+        const auto *data = reinterpret_cast<const uchar *>(bits.bits());
+        int count = 0;
 
-    const float ratio = vecin.size() / static_cast<float>(reqSize);
+        for (; (from < to) && ((from % 8) != 0); ++from)
+            count += bits.testBit(from);
+        for (; (to - from) >= 64; from += 64)
+        {
+            quint64 word = 0;
+            std::memcpy(&word, (data + (from / 8)), sizeof(word));
+            count += qPopulationCount(word);
+        }
+        for (; (to - from) >= 8; from += 8)
+            count += qPopulationCount(data[from / 8]);
+        for (; from < to; ++from)
+            count += bits.testBit(from);
 
-    // simple linear transformation algorithm
-    // for example:
-    // image.x(0) = pieces.x(0.0 >= x < 1.7)
-    // image.x(1) = pieces.x(1.7 >= x < 3.4)
+        return count;
+    }
 
-    for (int x = 0; x < reqSize; ++x)
+    // scale bitfield vector to float vector
+    // pixel x covers pieces range [x * ratio, (x + 1) * ratio), partially covered pieces are weighted by the covered part
+    QVector<float> bitfieldToFloatVector(const QBitArray &vecin, const int reqSize)
     {
-        // R - real
-        const float fromR = x * ratio;
-        const float toR = (x + 1) * ratio;
-
-        // C - integer
-        int fromC = fromR; // std::floor not needed
-        int toC = std::ceil(toR);
-        if (toC > vecin.size())
-            --toC;
+        QVector<float> result(reqSize, 0.0);
+        if (vecin.isEmpty())
+            return result;
 
-        // position in pieces table
-        int x2 = fromC;
+        const int size = vecin.size();
+        const float ratio = size / static_cast<float>(reqSize);
 
-        // little speed up for really big pieces table, 10K+ size
-        const int toCMinusOne = toC - 1;
+        for (int x = 0; x < reqSize; ++x)
+        {
+            // R - real
+            const float fromR = x * ratio;
+            const float toR = std::min((x + 1) * ratio, static_cast<float>(size));
 
-        // value in returned vector
-        float value = 0;
+            // C - integer, the range of the fully covered pieces
+            const int fromC = std::min(static_cast<int>(std::ceil(fromR)), size);
+            const int toC = std::max(static_cast<int>(toR), fromC);
 
-        // case when calculated range is (15.2 >= x < 15.7)
-        if (x2 == toCMinusOne)
-        {
-            if (vecin[x2])
-                value += ratio;
-            ++x2;
-        }
-        // case when (15.2 >= x < 17.8)
-        else
-        {
-            // subcase (15.2 >= x < 16)
-            if (x2 != fromR)
+            float value = 0;
+            if (static_cast<int>(fromR) == static_cast<int>(toR))
             {
-                if (vecin[x2])
-                    value += 1.0 - (fromR - fromC);
-                ++x2;
+                // case when calculated range is (15.2 >= x < 15.7)
+                if ((fromR < size) && vecin.testBit(fromR))
+                    value = toR - fromR;
             }
-
-            // subcase (16 >= x < 17)
-            for (; x2 < toCMinusOne; ++x2)
-                if (vecin[x2])
-                    value += 1.0;
-
-            // subcase (17 >= x < 17.8)
-            if (x2 == toCMinusOne)
+            else
             {
-                if (vecin[x2])
-                    value += 1.0 - (toC - toR);
-                ++x2;
+                // subcase (16 >= x < 17)
+                value = countBits(vecin, fromC, toC);
+                // subcase (15.2 >= x < 16)
+                if ((fromC > fromR) && vecin.testBit(fromC - 1))
+                    value += fromC - fromR;
+                // subcase (17 >= x < 17.8)
+                if ((toR > toC) && (toC < size) && vecin.testBit(toC))
+                    value += toR - toC;
             }
-        }
 
-        // normalization <0, 1>
-        value /= ratio;
+            // normalization <0, 1>
+            // float precision sometimes gives > 1, because it's not possible to store irrational numbers
+            result[x] = std::min((value / ratio), 1.0f);
+        }
 
-        // float precision sometimes gives > 1, because it's not possible to store irrational numbers
-        value = std::min(value, 1.0f);
+        return result;
+    }
 
-        result[x] = value;
+    QColor dlPieceColor(const QColor &pieceColor)
+    {
+        const QColor green {Qt::green};
+        return QColor::fromHsl(green.hslHue(), pieceColor.hslSaturation(), pieceColor.lightness());
     }
+}
 
-    return result;
+DownloadedPiecesBar::DownloadedPiecesBar(QWidget *parent)
+    : base {parent}
+    , m_dlPieceColor {dlPieceColor(pieceColor())}
+{
 }
 
-bool DownloadedPiecesBar::updateImage(QImage &image)
+DownloadedPiecesBar::ImageRenderer DownloadedPiecesBar::imageRenderer() const
 {
-    //  qDebug() << "updateImage";
-    QImage image2(width() - 2 * borderWidth, 1, QImage::Format_RGB888);
-    if (image2.isNull())
+    return [pieces = m_pieces, downloadedPieces = m_downloadedPieces
+            , backgroundColor = backgroundColor().rgb(), pieceColor = pieceColor().rgb()
+            , dlPieceColor = m_dlPieceColor.rgb(), pieceColors = pieceColors()](const int width)
     {
-        qDebug() << "QImage image2() allocation failed, width():" << width();
-        return false;
-    }
+        QImage image {width, 1, QImage::Format_RGB888};
+        if (image.isNull())
+        {
+            qDebug() << "QImage image() allocation failed, width():" << width;
+            return image;
+        }
 
-    if (m_pieces.isEmpty())
-    {
-        image2.fill(backgroundColor());
-        image = image2;
-        return true;
-    }
+        if (pieces.isEmpty())
+        {
+            image.fill(backgroundColor);
+            return image;
+        }
 
-    QVector<float> scaledPieces = bitfieldToFloatVector(m_pieces, image2.width());
-    QVector<float> scaledPiecesDl = bitfieldToFloatVector(m_downloadedPieces, image2.width());
+        const QVector<float> scaledPieces = bitfieldToFloatVector(pieces, width);
+        const QVector<float> scaledPiecesDl = bitfieldToFloatVector(downloadedPieces, width);
 
-    // filling image
-    for (int x = 0; x < scaledPieces.size(); ++x)
-    {
-        float piecesToValue = scaledPieces.at(x);
-        float piecesToValueDl = scaledPiecesDl.at(x);
-        if (piecesToValueDl != 0)
+        // filling image
+        for (int x = 0; x < scaledPieces.size(); ++x)
         {
-            float fillRatio = piecesToValue + piecesToValueDl;
-            float ratio = piecesToValueDl / fillRatio;
+            const float piecesToValue = scaledPieces.at(x);
+            const float piecesToValueDl = scaledPiecesDl.at(x);
+            if (piecesToValueDl != 0)
+            {
+                const float fillRatio = piecesToValue + piecesToValueDl;
+                const float ratio = piecesToValueDl / fillRatio;
 
-            QRgb mixedColor = mixTwoColors(pieceColor().rgb(), m_dlPieceColor.rgb(), ratio);
-            mixedColor = mixTwoColors(backgroundColor().rgb(), mixedColor, fillRatio);
+                QRgb mixedColor = mixTwoColors(pieceColor, dlPieceColor, ratio);
+                mixedColor = mixTwoColors(backgroundColor, mixedColor, fillRatio);
 
-            image2.setPixel(x, 0, mixedColor);
-        }
-        else
-        {
-            image2.setPixel(x, 0, pieceColors()[piecesToValue * 255]);
+                image.setPixel(x, 0, mixedColor);
+            }
+            else
+            {
+                image.setPixel(x, 0, pieceColors[piecesToValue * 255]);
+            }
         }
-    }
-    image = image2;
-    return true;
+        return image;
+    };
 }
 
 void DownloadedPiecesBar::setProgress(const QBitArray &pieces, const QBitArray &downloadedPieces)
 {
+    if ((pieces == m_pieces) && (downloadedPieces == m_downloadedPieces))
+        return;
+
     m_pieces = pieces;
     m_downloadedPieces = downloadedPieces;
 
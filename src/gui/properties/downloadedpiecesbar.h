@@ -29,7 +29,6 @@
 #pragma once
 
 #include <QBitArray>
-#include <QtContainerFwd>
 
 #include "piecesbar.h"
 
@@ -50,15 +49,12 @@ public:
     void clear() override;
 
 private:
-    // scale bitfield vector to float vector
-    QVector<float> bitfieldToFloatVector(const QBitArray &vecin, int reqSize);
-    virtual bool updateImage(QImage &image) override;
+    ImageRenderer imageRenderer() const override;
     QString simpleToolTipText() const override;
 
     // incomplete piece color
     const QColor m_dlPieceColor;
     // last used bitfields, uses to better resize redraw
-    // TODO: make a diff pieces to new pieces and update only changed pixels, speedup when update > 20x faster
     QBitArray m_pieces;
     QBitArray m_downloadedPieces;
 };
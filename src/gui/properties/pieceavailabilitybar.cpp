@@ -30,132 +30,107 @@
 
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 
 #include <QDebug>
 
 #include "base/global.h"
 
-PieceAvailabilityBar::PieceAvailabilityBar(QWidget *parent)
-    : base {parent}
-{
-}
-
-QVector<float> PieceAvailabilityBar::intToFloatVector(const QVector<int> &vecin, int reqSize)
+namespace
 {
-    QVector<float> result(reqSize, 0.0);
-    if (vecin.isEmpty()) return result;
-
-    const float ratio = static_cast<float>(vecin.size()) / reqSize;
-
-    const int maxElement = *std::max_element(vecin.begin(), vecin.end());
-
-    // std::max because in normalization we don't want divide by 0
-    // if maxElement == 0 check will be disabled please enable this line:
-    // const int maxElement = std::max(*std::max_element(avail.begin(), avail.end()), 1);
-
-    if (maxElement == 0)
-        return result;
-
-    // simple linear transformation algorithm
-    // for example:
-    // image.x(0) = pieces.x(0.0 >= x < 1.7)
-    // image.x(1) = pieces.x(1.7 >= x < 3.4)
-
-    for (int x = 0; x < reqSize; ++x)
+    // scale int vector to float vector
+    // pixel x covers pieces range [x * ratio, (x + 1) * ratio), partially covered pieces are weighted by the covered part
+    QVector<float> intToFloatVector(const QVector<int> &vecin, const int reqSize)
     {
-        // R - real
-        const float fromR = x * ratio;
-        const float toR = (x + 1) * ratio;
+        QVector<float> result(reqSize, 0.0);
+        if (vecin.isEmpty())
+            return result;
 
-        // C - integer
-        int fromC = fromR;// std::floor not needed
-        int toC = std::ceil(toR);
-        if (toC > vecin.size())
-            --toC;
+        const int size = vecin.size();
+        const float ratio = static_cast<float>(size) / reqSize;
 
-        // position in pieces table
-        int x2 = fromC;
+        const int maxElement = *std::max_element(vecin.cbegin(), vecin.cend());
+        // in normalization we don't want divide by 0
+        if (maxElement == 0)
+            return result;
 
-        // little speed up for really big pieces table, 10K+ size
-        const int toCMinusOne = toC - 1;
+        for (int x = 0; x < reqSize; ++x)
+        {
+            // R - real
+            const float fromR = x * ratio;
+            const float toR = std::min((x + 1) * ratio, static_cast<float>(size));
 
-        // value in returned vector
-        float value = 0;
+            // C - integer, the range of the fully covered pieces
+            const int fromC = std::min(static_cast<int>(std::ceil(fromR)), size);
+            const int toC = std::max(static_cast<int>(toR), fromC);
 
-        // case when calculated range is (15.2 >= x < 15.7)
-        if (x2 == toCMinusOne)
-        {
-            if (vecin[x2])
-                value += ratio * vecin[x2];
-            ++x2;
-        }
-        // case when (15.2 >= x < 17.8)
-        else
-        {
-            // subcase (15.2 >= x < 16)
-            if (x2 != fromR)
+            float value = 0;
+            if (static_cast<int>(fromR) == static_cast<int>(toR))
             {
-                if (vecin[x2])
-                    value += (1.0 - (fromR - fromC)) * vecin[x2];
-                ++x2;
+                // case when calculated range is (15.2 >= x < 15.7)
+                if (fromR < size)
+                    value = (toR - fromR) * vecin[fromR];
             }
-
-            // subcase (16 >= x < 17)
-            for (; x2 < toCMinusOne; ++x2)
-                if (vecin[x2])
-                    value += vecin[x2];
-
-            // subcase (17 >= x < 17.8)
-            if (x2 == toCMinusOne)
+            else
             {
-                if (vecin[x2])
-                    value += (1.0 - (toC - toR)) * vecin[x2];
-                ++x2;
+                // subcase (16 >= x < 17), plain summation of the contiguous range is vectorized by the compiler
+                value = std::accumulate((vecin.cbegin() + fromC), (vecin.cbegin() + toC), qint64 {0});
+                // subcase (15.2 >= x < 16)
+                if (fromC > fromR)
+                    value += (fromC - fromR) * vecin[fromC - 1];
+                // subcase (17 >= x < 17.8)
+                if ((toR > toC) && (toC < size))
+                    value += (toR - toC) * vecin[toC];
             }
-        }
 
-        // normalization <0, 1>
-        value /= ratio * maxElement;
-
-        // float precision sometimes gives > 1, because it's not possible to store irrational numbers
-        value = std::min(value, 1.0f);
+            // normalization <0, 1>
+            // float precision sometimes gives > 1, because it's not possible to store irrational numbers
+            result[x] = std::min((value / (ratio * maxElement)), 1.0f);
+        }
 
-        result[x] = value;
+        return result;
     }
+}
 
-    return result;
+PieceAvailabilityBar::PieceAvailabilityBar(QWidget *parent)
+    : base {parent}
+{
 }
 
-bool PieceAvailabilityBar::updateImage(QImage &image)
+PieceAvailabilityBar::ImageRenderer PieceAvailabilityBar::imageRenderer() const
 {
-    QImage image2(width() - 2 * borderWidth, 1, QImage::Format_RGB888);
-    if (image2.isNull())
+    return [pieces = m_pieces, backgroundColor = backgroundColor().rgb(), pieceColors = pieceColors()](const int width)
     {
-        qDebug() << "QImage image2() allocation failed, width():" << width();
-        return false;
-    }
+        QImage image {width, 1, QImage::Format_RGB888};
+        if (image.isNull())
+        {
+            qDebug() << "QImage image() allocation failed, width():" << width;
+            return image;
+        }
 
-    if (m_pieces.empty())
-    {
-        image2.fill(backgroundColor());
-        image = image2;
-        return true;
-    }
+        if (pieces.empty())
+        {
+            image.fill(backgroundColor);
+            return image;
+        }
 
-    QVector<float> scaledPieces = intToFloatVector(m_pieces, image2.width());
+        const QVector<float> scaledPieces = intToFloatVector(pieces, width);
 
-    // filling image
-    for (int x = 0; x < scaledPieces.size(); ++x)
-    {
-        float piecesToValue = scaledPieces.at(x);
-        image2.setPixel(x, 0, pieceColors()[piecesToValue * 255]);
-    }
-    image = image2;
-    return true;
+        // filling image
+        for (int x = 0; x < scaledPieces.size(); ++x)
+        {
+            const float piecesToValue = scaledPieces.at(x);
+            image.setPixel(x, 0, pieceColors[piecesToValue * 255]);
+        }
+        return image;
+    };
 }
 
 void PieceAvailabilityBar::setAvailability(const QVector<int> &avail)
 {
+    if (avail == m_pieces)
+        return;
+
     m_pieces = avail;
 
     requestImageUpdate();
@@ -46,13 +46,9 @@ public:
     void clear() override;
 
 private:
-    bool updateImage(QImage &image) override;
+    ImageRenderer imageRenderer() const override;
     QString simpleToolTipText() const override;
 
     // last used int vector, uses to better resize redraw
-    // TODO: make a diff pieces to new pieces and update only changed pixels, speedup when update > 20x faster
     QVector<int> m_pieces;
-
-    // scale int vector to float vector
-    QVector<float> intToFloatVector(const QVector<int> &vecin, int reqSize);
 };
@@ -34,6 +34,8 @@
 #include <QHelpEvent>
 #include <QPainter>
 #include <QPainterPath>
+#include <QPointer>
+#include <QThreadPool>
 #include <QToolTip>
 
 #include "base/bittorrent/torrent.h"
@@ -129,6 +131,9 @@ void PiecesBar::setTorrent(const BitTorrent::Torrent *torrent)
 
 void PiecesBar::clear()
 {
+    // discard the image being rendered from the previous data
+    ++m_dataVersion;
+    m_imageDataVersion = m_dataVersion;
     m_image = QImage();
     update();
 }
@@ -158,7 +163,7 @@ void PiecesBar::leaveEvent(QEvent *e)
 {
     m_hovered = false;
     m_highlightedRegion = {};
-    requestImageUpdate();
+    update();
     base::leaveEvent(e);
 }
 
@@ -181,8 +186,9 @@ void PiecesBar::paintEvent(QPaintEvent *)
     }
     else
     {
+        // the outdated image is stretched until the one of the new size is rendered
         if (m_image.width() != imageRect.width())
-            updateImage(m_image);
+            renderImage();
         painter.drawImage(imageRect, m_image);
     }
 
@@ -202,8 +208,56 @@ void PiecesBar::paintEvent(QPaintEvent *)
 
 void PiecesBar::requestImageUpdate()
 {
-    if (updateImage(m_image))
+    ++m_dataVersion;
+    renderImage();
+}
+
+int PiecesBar::imageWidth() const
+{
+    return width() - 2 * borderWidth;
+}
+
+void PiecesBar::renderImage()
+{
+    const int width = imageWidth();
+    if (width <= 0)
+        return;
+    // a null image of the current data version means that the bar was cleared
+    if ((m_imageDataVersion == m_dataVersion) && (m_image.isNull() || (m_image.width() == width)))
+        return;
+    // requests are coalesced, the image is checked again once the running rendering is finished
+    if (m_isRendering)
+        return;
+
+    m_isRendering = true;
+    QThreadPool::globalInstance()->start([renderer = imageRenderer(), width
+            , dataVersion = m_dataVersion, thisBar = QPointer<PiecesBar>(this)]
+    {
+        const QImage image = renderer(width);
+        QMetaObject::invokeMethod(qApp, [thisBar, image, dataVersion]
+        {
+            if (thisBar)
+                thisBar->handleImageRendered(image, dataVersion);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void PiecesBar::handleImageRendered(const QImage &image, const quint64 dataVersion)
+{
+    m_isRendering = false;
+
+    // the image of the same data version is accepted only when it was rendered for the new size
+    // and it isn't the one that was discarded by clear()
+    const bool isUpToDate = (dataVersion > m_imageDataVersion)
+            || ((dataVersion == m_imageDataVersion) && !m_image.isNull());
+    if (!image.isNull() && isUpToDate)
+    {
+        m_image = image;
+        m_imageDataVersion = dataVersion;
         update();
+    }
+
+    renderImage();
 }
 
 QColor PiecesBar::backgroundColor() const
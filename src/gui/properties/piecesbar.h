@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include <QColor>
 #include <QImage>
 #include <QWidget>
@@ -68,6 +70,12 @@ protected:
     void mouseMoveEvent(QMouseEvent *e) override;
 
     void paintEvent(QPaintEvent *e) override;
+
+    // renders the bar image of the given width; it is run on a worker thread
+    // so it must only use the data captured by value
+    using ImageRenderer = std::function<QImage (int width)>;
+
+    // notifies that the displayed data has changed so the cached image is outdated
     void requestImageUpdate();
 
     QColor backgroundColor() const;
@@ -87,13 +95,18 @@ private:
 
     virtual QString simpleToolTipText() const = 0;
 
-    // draw new image to replace the actual image
-    // returns true if image was successfully updated
-    virtual bool updateImage(QImage &image) = 0;
+    virtual ImageRenderer imageRenderer() const = 0;
+    int imageWidth() const;
+    void renderImage();
+    void handleImageRendered(const QImage &image, quint64 dataVersion);
     void updatePieceColors();
 
     const BitTorrent::Torrent *m_torrent = nullptr;
     QImage m_image;
+    // the image is cached by (data version, width) and is re-rendered only when either of them changes
+    quint64 m_dataVersion = 0;
+    quint64 m_imageDataVersion = 0;
+    bool m_isRendering = false;
     // buffered 256 levels gradient from bg_color to piece_color
     QVector<QRgb> m_pieceColors;
     bool m_hovered = false;
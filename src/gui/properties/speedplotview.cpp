@@ -31,11 +31,13 @@
 
 #include <cmath>
 
+#include <QDateTime>
 #include <QLocale>
 #include <QPainter>
 #include <QPen>
 
 #include "base/bittorrent/session.h"
+#include "base/bittorrent/transferhistory.h"
 #include "base/global.h"
 #include "base/unicodestrings.h"
 #include "base/utils/misc.h"
@@ -155,6 +157,55 @@ bool SpeedPlotView::Averager::push(const SampleData &sampleData)
     return true;
 }
 
+void SpeedPlotView::Averager::load(const BitTorrent::TransferHistorySeries &series)
+{
+    static_assert(static_cast<int>(NB_GRAPHS) == static_cast<int>(BitTorrent::TransferHistory::MetricsCount));
+
+    m_sink.clear();
+    m_currentDuration = 0ms;
+    m_accumulator = {};
+    m_counter = 0;
+
+    const int samplesCount = series.samplesCount();
+    if ((samplesCount == 0) || (series.interval <= 0))
+        return;
+
+    // merge the history samples to get the resolution of this averager
+    const milliseconds interval = std::chrono::seconds(series.interval);
+    const int groupSize = std::max(1, static_cast<int>(m_resolution / interval));
+    const int groupsCount = std::min(((samplesCount + groupSize - 1) / groupSize), static_cast<int>(m_sink.capacity() - 1));
+    for (int group = groupsCount; group > 0; --group)
+    {
+        const int groupEnd = samplesCount - ((group - 1) * groupSize);
+        const int groupBegin = std::max(0, (groupEnd - groupSize));
+
+        SampleData data {};
+        for (int sample = groupBegin; sample < groupEnd; ++sample)
+        {
+            for (int id = UP; id < NB_GRAPHS; ++id)
+                data[id] += series.value(sample, id);
+        }
+        for (int id = UP; id < NB_GRAPHS; ++id)
+            data[id] /= (groupEnd - groupBegin);
+
+        const milliseconds duration = interval * (groupEnd - groupBegin);
+        m_sink.push_back({duration, data});
+        m_currentDuration += duration;
+    }
+
+    m_lastSampleTime.restart();
+}
+
+milliseconds SpeedPlotView::Averager::resolution() const
+{
+    return m_resolution;
+}
+
+milliseconds SpeedPlotView::Averager::maxDuration() const
+{
+    return m_maxDuration;
+}
+
 const SpeedPlotView::DataCircularBuffer &SpeedPlotView::Averager::data() const
 {
     return m_sink;
@@ -214,6 +265,26 @@ void SpeedPlotView::pushPoint(const SpeedPlotView::SampleData &point)
     }
 }
 
+void SpeedPlotView::loadHistory(const BitTorrent::TransferHistory &history)
+{
+    using BitTorrent::TransferHistory;
+
+    const qint64 currentTime = QDateTime::currentSecsSinceEpoch();
+    for (Averager *averager : {&m_averager5Min, &m_averager30Min
+                                , &m_averager6Hour, &m_averager12Hour
+                                , &m_averager24Hour})
+    {
+        // per second history is kept for the last hour only
+        const TransferHistory::Resolution resolution = ((averager->resolution() < 1min) && (averager->maxDuration() <= 1h))
+                ? TransferHistory::Resolution::Second
+                : TransferHistory::Resolution::Minute;
+        const qint64 from = currentTime - std::chrono::duration_cast<std::chrono::seconds>(averager->maxDuration()).count();
+        averager->load(history.series(resolution, from));
+    }
+
+    viewport()->update();
+}
+
 void SpeedPlotView::setPeriod(const TimePeriod period)
 {
     switch (period)
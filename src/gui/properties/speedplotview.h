@@ -42,6 +42,12 @@
 
 class QPen;
 
+namespace BitTorrent
+{
+    class TransferHistory;
+    struct TransferHistorySeries;
+}
+
 using std::chrono::milliseconds;
 using namespace std::chrono_literals;
 
@@ -86,6 +92,7 @@ public:
     void setPeriod(TimePeriod period);
 
     void pushPoint(const SampleData &point);
+    void loadHistory(const BitTorrent::TransferHistory &history);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -105,6 +112,10 @@ private:
         Averager(milliseconds duration, milliseconds resolution);
 
         bool push(const SampleData &sampleData); // returns true if there is new data to display
+        void load(const BitTorrent::TransferHistorySeries &series);
+
+        milliseconds resolution() const;
+        milliseconds maxDuration() const;
 
         const DataCircularBuffer &data() const;
 
@@ -36,6 +36,7 @@
 
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/sessionstatus.h"
+#include "base/bittorrent/transferhistory.h"
 #include "base/preferences.h"
 #include "propertieswidget.h"
 #include "speedplotview.h"
@@ -109,6 +110,7 @@ SpeedWidget::SpeedWidget(PropertiesWidget *parent)
     m_hlayout->addWidget(m_graphsButton);
 
     m_plot = new SpeedPlotView(this);
+    m_plot->loadHistory(BitTorrent::Session::instance()->transferHistory());
     connect(BitTorrent::Session::instance(), &BitTorrent::Session::statsUpdated, this, &SpeedWidget::update);
 
     m_layout->addLayout(m_hlayout);
@@ -28,12 +28,16 @@
 
 #include "tagfiltermodel.h"
 
+#include <algorithm>
+
+#include <QBitArray>
 #include <QDebug>
 #include <QIcon>
 #include <QVector>
 
 #include "base/bittorrent/session.h"
 #include "base/global.h"
+#include "base/tagindex.h"
 #include "uithememanager.h"
 
 namespace
@@ -202,7 +206,7 @@ void TagFilterModel::tagRemoved(const QString &tag)
 
 void TagFilterModel::torrentTagAdded(BitTorrent::Torrent *const torrent, const QString &tag)
 {
-    if (torrent->tags().count() == 1)
+    if (torrent->tagBits().count(true) == 1)
         untaggedItem()->decreaseTorrentsCount();
 
     const int row = findRow(tag);
@@ -216,7 +220,7 @@ void TagFilterModel::torrentTagAdded(BitTorrent::Torrent *const torrent, const Q
 
 void TagFilterModel::torrentTagRemoved(BitTorrent::Torrent *const torrent, const QString &tag)
 {
-    if (torrent->tags().empty())
+    if (torrent->tagBits().count(true) == 0)
         untaggedItem()->increaseTorrentsCount();
 
     const int row = findRow(tag);
@@ -248,7 +252,7 @@ void TagFilterModel::torrentAboutToBeRemoved(BitTorrent::Torrent *const torrent)
 {
     allTagsItem()->decreaseTorrentsCount();
 
-    if (torrent->tags().isEmpty())
+    if (torrent->tagBits().count(true) == 0)
         untaggedItem()->decreaseTorrentsCount();
 
     for (TagModelItem *item : asConst(findItems(torrent->tags())))
@@ -274,16 +278,31 @@ void TagFilterModel::populate()
     // All torrents
     addToModel(getSpecialAllTag(), torrents.count());
 
-    const int untaggedCount = std::count_if(torrents.cbegin(), torrents.cend(),
-                                             [](Torrent *torrent) { return torrent->tags().isEmpty(); });
+    // Count all tags in a single pass over torrents, by their indexes
+    const TagIndex &tagIndex = session->tagIndex();
+    int untaggedCount = 0;
+    QVector<int> tagsCount(tagIndex.capacity());
+    for (const Torrent *torrent : torrents)
+    {
+        const QBitArray &tagBits = torrent->tagBits();
+        const int bitsCount = std::min(static_cast<int>(tagBits.size()), static_cast<int>(tagsCount.size()));
+        bool isTagged = false;
+        for (int i = 0; i < bitsCount; ++i)
+        {
+            if (!tagBits.testBit(i))
+                continue;
+
+            ++tagsCount[i];
+            isTagged = true;
+        }
+
+        if (!isTagged)
+            ++untaggedCount;
+    }
     addToModel(getSpecialUntaggedTag(), untaggedCount);
 
     for (const QString &tag : asConst(session->tags()))
-    {
-        const int count = std::count_if(torrents.cbegin(), torrents.cend(),
-                                        [tag](Torrent *torrent) { return torrent->hasTag(tag); });
-        addToModel(tag, count);
-    }
+        addToModel(tag, tagsCount.value(tagIndex.indexOf(tag)));
 }
 
 void TagFilterModel::addToModel(const QString &tag, int count)
@@ -224,9 +224,6 @@ void TorrentContentModel::updateFilesProgress()
 
     for (int i = 0; i < filesProgress.size(); ++i)
         m_filesIndex[i]->setProgress(filesProgress[i]);
-    // Update folders progress in the tree
-    m_rootItem->recalculateProgress();
-    m_rootItem->recalculateAvailability();
 }
 
 void TorrentContentModel::updateFilesPriorities()
@@ -239,8 +236,9 @@ void TorrentContentModel::updateFilesPriorities()
     if (m_filesIndex.size() != fprio.size())
         return;
 
+    // folders priorities are recalculated at once by recalculateStatistics()
     for (int i = 0; i < fprio.size(); ++i)
-        m_filesIndex[i]->setPriority(static_cast<BitTorrent::DownloadPriority>(fprio[i]));
+        m_filesIndex[i]->setPriority(static_cast<BitTorrent::DownloadPriority>(fprio[i]), false);
 }
 
 void TorrentContentModel::updateFilesAvailability()
@@ -260,8 +258,8 @@ void TorrentContentModel::updateFilesAvailability()
 
         for (int i = 0; i < m_filesIndex.size(); ++i)
             m_filesIndex[i]->setAvailability(availableFileFractions[i]);
-        // Update folders progress in the tree
-        m_rootItem->recalculateProgress();
+        // Update folders availability in the tree
+        m_rootItem->recalculateAvailability();
     });
 }
 
@@ -278,8 +276,7 @@ bool TorrentContentModel::setItemPriority(const QModelIndex &index, BitTorrent::
     m_contentHandler->prioritizeFiles(getFilePriorities());
 
     // Update folders progress in the tree
-    m_rootItem->recalculateProgress();
-    m_rootItem->recalculateAvailability();
+    m_rootItem->recalculateStatistics();
 
     const QVector<ColumnInterval> columns =
     {
@@ -555,29 +552,28 @@ void TorrentContentModel::populate()
     m_filesIndex.reserve(filesCount);
 
     QHash<TorrentContentModelFolder *, QHash<QString, TorrentContentModelFolder *>> folderMap;
-    QVector<QString> lastParentPath;
+    QString lastParentPath;
     TorrentContentModelFolder *lastParent = m_rootItem;
     // Iterate over files
     for (int i = 0; i < filesCount; ++i)
     {
         const QString path = m_contentHandler->filePath(i).data();
+        const int fileNameStart = path.lastIndexOf(u'/') + 1;
+        const QStringView parentPath = QStringView(path).left(std::max((fileNameStart - 1), 0));
+        const QString fileName = path.mid(fileNameStart);
 
-        // Iterate of parts of the path to create necessary folders
-        QList<QStringView> pathFolders = QStringView(path).split(u'/', Qt::SkipEmptyParts);
-        const QString fileName = pathFolders.takeLast().toString();
-
-        if (!std::equal(lastParentPath.begin(), lastParentPath.end()
-                        , pathFolders.begin(), pathFolders.end()))
+        // files of the same folder are usually listed together,
+        // so the path is split only when the folder differs from the previous one
+        if (parentPath != lastParentPath)
         {
-            lastParentPath.clear();
-            lastParentPath.reserve(pathFolders.size());
+            lastParentPath = parentPath.toString();
 
             // rebuild the path from the root
             lastParent = m_rootItem;
-            for (const QStringView pathPart : asConst(pathFolders))
+            const QList<QStringView> pathFolders = parentPath.split(u'/', Qt::SkipEmptyParts);
+            for (const QStringView pathPart : pathFolders)
             {
                 const QString folderName = pathPart.toString();
-                lastParentPath.push_back(folderName);
 
                 TorrentContentModelFolder *&newParent = folderMap[lastParent][folderName];
                 if (!newParent)
@@ -598,6 +594,7 @@ void TorrentContentModel::populate()
 
     updateFilesProgress();
     updateFilesPriorities();
+    m_rootItem->recalculateStatistics();
     updateFilesAvailability();
 }
 
@@ -632,16 +629,16 @@ void TorrentContentModel::refresh()
     {
         updateFilesProgress();
         updateFilesPriorities();
+        m_rootItem->recalculateStatistics();
         updateFilesAvailability();
 
+        // progress affects the remaining size too, so a single range covering
+        // all the columns is emitted per folder instead of one per column
         const QVector<ColumnInterval> columns =
         {
-            {TorrentContentModelItem::COL_NAME, TorrentContentModelItem::COL_NAME},
-            {TorrentContentModelItem::COL_PROGRESS, TorrentContentModelItem::COL_PROGRESS},
-            {TorrentContentModelItem::COL_PRIO, TorrentContentModelItem::COL_PRIO},
-            {TorrentContentModelItem::COL_AVAILABILITY, TorrentContentModelItem::COL_AVAILABILITY}
+            {TorrentContentModelItem::COL_NAME, (TorrentContentModelItem::NB_COL - 1)}
         };
-        notifySubtreeUpdated(index(0, 0), columns);
+        notifySubtreeUpdated({}, columns);
     }
     else
     {
@@ -654,20 +651,22 @@ void TorrentContentModel::refresh()
 void TorrentContentModel::notifySubtreeUpdated(const QModelIndex &index, const QVector<ColumnInterval> &columns)
 {
     // For best performance, `columns` entries should be arranged from left to right
+    // Invalid `index` stands for the root item, i.e. the whole model
 
-    Q_ASSERT(index.isValid());
-
-    // emit itself
-    for (const ColumnInterval &column : columns)
-        emit dataChanged(index.siblingAtColumn(column.first()), index.siblingAtColumn(column.last()));
-
-    // propagate up the model
-    QModelIndex parentIndex = parent(index);
-    while (parentIndex.isValid())
+    if (index.isValid())
     {
+        // emit itself
         for (const ColumnInterval &column : columns)
-            emit dataChanged(parentIndex.siblingAtColumn(column.first()), parentIndex.siblingAtColumn(column.last()));
-        parentIndex = parent(parentIndex);
+            emit dataChanged(index.siblingAtColumn(column.first()), index.siblingAtColumn(column.last()));
+
+        // propagate up the model
+        QModelIndex parentIndex = parent(index);
+        while (parentIndex.isValid())
+        {
+            for (const ColumnInterval &column : columns)
+                emit dataChanged(parentIndex.siblingAtColumn(column.first()), parentIndex.siblingAtColumn(column.last()));
+            parentIndex = parent(parentIndex);
+        }
     }
 
     // propagate down the model
@@ -71,6 +71,7 @@ const QVector<TorrentContentModelItem *> &TorrentContentModelFolder::children()
 void TorrentContentModelFolder::appendChild(TorrentContentModelItem *item)
 {
     Q_ASSERT(item);
+    item->m_row = m_childItems.size();
     m_childItems.append(item);
     // Update own size
     if (item->itemType() == FileType)
@@ -130,29 +131,65 @@ void TorrentContentModelFolder::setPriority(BitTorrent::DownloadPriority newPrio
     }
 }
 
-void TorrentContentModelFolder::recalculateProgress()
+void TorrentContentModelFolder::recalculateStatistics()
 {
+    BitTorrent::DownloadPriority prio = BitTorrent::DownloadPriority::Normal;
+    bool isPriorityMixed = false;
     qreal tProgress = 0;
+    qreal tAvailability = 0;
     qulonglong tSize = 0;
     qulonglong tRemaining = 0;
-    for (TorrentContentModelItem *child : asConst(m_childItems))
+    bool foundAnyData = false;
+    for (int i = 0; i < m_childItems.size(); ++i)
     {
-        if (child->priority() == BitTorrent::DownloadPriority::Ignored)
+        TorrentContentModelItem *child = m_childItems.at(i);
+        if (child->itemType() == FolderType)
+            static_cast<TorrentContentModelFolder *>(child)->recalculateStatistics();
+
+        const BitTorrent::DownloadPriority childPriority = child->priority();
+        if (i == 0)
+            prio = childPriority;
+        else if (childPriority != prio)
+            isPriorityMixed = true;
+
+        if (childPriority == BitTorrent::DownloadPriority::Ignored)
             continue;
 
-        if (child->itemType() == FolderType)
-            static_cast<TorrentContentModelFolder *>(child)->recalculateProgress();
         tProgress += child->progress() * child->size();
         tSize += child->size();
         tRemaining += child->remaining();
+
+        const qreal childAvailability = child->availability();
+        if (childAvailability >= 0)
+        { // -1 means "no data"
+            tAvailability += childAvailability * child->size();
+            foundAnyData = true;
+        }
     }
 
-    if (!isRootItem() && (tSize > 0))
+    if (isRootItem())
+        return;
+
+    Q_ASSERT(!m_childItems.isEmpty());
+    // children priorities are already up to date so they aren't touched here
+    m_priority = isPriorityMixed ? BitTorrent::DownloadPriority::Mixed : prio;
+
+    if (tSize > 0)
     {
         m_progress = tProgress / tSize;
         m_remaining = tRemaining;
         Q_ASSERT(m_progress <= 1.);
     }
+
+    if ((tSize > 0) && foundAnyData)
+    {
+        m_availability = tAvailability / tSize;
+        Q_ASSERT(m_availability <= 1.);
+    }
+    else
+    {
+        m_availability = -1.;
+    }
 }
 
 void TorrentContentModelFolder::recalculateAvailability()
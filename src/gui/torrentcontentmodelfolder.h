@@ -49,7 +49,8 @@ public:
     ItemType itemType() const override;
 
     void increaseSize(qulonglong delta);
-    void recalculateProgress();
+    // recalculates priority, progress and availability of the whole subtree in a single post-order traversal
+    void recalculateStatistics();
     void recalculateAvailability();
     void updatePriority();
 
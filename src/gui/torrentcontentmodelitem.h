@@ -40,6 +40,7 @@ class TorrentContentModelFolder;
 class TorrentContentModelItem
 {
     Q_DECLARE_TR_FUNCTIONS(TorrentContentModelItem)
+    friend class TorrentContentModelFolder;
 
 public:
     enum TreeItemColumns
@@ -85,6 +86,7 @@ public:
 
 protected:
     TorrentContentModelFolder *m_parentItem = nullptr;
+    int m_row = 0; // children are never reordered so the row is assigned once when appended to the parent
     // Root item members
     QVector<QString> m_itemData;
     // Non-root item members
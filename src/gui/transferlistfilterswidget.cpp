@@ -31,6 +31,7 @@
 #include <QCheckBox>
 #include <QIcon>
 #include <QListWidgetItem>
+#include <QLocale>
 #include <QMenu>
 #include <QPainter>
 #include <QScrollArea>
@@ -41,6 +42,7 @@
 #include "base/algorithm.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/torrent.h"
+#include "base/bittorrent/trackerhoststatistics.h"
 #include "base/global.h"
 #include "base/logger.h"
 #include "base/net/downloadmanager.h"
@@ -70,6 +72,15 @@ namespace
         return !scheme.isEmpty() ? scheme : u"http"_qs;
     }
 
+    QString getDomain(const QString &host)
+    {
+        // host is in IP format
+        if (!QHostAddress(host).isNull())
+            return host;
+
+        return host.section(u'.', -2, -1);
+    }
+
     QString getHost(const QString &url)
     {
         // We want the domain + tld. Subdomains should be disregarded
@@ -79,11 +90,7 @@ namespace
         if (host.isEmpty())
             return url;
 
-        // host is in IP format
-        if (!QHostAddress(host).isNull())
-            return host;
-
-        return host.section(u'.', -2, -1);
+        return getDomain(host);
     }
 
     class ArrowCheckBox final : public QCheckBox
@@ -417,6 +424,11 @@ void TrackerFiltersList::refreshTrackers(const BitTorrent::Torrent *torrent)
     m_errors.remove(torrentID);
     m_warnings.remove(torrentID);
 
+    Algorithm::removeIf(m_trackerURLs, [&torrentID](const QString &, TrackerURLData &urlData)
+    {
+        return (urlData.torrents.remove(torrentID) && urlData.torrents.isEmpty());
+    });
+
     Algorithm::removeIf(m_trackers, [this, &torrentID](const QString &host, TrackerData &trackerData)
     {
         QSet<BitTorrent::TorrentID> &torrentIDs = trackerData.torrents;
@@ -462,7 +474,14 @@ void TrackerFiltersList::changeTrackerless(const BitTorrent::Torrent *torrent, c
 
 void TrackerFiltersList::addItems(const QString &trackerURL, const QVector<BitTorrent::TorrentID> &torrents)
 {
-    const QString host = getHost(trackerURL);
+    // Tracker URLs are shared between many torrents, so parse each of them only once
+    auto urlIter = m_trackerURLs.find(trackerURL);
+    if (urlIter == m_trackerURLs.end())
+        urlIter = m_trackerURLs.insert(trackerURL, {getHost(trackerURL), {}});
+    for (const BitTorrent::TorrentID &torrentID : torrents)
+        urlIter->torrents.insert(torrentID);
+
+    const QString host = urlIter->host;
     auto trackersIt = m_trackers.find(host);
     const bool exists = (trackersIt != m_trackers.end());
     QListWidgetItem *trackerItem = nullptr;
@@ -514,9 +533,22 @@ void TrackerFiltersList::addItems(const QString &trackerURL, const QVector<BitTo
 
 void TrackerFiltersList::removeItem(const QString &trackerURL, const BitTorrent::TorrentID &id)
 {
-    const QString host = getHost(trackerURL);
+    const QString host = trackerHost(trackerURL);
 
-    QSet<BitTorrent::TorrentID> torrentIDs = m_trackers.value(host).torrents;
+    // forget the URL once no torrent uses it
+    if (const auto urlIter = m_trackerURLs.find(trackerURL); urlIter != m_trackerURLs.end())
+    {
+        urlIter->torrents.remove(id);
+        if (urlIter->torrents.isEmpty())
+            m_trackerURLs.erase(urlIter);
+    }
+
+    const auto trackersIt = m_trackers.find(host);
+    if (trackersIt == m_trackers.end())
+        return;
+
+    // modify torrents set in place to avoid copying it for each removed torrent
+    QSet<BitTorrent::TorrentID> &torrentIDs = trackersIt->torrents;
     torrentIDs.remove(id);
 
     QListWidgetItem *trackerItem = nullptr;
@@ -552,14 +584,14 @@ void TrackerFiltersList::removeItem(const QString &trackerURL, const BitTorrent:
             }
         }
 
-        trackerItem = m_trackers.value(host).item;
+        trackerItem = trackersIt->item;
 
         if (torrentIDs.isEmpty())
         {
             if (currentItem() == trackerItem)
                 setCurrentRow(0, QItemSelectionModel::SelectCurrent);
             delete trackerItem;
-            m_trackers.remove(host);
+            m_trackers.erase(trackersIt);
             updateGeometry();
             return;
         }
@@ -573,8 +605,6 @@ void TrackerFiltersList::removeItem(const QString &trackerURL, const BitTorrent:
         trackerItem->setText(tr("Trackerless (%1)").arg(torrentIDs.size()));
     }
 
-    m_trackers.insert(host, {torrentIDs, trackerItem});
-
     if (currentItem() == trackerItem)
         applyFilter(currentRow());
 }
@@ -599,51 +629,53 @@ void TrackerFiltersList::setDownloadTrackerFavicon(bool value)
     }
 }
 
-void TrackerFiltersList::handleTrackerEntriesUpdated(const BitTorrent::Torrent *torrent
-        , const QHash<QString, BitTorrent::TrackerEntry> &updatedTrackerEntries)
+void TrackerFiltersList::handleTrackerEntriesUpdated(const QHash<BitTorrent::Torrent *, QHash<QString, BitTorrent::TrackerEntry>> &updateInfos)
 {
-    const BitTorrent::TorrentID id = torrent->id();
+    for (auto torrentsIt = updateInfos.cbegin(); torrentsIt != updateInfos.cend(); ++torrentsIt)
+    {
+        const BitTorrent::TorrentID id = torrentsIt.key()->id();
 
-    auto errorHashesIt = m_errors.find(id);
-    auto warningHashesIt = m_warnings.find(id);
+        auto errorHashesIt = m_errors.find(id);
+        auto warningHashesIt = m_warnings.find(id);
 
-    for (const BitTorrent::TrackerEntry &trackerEntry : updatedTrackerEntries)
-    {
-        if (trackerEntry.status == BitTorrent::TrackerEntry::Working)
+        for (const BitTorrent::TrackerEntry &trackerEntry : torrentsIt.value())
         {
-            if (errorHashesIt != m_errors.end())
+            if (trackerEntry.status == BitTorrent::TrackerEntry::Working)
             {
-                QSet<QString> &errored = errorHashesIt.value();
-                errored.remove(trackerEntry.url);
-            }
+                if (errorHashesIt != m_errors.end())
+                {
+                    QSet<QString> &errored = errorHashesIt.value();
+                    errored.remove(trackerEntry.url);
+                }
 
-            if (trackerEntry.message.isEmpty())
-            {
-                if (warningHashesIt != m_warnings.end())
+                if (trackerEntry.message.isEmpty())
                 {
-                    QSet<QString> &warned = *warningHashesIt;
-                    warned.remove(trackerEntry.url);
+                    if (warningHashesIt != m_warnings.end())
+                    {
+                        QSet<QString> &warned = *warningHashesIt;
+                        warned.remove(trackerEntry.url);
+                    }
+                }
+                else
+                {
+                    if (warningHashesIt == m_warnings.end())
+                        warningHashesIt = m_warnings.insert(id, {});
+                    warningHashesIt.value().insert(trackerEntry.url);
                 }
             }
-            else
+            else if (trackerEntry.status == BitTorrent::TrackerEntry::NotWorking)
             {
-                if (warningHashesIt == m_warnings.end())
-                    warningHashesIt = m_warnings.insert(id, {});
-                warningHashesIt.value().insert(trackerEntry.url);
+                if (errorHashesIt == m_errors.end())
+                    errorHashesIt = m_errors.insert(id, {});
+                errorHashesIt.value().insert(trackerEntry.url);
             }
         }
-        else if (trackerEntry.status == BitTorrent::TrackerEntry::NotWorking)
-        {
-            if (errorHashesIt == m_errors.end())
-                errorHashesIt = m_errors.insert(id, {});
-            errorHashesIt.value().insert(trackerEntry.url);
-        }
-    }
 
-    if ((errorHashesIt != m_errors.end()) && errorHashesIt.value().isEmpty())
-        m_errors.erase(errorHashesIt);
-    if ((warningHashesIt != m_warnings.end()) && warningHashesIt.value().isEmpty())
-        m_warnings.erase(warningHashesIt);
+        if ((errorHashesIt != m_errors.end()) && errorHashesIt.value().isEmpty())
+            m_errors.erase(errorHashesIt);
+        if ((warningHashesIt != m_warnings.end()) && warningHashesIt.value().isEmpty())
+            m_warnings.erase(warningHashesIt);
+    }
 
     item(ERROR_ROW)->setText(tr("Error (%1)").arg(m_errors.size()));
     item(WARNING_ROW)->setText(tr("Warning (%1)").arg(m_warnings.size()));
@@ -652,6 +684,43 @@ void TrackerFiltersList::handleTrackerEntriesUpdated(const BitTorrent::Torrent *
         applyFilter(ERROR_ROW);
     else if (currentRow() == WARNING_ROW)
         applyFilter(WARNING_ROW);
+
+    updateTrackerHostsToolTips();
+}
+
+void TrackerFiltersList::updateTrackerHostsToolTips()
+{
+    QHash<QString, QStringList> toolTips;  // <tracker host, tooltips of its subdomains>
+    for (const BitTorrent::TrackerHostStatus &status : asConst(BitTorrent::Session::instance()->trackerHostStatuses()))
+    {
+        QStringList lines {tr("%1: %2% of announces succeeded")
+                .arg(status.host, QString::number((status.successRate * 100), 'f', 0))};
+        if (status.latencyP50 >= 0)
+        {
+            lines.append(tr("Reply time: %1 ms (median), %2 ms (90th percentile), %3 ms (99th percentile)")
+                    .arg(QString::number(status.latencyP50), QString::number(status.latencyP90), QString::number(status.latencyP99)));
+        }
+        if (status.failureStreak > 0)
+            lines.append(tr("Consecutive failures: %1").arg(status.failureStreak));
+        if (status.backoffEnd.isValid())
+            lines.append(tr("Announces postponed until %1").arg(QLocale().toString(status.backoffEnd, QLocale::ShortFormat)));
+        if (!status.lastError.isEmpty())
+            lines.append(tr("Last error: %1").arg(status.lastError));
+
+        toolTips[getDomain(status.host)].append(lines.join(u'\n'));
+    }
+
+    for (auto iter = m_trackers.cbegin(); iter != m_trackers.cend(); ++iter)
+    {
+        if (!iter.key().isEmpty() && iter->item)
+            iter->item->setToolTip(toolTips.value(iter.key()).join(u"\n\n"_qs));
+    }
+}
+
+QString TrackerFiltersList::trackerHost(const QString &trackerURL) const
+{
+    const auto iter = m_trackerURLs.constFind(trackerURL);
+    return (iter != m_trackerURLs.cend()) ? iter->host : getHost(trackerURL);
 }
 
 void TrackerFiltersList::downloadFavicon(const QString &url)
@@ -912,10 +981,9 @@ void TransferListFiltersWidget::changeTrackerless(const BitTorrent::Torrent *tor
     m_trackerFilters->changeTrackerless(torrent, trackerless);
 }
 
-void TransferListFiltersWidget::trackerEntriesUpdated(const BitTorrent::Torrent *torrent
-        , const QHash<QString, BitTorrent::TrackerEntry> &updatedTrackerEntries)
+void TransferListFiltersWidget::trackerEntriesUpdated(const QHash<BitTorrent::Torrent *, QHash<QString, BitTorrent::TrackerEntry>> &updateInfos)
 {
-    m_trackerFilters->handleTrackerEntriesUpdated(torrent, updatedTrackerEntries);
+    m_trackerFilters->handleTrackerEntriesUpdated(updateInfos);
 }
 
 void TransferListFiltersWidget::onCategoryFilterStateChanged(bool enabled)
@@ -131,8 +131,7 @@ public:
     void removeTrackers(const BitTorrent::Torrent *torrent, const QStringList &trackers);
     void refreshTrackers(const BitTorrent::Torrent *torrent);
     void changeTrackerless(const BitTorrent::Torrent *torrent, bool trackerless);
-    void handleTrackerEntriesUpdated(const BitTorrent::Torrent *torrent
-            , const QHash<QString, BitTorrent::TrackerEntry> &updatedTrackerEntries);
+    void handleTrackerEntriesUpdated(const QHash<BitTorrent::Torrent *, QHash<QString, BitTorrent::TrackerEntry>> &updateInfos);
     void setDownloadTrackerFavicon(bool value);
 
 private slots:
@@ -151,6 +150,8 @@ private:
     QString trackerFromRow(int row) const;
     int rowFromTracker(const QString &tracker) const;
     QSet<BitTorrent::TorrentID> getTorrentIDs(int row) const;
+    QString trackerHost(const QString &trackerURL) const;
+    void updateTrackerHostsToolTips();
     void downloadFavicon(const QString &url);
 
     struct TrackerData
@@ -159,7 +160,14 @@ private:
         QListWidgetItem *item = nullptr;
     };
 
+    struct TrackerURLData
+    {
+        QString host;
+        QSet<BitTorrent::TorrentID> torrents;
+    };
+
     QHash<QString, TrackerData> m_trackers;   // <tracker host, tracker data>
+    QHash<QString, TrackerURLData> m_trackerURLs;  // <tracker URL, tracker URL data>
     QHash<BitTorrent::TorrentID, QSet<QString>> m_errors;  // <torrent ID, tracker hosts>
     QHash<BitTorrent::TorrentID, QSet<QString>> m_warnings;  // <torrent ID, tracker hosts>
     PathList m_iconPaths;
@@ -181,8 +189,7 @@ public slots:
     void removeTrackers(const BitTorrent::Torrent *torrent, const QStringList &trackers);
     void refreshTrackers(const BitTorrent::Torrent *torrent);
     void changeTrackerless(const BitTorrent::Torrent *torrent, bool trackerless);
-    void trackerEntriesUpdated(const BitTorrent::Torrent *torrent
-            , const QHash<QString, BitTorrent::TrackerEntry> &updatedTrackerEntries);
+    void trackerEntriesUpdated(const QHash<BitTorrent::Torrent *, QHash<QString, BitTorrent::TrackerEntry>> &updateInfos);
 
 private slots:
     void onCategoryFilterStateChanged(bool enabled);
@@ -587,10 +587,13 @@ bool TransferListModel::setData(const QModelIndex &index, const QVariant &value,
 
 void TransferListModel::addTorrents(const QVector<BitTorrent::Torrent *> &torrents)
 {
+    if (torrents.isEmpty())
+        return;
+
     qsizetype row = m_torrentList.size();
     const qsizetype total = row + torrents.size();
 
-    beginInsertRows({}, row, total);
+    beginInsertRows({}, row, (total - 1));
 
     m_torrentList.reserve(total);
     for (BitTorrent::Torrent *torrent : torrents)
@@ -627,11 +630,9 @@ void TransferListModel::handleTorrentAboutToBeRemoved(BitTorrent::Torrent *const
     beginRemoveRows({}, row, row);
     m_torrentList.removeAt(row);
     m_torrentMap.remove(torrent);
-    for (int &value : m_torrentMap)
-    {
-        if (value > row)
-            --value;
-    }
+    // only the rows following the removed one are shifted
+    for (int i = row; i < m_torrentList.size(); ++i)
+        m_torrentMap[m_torrentList[i]] = i;
     endRemoveRows();
 }
 
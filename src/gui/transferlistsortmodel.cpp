@@ -28,6 +28,7 @@
 
 #include "transferlistsortmodel.h"
 
+#include <algorithm>
 #include <type_traits>
 
 #include <QDateTime>
@@ -38,6 +39,21 @@
 
 namespace
 {
+    bool isNaturallySorted(const int column)
+    {
+        switch (column)
+        {
+        case TransferListModel::TR_CATEGORY:
+        case TransferListModel::TR_DOWNLOAD_PATH:
+        case TransferListModel::TR_NAME:
+        case TransferListModel::TR_SAVE_PATH:
+        case TransferListModel::TR_TRACKER:
+            return true;
+        default:
+            return false;
+        }
+    }
+
     template <typename T>
     int threeWayCompare(const T &left, const T &right)
     {
@@ -99,6 +115,30 @@ TransferListSortModel::TransferListSortModel(QObject *parent)
     setSortRole(TransferListModel::UnderlyingDataRole);
 }
 
+void TransferListSortModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    if (this->sourceModel())
+    {
+        disconnect(this->sourceModel(), &QAbstractItemModel::dataChanged, this, &TransferListSortModel::handleSourceDataChanged);
+        disconnect(this->sourceModel(), &QAbstractItemModel::rowsAboutToBeRemoved, this, &TransferListSortModel::handleSourceRowsAboutToBeRemoved);
+        disconnect(this->sourceModel(), &QAbstractItemModel::modelAboutToBeReset, this, &TransferListSortModel::handleSourceModelAboutToBeReset);
+    }
+
+    m_sortKeys.clear();
+    m_visibleTorrents.clear();
+
+    // the cached data must be invalidated before the base class re-sorts and re-filters the changed rows,
+    // so these connections are made prior to the ones of QSortFilterProxyModel
+    if (sourceModel)
+    {
+        connect(sourceModel, &QAbstractItemModel::dataChanged, this, &TransferListSortModel::handleSourceDataChanged);
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &TransferListSortModel::handleSourceRowsAboutToBeRemoved);
+        connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, &TransferListSortModel::handleSourceModelAboutToBeReset);
+    }
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
 void TransferListSortModel::sort(const int column, const Qt::SortOrder order)
 {
     if ((m_lastSortColumn != column) && (m_lastSortColumn != -1))
@@ -154,20 +194,40 @@ void TransferListSortModel::disableTrackerFilter()
         invalidateFilter();
 }
 
+QVector<BitTorrent::Torrent *> TransferListSortModel::visibleTorrents() const
+{
+    return {m_visibleTorrents.cbegin(), m_visibleTorrents.cend()};
+}
+
+QVariant TransferListSortModel::sortKey(const QModelIndex &sourceIndex) const
+{
+    QVector<QVariant> &keys = m_sortKeys[sourceIndex.column()];
+    if (keys.size() <= sourceIndex.row())
+        keys.resize(sourceModel()->rowCount());
+
+    QVariant &key = keys[sourceIndex.row()];
+    if (!key.isValid())
+    {
+        const QVariant value = sourceIndex.data(TransferListModel::UnderlyingDataRole);
+        // string columns cache their collation key so comparisons don't have to collate the strings again
+        key = isNaturallySorted(sourceIndex.column())
+            ? QVariant::fromValue(m_naturalCompare.sortKey(value.toString()))
+            : value;
+    }
+    return key;
+}
+
 int TransferListSortModel::compare(const QModelIndex &left, const QModelIndex &right) const
 {
     const int compareColumn = left.column();
-    const QVariant leftValue = left.data(TransferListModel::UnderlyingDataRole);
-    const QVariant rightValue = right.data(TransferListModel::UnderlyingDataRole);
+    const QVariant leftValue = sortKey(left);
+    const QVariant rightValue = sortKey(right);
+
+    if (isNaturallySorted(compareColumn))
+        return leftValue.value<Utils::Compare::NaturalSortKey>().compare(rightValue.value<Utils::Compare::NaturalSortKey>());
 
     switch (compareColumn)
     {
-    case TransferListModel::TR_CATEGORY:
-    case TransferListModel::TR_DOWNLOAD_PATH:
-    case TransferListModel::TR_NAME:
-    case TransferListModel::TR_SAVE_PATH:
-    case TransferListModel::TR_TRACKER:
-        return m_naturalCompare(leftValue.toString(), rightValue.toString());
 
     case TransferListModel::TR_INFOHASH_V1:
         return threeWayCompare(leftValue.value<SHA1Hash>(), rightValue.value<SHA1Hash>());
@@ -254,17 +314,49 @@ bool TransferListSortModel::lessThan(const QModelIndex &left, const QModelIndex
 
 bool TransferListSortModel::filterAcceptsRow(const int sourceRow, const QModelIndex &sourceParent) const
 {
-    return matchFilter(sourceRow, sourceParent)
-           && QSortFilterProxyModel::filterAcceptsRow(sourceRow, sourceParent);
+    const auto *model = qobject_cast<TransferListModel *>(sourceModel());
+    if (!model) return false;
+
+    BitTorrent::Torrent *torrent = model->torrentHandle(model->index(sourceRow, 0, sourceParent));
+    if (!torrent) return false;
+
+    const bool isAccepted = m_filter.match(torrent)
+            && QSortFilterProxyModel::filterAcceptsRow(sourceRow, sourceParent);
+    if (isAccepted)
+        m_visibleTorrents.insert(torrent);
+    else
+        m_visibleTorrents.remove(torrent);
+    return isAccepted;
+}
+
+void TransferListSortModel::handleSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    for (auto iter = m_sortKeys.begin(); iter != m_sortKeys.end(); ++iter)
+    {
+        if ((iter.key() < topLeft.column()) || (iter.key() > bottomRight.column()))
+            continue;
+
+        QVector<QVariant> &keys = iter.value();
+        const int lastRow = std::min(bottomRight.row(), static_cast<int>(keys.size() - 1));
+        for (int row = topLeft.row(); row <= lastRow; ++row)
+            keys[row] = {};
+    }
 }
 
-bool TransferListSortModel::matchFilter(const int sourceRow, const QModelIndex &sourceParent) const
+void TransferListSortModel::handleSourceRowsAboutToBeRemoved(const QModelIndex &parent, const int first, const int last)
 {
+    // row numbers are shifted so the cached sort keys are no longer valid
+    m_sortKeys.clear();
+
     const auto *model = qobject_cast<TransferListModel *>(sourceModel());
-    if (!model) return false;
+    if (!model) return;
 
-    const BitTorrent::Torrent *torrent = model->torrentHandle(model->index(sourceRow, 0, sourceParent));
-    if (!torrent) return false;
+    for (int row = first; row <= last; ++row)
+        m_visibleTorrents.remove(model->torrentHandle(model->index(row, 0, parent)));
+}
 
-    return m_filter.match(torrent);
+void TransferListSortModel::handleSourceModelAboutToBeReset()
+{
+    m_sortKeys.clear();
+    m_visibleTorrents.clear();
 }
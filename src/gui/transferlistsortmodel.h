@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <QHash>
+#include <QSet>
 #include <QSortFilterProxyModel>
+#include <QVector>
 
 #include "base/settingvalue.h"
 #include "base/torrentfilter.h"
@@ -37,6 +40,7 @@
 namespace BitTorrent
 {
     class InfoHash;
+    class Torrent;
 }
 
 class TransferListSortModel final : public QSortFilterProxyModel
@@ -47,8 +51,12 @@ class TransferListSortModel final : public QSortFilterProxyModel
 public:
     explicit TransferListSortModel(QObject *parent = nullptr);
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
     void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
 
+    // torrents accepted by the filter, in no particular order
+    QVector<BitTorrent::Torrent *> visibleTorrents() const;
+
     void setStatusFilter(TorrentFilter::Type filter);
     void setCategoryFilter(const QString &category);
     void disableCategoryFilter();
@@ -59,10 +67,14 @@ public:
 
 private:
     int compare(const QModelIndex &left, const QModelIndex &right) const;
+    QVariant sortKey(const QModelIndex &sourceIndex) const;
 
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
     bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
-    bool matchFilter(int sourceRow, const QModelIndex &sourceParent) const;
+
+    void handleSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void handleSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void handleSourceModelAboutToBeReset();
 
     TorrentFilter m_filter;
     CachedSettingValue<int> m_subSortColumn;
@@ -71,4 +83,8 @@ private:
     int m_lastSortOrder = 0;
 
     Utils::Compare::NaturalCompare<Qt::CaseInsensitive> m_naturalCompare;
+
+    // sort keys are fetched from the source model once per changed row instead of once per comparison
+    mutable QHash<int, QVector<QVariant>> m_sortKeys; // column -> sort keys of the source rows
+    mutable QSet<BitTorrent::Torrent *> m_visibleTorrents; // updated every time the filter is applied to a row
 };
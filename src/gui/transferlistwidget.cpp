@@ -319,13 +319,7 @@ QVector<BitTorrent::Torrent *> TransferListWidget::getSelectedTorrents() const
 
 QVector<BitTorrent::Torrent *> TransferListWidget::getVisibleTorrents() const
 {
-    const int visibleTorrentsCount = m_sortFilterModel->rowCount();
-
-    QVector<BitTorrent::Torrent *> torrents;
-    torrents.reserve(visibleTorrentsCount);
-    for (int i = 0; i < visibleTorrentsCount; ++i)
-        torrents << m_listModel->torrentHandle(mapToSource(m_sortFilterModel->index(i, 0)));
-    return torrents;
+    return m_sortFilterModel->visibleTorrents();
 }
 
 void TransferListWidget::setSelectedTorrentsLocation()
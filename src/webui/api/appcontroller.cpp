@@ -44,9 +44,11 @@
 #include <QTimer>
 #include <QTranslator>
 
+#include "base/bittorrent/memorystatus.h"
 #include "base/bittorrent/session.h"
 #include "base/global.h"
 #include "base/interfaces/iapplication.h"
+#include "base/net/downloadmanager.h"
 #include "base/net/portforwarder.h"
 #include "base/net/proxyconfigurationmanager.h"
 #include "base/path.h"
@@ -223,6 +225,7 @@ void AppController::preferencesAction()
     data[u"limit_utp_rate"_qs] = session->isUTPRateLimited();
     data[u"limit_tcp_overhead"_qs] = session->includeOverheadInLimits();
     data[u"limit_lan_peers"_qs] = !session->ignoreLimitsOnLAN();
+    data[u"upload_allocation_enabled"_qs] = session->isUploadAllocationEnabled();
     // Scheduling
     data[u"scheduler_enabled"_qs] = session->isBandwidthSchedulerEnabled();
     const QTime start_time = pref->getSchedulerStartTime();
@@ -251,6 +254,8 @@ void AppController::preferencesAction()
     data[u"slow_torrent_dl_rate_threshold"_qs] = session->downloadRateForSlowTorrents();
     data[u"slow_torrent_ul_rate_threshold"_qs] = session->uploadRateForSlowTorrents();
     data[u"slow_torrent_inactive_timer"_qs] = session->slowTorrentsInactivityTimer();
+    data[u"dynamic_queueing_enabled"_qs] = session->isDynamicQueueingEnabled();
+    data[u"dynamic_queueing_interval"_qs] = session->dynamicQueueingInterval();
     // Share Ratio Limiting
     data[u"max_ratio_enabled"_qs] = (session->globalMaxRatio() >= 0.);
     data[u"max_ratio"_qs] = session->globalMaxRatio();
@@ -398,6 +403,8 @@ void AppController::preferencesAction()
     data[u"announce_ip"_qs] = session->announceIP();
     data[u"max_concurrent_http_announces"_qs] = session->maxConcurrentHTTPAnnounces();
     data[u"stop_tracker_timeout"_qs] = session->stopTrackerTimeout();
+    data[u"announce_jitter_window"_qs] = session->announceJitterWindow();
+    data[u"max_announces_per_tracker_host"_qs] = session->maxAnnouncesPerTrackerHost();
     // Peer Turnover
     data[u"peer_turnover"_qs] = session->peerTurnover();
     data[u"peer_turnover_cutoff"_qs] = session->peerTurnoverCutoff();
@@ -664,6 +671,8 @@ void AppController::setPreferencesAction()
         session->setIncludeOverheadInLimits(it.value().toBool());
     if (hasKey(u"limit_lan_peers"_qs))
         session->setIgnoreLimitsOnLAN(!it.value().toBool());
+    if (hasKey(u"upload_allocation_enabled"_qs))
+        session->setUploadAllocationEnabled(it.value().toBool());
     // Scheduling
     if (hasKey(u"scheduler_enabled"_qs))
         session->setBandwidthSchedulerEnabled(it.value().toBool());
@@ -706,6 +715,10 @@ void AppController::setPreferencesAction()
         session->setUploadRateForSlowTorrents(it.value().toInt());
     if (hasKey(u"slow_torrent_inactive_timer"_qs))
         session->setSlowTorrentsInactivityTimer(it.value().toInt());
+    if (hasKey(u"dynamic_queueing_enabled"_qs))
+        session->setDynamicQueueingEnabled(it.value().toBool());
+    if (hasKey(u"dynamic_queueing_interval"_qs))
+        session->setDynamicQueueingInterval(it.value().toInt());
     // Share Ratio Limiting
     if (hasKey(u"max_ratio_enabled"_qs))
     {
@@ -967,6 +980,10 @@ void AppController::setPreferencesAction()
         session->setMaxConcurrentHTTPAnnounces(it.value().toInt());
     if (hasKey(u"stop_tracker_timeout"_qs))
         session->setStopTrackerTimeout(it.value().toInt());
+    if (hasKey(u"announce_jitter_window"_qs))
+        session->setAnnounceJitterWindow(it.value().toInt());
+    if (hasKey(u"max_announces_per_tracker_host"_qs))
+        session->setMaxAnnouncesPerTrackerHost(it.value().toInt());
     // Peer Turnover
     if (hasKey(u"peer_turnover"_qs))
         session->setPeerTurnover(it.value().toInt());
@@ -987,6 +1004,56 @@ void AppController::defaultSavePathAction()
     setResult(BitTorrent::Session::instance()->savePath().toString());
 }
 
+void AppController::memoryStatsAction()
+{
+    const BitTorrent::MemoryStatus memoryStatus = BitTorrent::Session::instance()->memoryStatus();
+    const QJsonObject result =
+    {
+        {u"torrents_count"_qs, memoryStatus.torrentsCount},
+        {u"total"_qs, memoryStatus.total()},
+        {u"native_status"_qs, memoryStatus.nativeStatus},
+        {u"pieces"_qs, memoryStatus.pieces},
+        {u"file_paths"_qs, memoryStatus.filePaths},
+        {u"file_priorities"_qs, memoryStatus.filePriorities},
+        {u"files_progress"_qs, memoryStatus.filesProgress},
+        {u"trackers"_qs, memoryStatus.trackers},
+        {u"url_seeds"_qs, memoryStatus.urlSeeds},
+        {u"add_torrent_params"_qs, memoryStatus.addTorrentParams},
+        {u"string_pool"_qs, memoryStatus.stringPool}
+    };
+    setResult(result);
+}
+
+// Returns the statistics of the web requests (e.g. RSS feeds, .torrent files, icons), grouped by host.
+// The keys of the returned map are "host:port", each value is a map with the keys:
+//  - "active": number of requests in progress
+//  - "queued": number of requests waiting for their turn
+//  - "finished": number of successful requests
+//  - "failed": number of failed requests, including the retried ones
+//  - "retried": number of retries
+//  - "downloaded": amount of data received
+void AppController::downloadStatsAction()
+{
+    const QHash<Net::ServiceID, Net::ServiceStatistics> statistics = Net::DownloadManager::instance()->serviceStatistics();
+
+    QJsonObject result;
+    for (auto it = statistics.cbegin(); it != statistics.cend(); ++it)
+    {
+        const Net::ServiceStatistics &serviceStatistics = it.value();
+        result[it.key().hostName + u':' + QString::number(it.key().port)] = QJsonObject
+        {
+            {u"active"_qs, serviceStatistics.activeRequests},
+            {u"queued"_qs, serviceStatistics.queuedRequests},
+            {u"finished"_qs, serviceStatistics.finishedRequests},
+            {u"failed"_qs, serviceStatistics.failedRequests},
+            {u"retried"_qs, serviceStatistics.retriedRequests},
+            {u"downloaded"_qs, serviceStatistics.bytesReceived}
+        };
+    }
+
+    setResult(result);
+}
+
 void AppController::networkInterfaceListAction()
 {
     QJsonArray ifaceList;
@@ -48,6 +48,8 @@ private slots:
     void preferencesAction();
     void setPreferencesAction();
     void defaultSavePathAction();
+    void memoryStatsAction();
+    void downloadStatsAction();
 
     void networkInterfaceListAction();
     void networkInterfaceAddressListAction();
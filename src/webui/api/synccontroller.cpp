@@ -43,6 +43,7 @@
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/sessionstatus.h"
 #include "base/bittorrent/torrent.h"
+#include "base/bittorrent/torrenteventbus.h"
 #include "base/bittorrent/torrentinfo.h"
 #include "base/bittorrent/trackerentry.h"
 #include "base/global.h"
@@ -344,6 +345,22 @@ namespace
         }
     }
 
+    QJsonArray toJsonArray(const QSet<QString> &strings)
+    {
+        QJsonArray array;
+        for (const QString &str : strings)
+            array.append(str);
+        return array;
+    }
+
+    QJsonArray toJsonArray(const QSet<BitTorrent::TorrentID> &torrentIDs)
+    {
+        QJsonArray array;
+        for (const BitTorrent::TorrentID &torrentID : torrentIDs)
+            array.append(torrentID.toString());
+        return array;
+    }
+
     QJsonObject generateSyncData(int acceptedResponseId, const QVariantMap &data, QVariantMap &lastAcceptedData, QVariantMap &lastData)
     {
         QVariantMap syncData;
@@ -518,7 +535,7 @@ void SyncController::makeMaindataSnapshot()
         for (const BitTorrent::TrackerEntry &tracker : asConst(torrent->trackers()))
             m_knownTrackers[tracker.url].insert(torrentID);
 
-        m_maindataSnapshot.torrents[torrentID.toString()] = serializedTorrent;
+        m_maindataSnapshot.torrents[torrentID] = serializedTorrent;
     }
 
     const QStringList categoriesList = session->categories();
@@ -533,16 +550,9 @@ void SyncController::makeMaindataSnapshot()
     }
 
     for (const QString &tag : asConst(session->tags()))
-        m_maindataSnapshot.tags.append(tag);
+        m_maindataSnapshot.tags.insert(tag);
 
-    for (auto trackersIter = m_knownTrackers.cbegin(); trackersIter != m_knownTrackers.cend(); ++trackersIter)
-    {
-        QStringList torrentIDs;
-        for (const BitTorrent::TorrentID &torrentID : asConst(trackersIter.value()))
-            torrentIDs.append(torrentID.toString());
-
-        m_maindataSnapshot.trackers[trackersIter.key()] = torrentIDs;
-    }
+    m_maindataSnapshot.trackers = m_knownTrackers;
 
     m_maindataSnapshot.serverState = getTransferInfo();
     m_maindataSnapshot.serverState[KEY_TRANSFER_FREESPACEONDISK] = getFreeDiskSpace();
@@ -555,22 +565,22 @@ QJsonObject SyncController::generateMaindataSyncData(const int id, const bool fu
 {
     // if need to update existing sync data
     for (const QString &category : asConst(m_updatedCategories))
-        m_maindataSyncBuf.removedCategories.removeOne(category);
+        m_maindataSyncBuf.removedCategories.remove(category);
     for (const QString &category : asConst(m_removedCategories))
         m_maindataSyncBuf.categories.remove(category);
 
     for (const QString &tag : asConst(m_addedTags))
-        m_maindataSyncBuf.removedTags.removeOne(tag);
+        m_maindataSyncBuf.removedTags.remove(tag);
     for (const QString &tag : asConst(m_removedTags))
-        m_maindataSyncBuf.tags.removeOne(tag);
+        m_maindataSyncBuf.tags.remove(tag);
 
     for (const BitTorrent::TorrentID &torrentID : asConst(m_updatedTorrents))
-        m_maindataSyncBuf.removedTorrents.removeOne(torrentID.toString());
+        m_maindataSyncBuf.removedTorrents.remove(torrentID);
     for (const BitTorrent::TorrentID &torrentID : asConst(m_removedTorrents))
-        m_maindataSyncBuf.torrents.remove(torrentID.toString());
+        m_maindataSyncBuf.torrents.remove(torrentID);
 
     for (const QString &tracker : asConst(m_updatedTrackers))
-        m_maindataSyncBuf.removedTrackers.removeOne(tracker);
+        m_maindataSyncBuf.removedTrackers.remove(tracker);
     for (const QString &tracker : asConst(m_removedTrackers))
         m_maindataSyncBuf.trackers.remove(tracker);
 
@@ -592,22 +602,22 @@ QJsonObject SyncController::generateMaindataSyncData(const int id, const bool fu
 
     for (const QString &category : asConst(m_removedCategories))
     {
-        m_maindataSyncBuf.removedCategories.append(category);
+        m_maindataSyncBuf.removedCategories.insert(category);
         m_maindataSnapshot.categories.remove(category);
     }
     m_removedCategories.clear();
 
     for (const QString &tag : asConst(m_addedTags))
     {
-        m_maindataSyncBuf.tags.append(tag);
-        m_maindataSnapshot.tags.append(tag);
+        m_maindataSyncBuf.tags.insert(tag);
+        m_maindataSnapshot.tags.insert(tag);
     }
     m_addedTags.clear();
 
     for (const QString &tag : asConst(m_removedTags))
     {
-        m_maindataSyncBuf.removedTags.append(tag);
-        m_maindataSnapshot.tags.removeOne(tag);
+        m_maindataSyncBuf.removedTags.insert(tag);
+        m_maindataSnapshot.tags.remove(tag);
     }
     m_removedTags.clear();
 
@@ -619,35 +629,30 @@ QJsonObject SyncController::generateMaindataSyncData(const int id, const bool fu
         QVariantMap serializedTorrent = serialize(*torrent);
         serializedTorrent.remove(KEY_TORRENT_ID);
 
-        auto &torrentSnapshot = m_maindataSnapshot.torrents[torrentID.toString()];
-        processMap(torrentSnapshot, serializedTorrent, m_maindataSyncBuf.torrents[torrentID.toString()]);
+        auto &torrentSnapshot = m_maindataSnapshot.torrents[torrentID];
+        processMap(torrentSnapshot, serializedTorrent, m_maindataSyncBuf.torrents[torrentID]);
         torrentSnapshot = serializedTorrent;
     }
     m_updatedTorrents.clear();
 
     for (const BitTorrent::TorrentID &torrentID : asConst(m_removedTorrents))
     {
-        m_maindataSyncBuf.removedTorrents.append(torrentID.toString());
-        m_maindataSnapshot.torrents.remove(torrentID.toString());
+        m_maindataSyncBuf.removedTorrents.insert(torrentID);
+        m_maindataSnapshot.torrents.remove(torrentID);
     }
     m_removedTorrents.clear();
 
     for (const QString &tracker : asConst(m_updatedTrackers))
     {
         const QSet<BitTorrent::TorrentID> torrentIDs = m_knownTrackers[tracker];
-        QStringList serializedTorrentIDs;
-        serializedTorrentIDs.reserve(torrentIDs.size());
-        for (const BitTorrent::TorrentID &torrentID : torrentIDs)
-            serializedTorrentIDs.append(torrentID.toString());
-
-        m_maindataSyncBuf.trackers[tracker] = serializedTorrentIDs;
-        m_maindataSnapshot.trackers[tracker] = serializedTorrentIDs;
+        m_maindataSyncBuf.trackers[tracker] = torrentIDs;
+        m_maindataSnapshot.trackers[tracker] = torrentIDs;
     }
     m_updatedTrackers.clear();
 
     for (const QString &tracker : asConst(m_removedTrackers))
     {
-        m_maindataSyncBuf.removedTrackers.append(tracker);
+        m_maindataSyncBuf.removedTrackers.insert(tracker);
         m_maindataSnapshot.trackers.remove(tracker);
     }
     m_removedTrackers.clear();
@@ -676,32 +681,32 @@ QJsonObject SyncController::generateMaindataSyncData(const int id, const bool fu
         syncData[KEY_CATEGORIES] = categories;
     }
     if (!m_maindataSyncBuf.removedCategories.isEmpty())
-        syncData[KEY_CATEGORIES_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedCategories);
+        syncData[KEY_CATEGORIES_REMOVED] = toJsonArray(m_maindataSyncBuf.removedCategories);
 
     if (!m_maindataSyncBuf.tags.isEmpty())
-        syncData[KEY_TAGS] = QJsonArray::fromVariantList(m_maindataSyncBuf.tags);
+        syncData[KEY_TAGS] = toJsonArray(m_maindataSyncBuf.tags);
     if (!m_maindataSyncBuf.removedTags.isEmpty())
-        syncData[KEY_TAGS_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedTags);
+        syncData[KEY_TAGS_REMOVED] = toJsonArray(m_maindataSyncBuf.removedTags);
 
     if (!m_maindataSyncBuf.torrents.isEmpty())
     {
         QJsonObject torrents;
         for (auto it = m_maindataSyncBuf.torrents.cbegin(); it != m_maindataSyncBuf.torrents.cend(); ++it)
-            torrents[it.key()] = QJsonObject::fromVariantMap(it.value());
+            torrents[it.key().toString()] = QJsonObject::fromVariantMap(it.value());
         syncData[KEY_TORRENTS] = torrents;
     }
     if (!m_maindataSyncBuf.removedTorrents.isEmpty())
-        syncData[KEY_TORRENTS_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedTorrents);
+        syncData[KEY_TORRENTS_REMOVED] = toJsonArray(m_maindataSyncBuf.removedTorrents);
 
     if (!m_maindataSyncBuf.trackers.isEmpty())
     {
         QJsonObject trackers;
         for (auto it = m_maindataSyncBuf.trackers.cbegin(); it != m_maindataSyncBuf.trackers.cend(); ++it)
-            trackers[it.key()] = QJsonArray::fromStringList(it.value());
+            trackers[it.key()] = toJsonArray(it.value());
         syncData[KEY_TRACKERS] = trackers;
     }
     if (!m_maindataSyncBuf.removedTrackers.isEmpty())
-        syncData[KEY_TRACKERS_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedTrackers);
+        syncData[KEY_TRACKERS_REMOVED] = toJsonArray(m_maindataSyncBuf.removedTrackers);
 
     if (!m_maindataSyncBuf.serverState.isEmpty())
         syncData[KEY_SERVER_STATE] = QJsonObject::fromVariantMap(m_maindataSyncBuf.serverState);
@@ -773,6 +778,50 @@ void SyncController::torrentPeersAction()
     setResult(generateSyncData(acceptedResponseId, data, m_lastAcceptedPeersResponse, m_lastPeersResponse));
 }
 
+// Returns the torrent lifecycle events published since the given one.
+// Return value is map in JSON format with the keys:
+//  - "events": list of events, oldest first
+//  - "last_id": ID of the latest event, to be passed as "last_known_id" on the next call
+//  - "lost": true if some events after "last_known_id" were dropped
+// Each event is a map with the keys:
+//  - "id": ID of the event
+//  - "type": one of "added", "metadata_received", "finished", "errored", "removed", "moved", "tracker_error"
+//  - "timestamp": seconds since epoch
+//  - "hash": torrent ID
+//  - "name": torrent name
+//  - "details": error message, new save path or tracker URL (optional)
+// GET params:
+//  - last_known_id (int): exclude events with id <= 'last_known_id' (default 0)
+//  - limit (int): maximum number of events to return (default 100)
+void SyncController::torrentEventsAction()
+{
+    const auto *eventBus = BitTorrent::TorrentEventBus::instance();
+    if (!eventBus)
+        throw APIError(APIErrorType::Conflict);
+
+    const qint64 lastKnownID = params()[u"last_known_id"_qs].toLongLong();
+    bool ok = false;
+    int limit = params()[u"limit"_qs].toInt(&ok);
+    if (!ok || (limit <= 0))
+        limit = 100;
+
+    bool eventsLost = false;
+    const QVector<BitTorrent::TorrentEvent> events = eventBus->events(lastKnownID, limit, &eventsLost);
+
+    QJsonArray jsonEvents;
+    for (const BitTorrent::TorrentEvent &event : events)
+        jsonEvents.append(event.toJSON());
+
+    // continue from the last returned event if the result was truncated by 'limit'
+    const qint64 lastID = events.isEmpty() ? eventBus->lastEventID() : events.last().id;
+    setResult(QJsonObject
+    {
+        {u"events"_qs, jsonEvents},
+        {u"last_id"_qs, lastID},
+        {u"lost"_qs, eventsLost}
+    });
+}
+
 qint64 SyncController::getFreeDiskSpace()
 {
     if (m_freeDiskSpaceElapsedTimer.hasExpired(FREEDISKSPACE_CHECK_TIMEOUT))
@@ -57,6 +57,7 @@ public:
 private slots:
     void maindataAction();
     void torrentPeersAction();
+    void torrentEventsAction();
 
 private:
     qint64 getFreeDiskSpace();
@@ -102,18 +103,19 @@ private:
     QSet<BitTorrent::TorrentID> m_updatedTorrents;
     QSet<BitTorrent::TorrentID> m_removedTorrents;
 
+    // torrents are keyed by their binary IDs, which are converted to strings only when the response is generated
     struct MaindataSyncBuf
     {
         QHash<QString, QVariantMap> categories;
-        QVariantList tags;
-        QHash<QString, QVariantMap> torrents;
-        QHash<QString, QStringList> trackers;
+        QSet<QString> tags;
+        QHash<BitTorrent::TorrentID, QVariantMap> torrents;
+        QHash<QString, QSet<BitTorrent::TorrentID>> trackers;
         QVariantMap serverState;
 
-        QStringList removedCategories;
-        QStringList removedTags;
-        QStringList removedTorrents;
-        QStringList removedTrackers;
+        QSet<QString> removedCategories;
+        QSet<QString> removedTags;
+        QSet<BitTorrent::TorrentID> removedTorrents;
+        QSet<QString> removedTrackers;
     };
 
     MaindataSyncBuf m_maindataSnapshot;
@@ -31,6 +31,7 @@
 #include <functional>
 
 #include <QBitArray>
+#include <QDateTime>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QList>
@@ -43,9 +44,11 @@
 #include "base/bittorrent/infohash.h"
 #include "base/bittorrent/peeraddress.h"
 #include "base/bittorrent/peerinfo.h"
+#include "base/bittorrent/pieceavailabilitystats.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/torrent.h"
 #include "base/bittorrent/torrentinfo.h"
+#include "base/bittorrent/torrenttransferhistory.h"
 #include "base/bittorrent/trackerentry.h"
 #include "base/global.h"
 #include "base/logger.h"
@@ -653,6 +656,58 @@ void TorrentsController::pieceStatesAction()
     setResult(pieceStates);
 }
 
+// Returns the summary of piece availability among the connected peers for a torrent.
+// The statistics are collected in background, so the first request for a torrent
+// returns an empty summary with "updated" equal to -1.
+// The return value is a JSON-formatted dictionary with the following keys:
+//   - "updated": Time (Unix Epoch) when the statistics were collected
+//   - "pieces": Number of pieces
+//   - "peers": Number of connected peers the statistics were collected from,
+//              the rarity of pieces is unknown and not counted when it is 0
+//   - "min_availability": Number of peers having the rarest piece
+//   - "avg_availability": Average number of peers having a piece
+//   - "histogram": Array of numbers of pieces available from 0, 1, 2... peers,
+//                  the last item includes pieces available from more peers
+//   - "runs": Availability of consecutive pieces as array of [availability, number of pieces]
+//   - "rare": Number of pieces available from one peer at most
+//   - "unavailable": Number of pieces not available from anyone
+//   - "rare_held": Number of rare pieces we have
+//   - "unique_held": Number of pieces which nobody but us has
+void TorrentsController::pieceAvailabilityAction()
+{
+    requireParams({u"hash"_qs});
+
+    const auto id = BitTorrent::TorrentID::fromString(params()[u"hash"_qs]);
+    BitTorrent::Session *const session = BitTorrent::Session::instance();
+    if (!session->getTorrent(id))
+        throw APIError(APIErrorType::NotFound);
+
+    const BitTorrent::PieceAvailabilityStats stats = session->pieceAvailabilityStats(id);
+
+    QJsonArray histogram;
+    for (const int piecesCount : asConst(stats.histogram))
+        histogram.append(piecesCount);
+
+    QJsonArray runs;
+    for (const BitTorrent::PieceAvailabilityRun &run : asConst(stats.runs))
+        runs.append(QJsonArray {run.availability, run.length});
+
+    setResult(QJsonObject
+    {
+        {u"updated"_qs, ((stats.updateTime > 0) ? stats.updateTime : -1)},
+        {u"pieces"_qs, stats.piecesCount},
+        {u"peers"_qs, stats.peersCount},
+        {u"min_availability"_qs, stats.minAvailability},
+        {u"avg_availability"_qs, stats.averageAvailability},
+        {u"histogram"_qs, histogram},
+        {u"runs"_qs, runs},
+        {u"rare"_qs, stats.rarePieces},
+        {u"unavailable"_qs, stats.unavailablePieces},
+        {u"rare_held"_qs, stats.rareHeldPieces},
+        {u"unique_held"_qs, stats.uniqueHeldPieces}
+    });
+}
+
 void TorrentsController::addAction()
 {
     const QString urls = params()[u"urls"_qs];
@@ -936,6 +991,40 @@ void TorrentsController::uploadLimitAction()
     setResult(map);
 }
 
+// Returns the amount of data transferred by torrents within the given time range.
+// The time range is extended to the boundaries of the history buckets it overlaps,
+// which are hours for the last week and days for older history.
+// Parameters:
+//   - "hashes": Hashes of the torrents separated by | or "all"
+//   - "from" (optional): Start of the range (Unix timestamp)
+//   - "to" (optional): End of the range (Unix timestamp), current time by default
+// The return value is a JSON-formatted dictionary of torrent hashes to dictionaries with the following keys:
+//   - "uploaded": Amount of data uploaded (bytes)
+//   - "downloaded": Amount of data downloaded (bytes)
+void TorrentsController::transferredAction()
+{
+    requireParams({u"hashes"_qs});
+
+    const QStringList idList {params()[u"hashes"_qs].split(u'|')};
+    const qint64 from = params()[u"from"_qs].toLongLong();
+    const qint64 to = params().contains(u"to"_qs)
+            ? params()[u"to"_qs].toLongLong()
+            : (QDateTime::currentSecsSinceEpoch() + 1);
+
+    QJsonObject result;
+    applyToTorrents(idList, [from, to, &result](const BitTorrent::Torrent *torrent)
+    {
+        const BitTorrent::TransferAmount amount = torrent->transferred(from, to);
+        result[torrent->id().toString()] = QJsonObject
+        {
+            {u"uploaded"_qs, amount.uploaded},
+            {u"downloaded"_qs, amount.downloaded}
+        };
+    });
+
+    setResult(result);
+}
+
 void TorrentsController::downloadLimitAction()
 {
     requireParams({u"hashes"_qs});
@@ -46,6 +46,7 @@ private slots:
     void filesAction();
     void pieceHashesAction();
     void pieceStatesAction();
+    void pieceAvailabilityAction();
     void resumeAction();
     void pauseAction();
     void recheckAction();
@@ -69,6 +70,7 @@ private slots:
     void addPeersAction();
     void filePrioAction();
     void uploadLimitAction();
+    void transferredAction();
     void downloadLimitAction();
     void setUploadLimitAction();
     void setDownloadLimitAction();
@@ -28,13 +28,20 @@
 
 #include "transfercontroller.h"
 
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QVector>
 
+#include "base/bittorrent/announcescheduler.h"
+#include "base/bittorrent/demandqueuescheduler.h"
 #include "base/bittorrent/peeraddress.h"
 #include "base/bittorrent/peerinfo.h"
+#include "base/bittorrent/pieceavailabilitystats.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/sessionstatus.h"
+#include "base/bittorrent/torrent.h"
+#include "base/bittorrent/trackerhoststatistics.h"
+#include "base/bittorrent/transferhistory.h"
 #include "base/global.h"
 #include "base/utils/string.h"
 #include "apierror.h"
@@ -143,3 +150,209 @@ void TransferController::banPeersAction()
             BitTorrent::Session::instance()->banIP(addr.ip.toString());
     }
 }
+
+// Returns the torrents waiting to be reannounced by the announce scheduler.
+// The return value is a JSON-formatted list of dictionaries.
+// The dictionary keys are:
+//   - "hash": Torrent hash
+//   - "name": Torrent name
+//   - "time": Scheduled announce time (Unix timestamp)
+//   - "priority": Whether the torrent is announced with priority
+void TransferController::announceQueueAction()
+{
+    const auto *session = BitTorrent::Session::instance();
+
+    QJsonArray result;
+    for (const BitTorrent::ScheduledAnnounce &scheduledAnnounce : asConst(session->scheduledAnnounces()))
+    {
+        const BitTorrent::Torrent *torrent = session->getTorrent(scheduledAnnounce.torrentID);
+        if (!torrent)
+            continue;
+
+        result.append(QJsonObject
+        {
+            {u"hash"_qs, scheduledAnnounce.torrentID.toString()},
+            {u"name"_qs, torrent->name()},
+            {u"time"_qs, scheduledAnnounce.time.toSecsSinceEpoch()},
+            {u"priority"_qs, scheduledAnnounce.isPriority}
+        });
+    }
+
+    setResult(result);
+}
+
+// Returns the announce statistics aggregated by tracker host.
+// The return value is a JSON-formatted list of dictionaries.
+// The dictionary keys are:
+//   - "host": Tracker host
+//   - "announces": Number of finished announces
+//   - "failures": Number of announces which failed to reach the tracker
+//   - "success_rate": Ratio of successful announces
+//   - "latency_p50", "latency_p90", "latency_p99": Reply time percentiles (ms), -1 if unknown
+//   - "failure_streak": Number of consecutive failed announces
+//   - "last_error": Last error message
+//   - "last_error_time": Time of the last error (Unix timestamp), -1 if there were no errors
+//   - "backoff_until": Time until announces to the host are postponed (Unix timestamp), -1 if not backed off
+void TransferController::trackerHostsAction()
+{
+    QJsonArray result;
+    for (const BitTorrent::TrackerHostStatus &status : asConst(BitTorrent::Session::instance()->trackerHostStatuses()))
+    {
+        result.append(QJsonObject
+        {
+            {u"host"_qs, status.host},
+            {u"announces"_qs, status.announces},
+            {u"failures"_qs, status.failures},
+            {u"success_rate"_qs, status.successRate},
+            {u"latency_p50"_qs, status.latencyP50},
+            {u"latency_p90"_qs, status.latencyP90},
+            {u"latency_p99"_qs, status.latencyP99},
+            {u"failure_streak"_qs, status.failureStreak},
+            {u"last_error"_qs, status.lastError},
+            {u"last_error_time"_qs, (status.lastErrorTime.isValid() ? status.lastErrorTime.toSecsSinceEpoch() : -1)},
+            {u"backoff_until"_qs, (status.backoffEnd.isValid() ? status.backoffEnd.toSecsSinceEpoch() : -1)}
+        });
+    }
+
+    setResult(result);
+}
+
+// Returns the ranking of seeding torrents computed by the dynamic queueing
+// for the current state, whether or not the dynamic queueing is enabled.
+// The return value is a JSON-formatted list of dictionaries ordered by rank.
+// The dictionary keys are:
+//   - "hash": Torrent hash
+//   - "name": Torrent name
+//   - "score": Demand score
+//   - "num_seeds": Number of seeds in the swarm
+//   - "num_leechs": Number of leechers in the swarm
+//   - "recent_upspeed": Average upload speed since the last rotation (bytes/s)
+//   - "active": Whether the torrent is active now
+//   - "should_be_active": Whether the torrent gets an active slot on the next rotation
+void TransferController::dynamicQueueingReportAction()
+{
+    const auto *session = BitTorrent::Session::instance();
+
+    QJsonArray result;
+    for (const BitTorrent::DemandQueueEntry &entry : asConst(session->dynamicQueueingReport()))
+    {
+        const BitTorrent::Torrent *torrent = session->getTorrent(entry.torrentID);
+        if (!torrent)
+            continue;
+
+        result.append(QJsonObject
+        {
+            {u"hash"_qs, entry.torrentID.toString()},
+            {u"name"_qs, torrent->name()},
+            {u"score"_qs, entry.score},
+            {u"num_seeds"_qs, entry.seeds},
+            {u"num_leechs"_qs, entry.leechers},
+            {u"recent_upspeed"_qs, entry.recentUploadRate},
+            {u"active"_qs, entry.isActive},
+            {u"should_be_active"_qs, entry.shouldBeActive}
+        });
+    }
+
+    setResult(result);
+}
+
+// Returns the torrents we have the data of which is rare among the connected peers,
+// ordered by the rareness of the data. The piece availability is collected in background,
+// so torrents appear in the list after their statistics are collected.
+// Parameters:
+//   - "limit" (optional): Maximum number of torrents to return
+// The return value is a JSON-formatted list of dictionaries.
+// The dictionary keys are:
+//   - "hash": Torrent hash
+//   - "name": Torrent name
+//   - "score": Share of the rare data in the torrent
+//   - "pieces": Number of pieces
+//   - "rare_held": Number of pieces we have which are available from one peer at most
+//   - "unique_held": Number of pieces which nobody but us has
+//   - "updated": Time (Unix Epoch) when the statistics were collected
+void TransferController::rareDataAction()
+{
+    auto *session = BitTorrent::Session::instance();
+    const int limit = params()[u"limit"_qs].toInt();
+
+    QJsonArray result;
+    for (const BitTorrent::PieceAvailabilityStats &stats : asConst(session->rareDataRanking()))
+    {
+        if ((limit > 0) && (result.size() >= limit))
+            break;
+
+        const BitTorrent::Torrent *torrent = session->getTorrent(stats.torrentID);
+        if (!torrent)
+            continue;
+
+        result.append(QJsonObject
+        {
+            {u"hash"_qs, stats.torrentID.toString()},
+            {u"name"_qs, torrent->name()},
+            {u"score"_qs, stats.rareDataScore()},
+            {u"pieces"_qs, stats.piecesCount},
+            {u"rare_held"_qs, stats.rareHeldPieces},
+            {u"unique_held"_qs, stats.uniqueHeldPieces},
+            {u"updated"_qs, stats.updateTime}
+        });
+    }
+
+    setResult(result);
+}
+
+// Returns the history of transfer rates.
+// Parameters:
+//   - "resolution" (optional): Time between samples, "second" (kept for the last hour),
+//                              "minute" (kept for the last day, default) or "hour" (kept for the last year)
+//   - "from" (optional): Time (Unix timestamp) of the oldest sample to return
+//   - "category" (optional): Category name to return payload rates of its torrents instead of the global rates
+// The return value is a JSON-formatted dictionary with the following keys:
+//   - "interval": Time between samples (seconds)
+//   - "start": Time (Unix timestamp) of the first sample
+//   - "metrics": Names of the rates in the samples
+//   - "samples": Array of samples ordered by time, each sample is an array of rates (bytes/s)
+void TransferController::historyAction()
+{
+    using BitTorrent::TransferHistory;
+
+    const auto *session = BitTorrent::Session::instance();
+
+    const QString resolutionParam = params()[u"resolution"_qs];
+    TransferHistory::Resolution resolution = TransferHistory::Resolution::Minute;
+    if (resolutionParam == u"second")
+        resolution = TransferHistory::Resolution::Second;
+    else if (resolutionParam == u"hour")
+        resolution = TransferHistory::Resolution::Hour;
+    else if (!resolutionParam.isEmpty() && (resolutionParam != u"minute"))
+        throw APIError(APIErrorType::BadParams, tr("'resolution': invalid argument"));
+
+    const QString category = params()[u"category"_qs];
+    if (!category.isEmpty() && !session->categories().contains(category))
+        throw APIError(APIErrorType::NotFound, tr("Category does not exist"));
+
+    const qint64 from = params()[u"from"_qs].toLongLong();
+    const BitTorrent::TransferHistorySeries series = session->transferHistory().series(resolution, from, category);
+
+    const QJsonArray metrics = category.isEmpty()
+            ? QJsonArray {u"upload"_qs, u"download"_qs, u"payload_upload"_qs, u"payload_download"_qs
+                , u"overhead_upload"_qs, u"overhead_download"_qs, u"dht_upload"_qs, u"dht_download"_qs
+                , u"tracker_upload"_qs, u"tracker_download"_qs}
+            : QJsonArray {u"payload_upload"_qs, u"payload_download"_qs};
+
+    QJsonArray samples;
+    for (int i = 0; i < series.samplesCount(); ++i)
+    {
+        QJsonArray sample;
+        for (int metric = 0; metric < series.metricsCount; ++metric)
+            sample.append(static_cast<qint64>(series.value(i, metric)));
+        samples.append(sample);
+    }
+
+    setResult(QJsonObject
+    {
+        {u"interval"_qs, series.interval},
+        {u"start"_qs, series.startTime},
+        {u"metrics"_qs, metrics},
+        {u"samples"_qs, samples}
+    });
+}
@@ -48,4 +48,9 @@ private slots:
     void setUploadLimitAction();
     void setDownloadLimitAction();
     void banPeersAction();
+    void announceQueueAction();
+    void trackerHostsAction();
+    void dynamicQueueingReportAction();
+    void rareDataAction();
+    void historyAction();
 };
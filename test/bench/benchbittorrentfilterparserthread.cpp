@@ -0,0 +1,101 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/filterparserthread.h"
+#include "base/global.h"
+#include "base/path.h"
+
+class BenchBitTorrentFilterParserThread final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchBitTorrentFilterParserThread)
+
+public:
+    BenchBitTorrentFilterParserThread() = default;
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_tmpDir.isValid());
+
+        // sized like the commonly used blocklists
+        QByteArray p2pData;
+        QByteArray datData;
+        for (int i = 0; i < RULES_COUNT; ++i)
+        {
+            const QByteArray startIP = QByteArray::number(1 + (i >> 16)) + '.' + QByteArray::number((i >> 8) & 0xFF)
+                + '.' + QByteArray::number(i & 0xFF) + ".0";
+            const QByteArray endIP = startIP.chopped(1) + "255";
+
+            p2pData += "Organization " + QByteArray::number(i) + ':' + startIP + '-' + endIP + '\n';
+            datData += startIP + " - " + endIP + " , 000 , Organization " + QByteArray::number(i) + '\n';
+        }
+
+        QVERIFY(writeFile(u"filter.p2p"_qs, p2pData));
+        QVERIFY(writeFile(u"filter.dat"_qs, datData));
+    }
+
+    void benchParse_data() const
+    {
+        QTest::addColumn<QString>("fileName");
+
+        QTest::newRow("p2p") << u"filter.p2p"_qs;
+        QTest::newRow("dat") << u"filter.dat"_qs;
+    }
+
+    void benchParse()
+    {
+        QFETCH(const QString, fileName);
+
+        const Path filePath {m_tmpDir.filePath(fileName)};
+        FilterParserThread parser;
+        QBENCHMARK
+        {
+            parser.processFilterFile(filePath);
+            parser.wait();
+        }
+    }
+
+private:
+    static const int RULES_COUNT = 200000;
+
+    bool writeFile(const QString &fileName, const QByteArray &data) const
+    {
+        QFile file {m_tmpDir.filePath(fileName)};
+        return file.open(QIODevice::WriteOnly) && (file.write(data) == data.size());
+    }
+
+    QTemporaryDir m_tmpDir;
+};
+
+QTEST_GUILESS_MAIN(BenchBitTorrentFilterParserThread)
+#include "benchbittorrentfilterparserthread.moc"
@@ -0,0 +1,76 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <vector>
+
+#include <QBitArray>
+#include <QTest>
+
+#include "base/bittorrent/pieceavailabilitystats.h"
+#include "base/global.h"
+
+class BenchBitTorrentPieceAvailabilityStats final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchBitTorrentPieceAvailabilityStats)
+
+public:
+    BenchBitTorrentPieceAvailabilityStats() = default;
+
+private slots:
+    void benchCompute_data() const
+    {
+        QTest::addColumn<int>("piecesCount");
+
+        QTest::newRow("1k pieces") << 1000;
+        QTest::newRow("100k pieces") << 100000;
+        QTest::newRow("1M pieces") << 1000000;
+    }
+
+    void benchCompute() const
+    {
+        QFETCH(const int, piecesCount);
+
+        // peers hold whole ranges of pieces so availability changes in steps
+        std::vector<int> availability(piecesCount);
+        QBitArray havePieces {piecesCount};
+        for (int i = 0; i < piecesCount; ++i)
+        {
+            availability[i] = ((i / 64) * 2654435761u) % 40;
+            havePieces.setBit(i, ((i % 3) != 0));
+        }
+
+        QBENCHMARK
+        {
+            BitTorrent::computePieceAvailabilityStats(availability, havePieces, 40);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(BenchBitTorrentPieceAvailabilityStats)
+#include "benchbittorrentpieceavailabilitystats.moc"
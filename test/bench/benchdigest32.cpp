@@ -0,0 +1,123 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QHash>
+#include <QStringList>
+#include <QTest>
+#include <QVector>
+
+#include "base/bittorrent/infohash.h"
+#include "base/global.h"
+
+class BenchDigest32 final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchDigest32)
+
+public:
+    BenchDigest32() = default;
+
+private slots:
+    void initTestCase()
+    {
+        // torrent IDs of a large session
+        m_ids.reserve(TORRENTS_COUNT);
+        m_idStrings.reserve(TORRENTS_COUNT);
+        for (int i = 0; i < TORRENTS_COUNT; ++i)
+        {
+            const QString idString = QString::number((0x10000000 + i), 16).repeated(5);
+            m_idStrings.append(idString);
+            m_ids.append(BitTorrent::TorrentID::fromString(idString));
+        }
+    }
+
+    void benchFromString() const
+    {
+        QBENCHMARK
+        {
+            for (const QString &idString : m_idStrings)
+                BitTorrent::TorrentID::fromString(idString);
+        }
+    }
+
+    void benchToString() const
+    {
+        QBENCHMARK
+        {
+            for (const BitTorrent::TorrentID &id : m_ids)
+                id.toString();
+        }
+    }
+
+    void benchHashLookup() const
+    {
+        QHash<BitTorrent::TorrentID, int> torrents;
+        torrents.reserve(m_ids.size());
+        for (int i = 0; i < m_ids.size(); ++i)
+            torrents.insert(m_ids[i], i);
+
+        QBENCHMARK
+        {
+            for (const BitTorrent::TorrentID &id : m_ids)
+                torrents.value(id);
+        }
+    }
+
+    void benchSyncCycle() const
+    {
+        // one WebAPI sync cycle: IDs are copied out of the session, looked up in the previous
+        // snapshot and serialized as keys of the response
+        QHash<BitTorrent::TorrentID, int> lastSnapshot;
+        lastSnapshot.reserve(m_ids.size());
+        for (int i = 0; i < m_ids.size(); ++i)
+            lastSnapshot.insert(m_ids[i], i);
+
+        QBENCHMARK
+        {
+            QHash<BitTorrent::TorrentID, int> snapshot;
+            snapshot.reserve(m_ids.size());
+            QStringList keys;
+            keys.reserve(m_ids.size());
+            for (const BitTorrent::TorrentID &id : m_ids)
+            {
+                const BitTorrent::TorrentID copy = id;
+                snapshot.insert(copy, lastSnapshot.value(copy));
+                keys.append(copy.toString());
+            }
+        }
+    }
+
+private:
+    static const int TORRENTS_COUNT = 100000;
+
+    QVector<BitTorrent::TorrentID> m_ids;
+    QStringList m_idStrings;
+};
+
+QTEST_APPLESS_MAIN(BenchDigest32)
+#include "benchdigest32.moc"
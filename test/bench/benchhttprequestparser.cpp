@@ -0,0 +1,92 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QTest>
+
+#include "base/global.h"
+#include "base/http/requestparser.h"
+
+class BenchHttpRequestParser final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchHttpRequestParser)
+
+public:
+    BenchHttpRequestParser() = default;
+
+private slots:
+    void benchParse_data() const
+    {
+        QTest::addColumn<QByteArray>("data");
+
+        const QByteArray headers = QByteArrayLiteral(
+            "Host: localhost:8080\r\n"
+            "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:109.0) Gecko/20100101 Firefox/118.0\r\n"
+            "Accept: */*\r\n"
+            "Accept-Language: en-US,en;q=0.5\r\n"
+            "Accept-Encoding: gzip, deflate, br\r\n"
+            "Referer: http://localhost:8080/\r\n"
+            "Cookie: SID=kD6sMdL1XLxW7pqbJg2R8Ftz0cUaHVnY\r\n"
+            "Connection: keep-alive\r\n");
+
+        QTest::newRow("GET sync") << QByteArray("GET /api/v2/sync/maindata?rid=42 HTTP/1.1\r\n" + headers + "\r\n");
+
+        QByteArray hashes = "hashes=";
+        for (int i = 0; i < 1000; ++i)
+            hashes += QByteArray::number((0x1000000 + i), 16).repeated(5) + "%7C";
+        QTest::newRow("POST urlencoded") << QByteArray("POST /api/v2/torrents/pause HTTP/1.1\r\n" + headers
+            + "Content-Type: application/x-www-form-urlencoded\r\n"
+            + "Content-Length: " + QByteArray::number(hashes.size()) + "\r\n\r\n" + hashes);
+
+        const QByteArray boundary = "----WebKitFormBoundary7MA4YWxkTrZu0gW";
+        const QByteArray torrentFile(256 * 1024, 'x');
+        const QByteArray body = "--" + boundary + "\r\n"
+            + "Content-Disposition: form-data; name=\"savepath\"\r\n\r\n/home/user/Downloads\r\n"
+            + "--" + boundary + "\r\n"
+            + "Content-Disposition: form-data; name=\"torrents\"; filename=\"file.torrent\"\r\n"
+            + "Content-Type: application/x-bittorrent\r\n\r\n" + torrentFile + "\r\n"
+            + "--" + boundary + "--\r\n";
+        QTest::newRow("POST multipart") << QByteArray("POST /api/v2/torrents/add HTTP/1.1\r\n" + headers
+            + "Content-Type: multipart/form-data; boundary=" + boundary + "\r\n"
+            + "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n" + body);
+    }
+
+    void benchParse() const
+    {
+        QFETCH(const QByteArray, data);
+
+        QCOMPARE(Http::RequestParser::parse(data).status, Http::RequestParser::ParseStatus::OK);
+        QBENCHMARK
+        {
+            Http::RequestParser::parse(data);
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(BenchHttpRequestParser)
+#include "benchhttprequestparser.moc"
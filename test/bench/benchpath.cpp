@@ -0,0 +1,112 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QTest>
+#include <QVector>
+
+#include "base/global.h"
+#include "base/path.h"
+
+class BenchPath final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchPath)
+
+public:
+    BenchPath() = default;
+
+private slots:
+    void initTestCase()
+    {
+        // file paths of a large multi-file torrent: 1000 folders, 100 files each
+        m_paths.reserve(FILES_COUNT);
+        for (int i = 0; i < FILES_COUNT; ++i)
+        {
+            m_paths.append(u"Collection/Season %1/Disc %2/Episode %3 - Title.mkv"_qs
+                .arg((i / 10000), 2, 10, QChar(u'0')).arg(((i / 100) % 100)).arg((i % 100), 3, 10, QChar(u'0')));
+        }
+    }
+
+    void benchConstruct() const
+    {
+        QBENCHMARK
+        {
+            for (const QString &pathStr : m_paths)
+                Path(pathStr);
+        }
+    }
+
+    void benchJoin() const
+    {
+        const Path basePath {u"/home/user/Downloads"_qs};
+        QBENCHMARK
+        {
+            for (const QString &pathStr : m_paths)
+                (basePath / Path(pathStr));
+        }
+    }
+
+    void benchParentPathAndFilename() const
+    {
+        QVector<Path> paths;
+        paths.reserve(m_paths.size());
+        for (const QString &pathStr : m_paths)
+            paths.append(Path(pathStr));
+
+        QBENCHMARK
+        {
+            for (const Path &path : asConst(paths))
+            {
+                path.parentPath();
+                path.filename();
+            }
+        }
+    }
+
+    void benchHasExtension() const
+    {
+        QVector<Path> paths;
+        paths.reserve(m_paths.size());
+        for (const QString &pathStr : m_paths)
+            paths.append(Path(pathStr));
+
+        QBENCHMARK
+        {
+            for (const Path &path : asConst(paths))
+                path.hasExtension(u".!qB");
+        }
+    }
+
+private:
+    static const int FILES_COUNT = 100000;
+
+    QStringList m_paths;
+};
+
+QTEST_APPLESS_MAIN(BenchPath)
+#include "benchpath.moc"
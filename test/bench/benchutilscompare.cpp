@@ -0,0 +1,127 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <QTest>
+
+#include "base/global.h"
+#include "base/utils/compare.h"
+
+class BenchUtilsCompare final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchUtilsCompare)
+
+public:
+    BenchUtilsCompare() = default;
+
+private slots:
+    void initTestCase()
+    {
+        // torrent names of a large session, with numbers to exercise the numeric mode
+        m_names.reserve(TORRENTS_COUNT);
+        for (int i = 0; i < TORRENTS_COUNT; ++i)
+        {
+            const int n = (i * 7919) % TORRENTS_COUNT;
+            m_names.append(u"Linux Distribution %1.%2 x86_64 (Build %3)"_qs.arg((n % 40)).arg((n % 12)).arg(n));
+        }
+    }
+
+    void benchSortCaseInsensitive() const
+    {
+        Utils::Compare::NaturalLessThan<Qt::CaseInsensitive> lessThan;
+        QBENCHMARK
+        {
+            QStringList names = m_names;
+            std::sort(names.begin(), names.end(), lessThan);
+        }
+    }
+
+    void benchSortCaseSensitive() const
+    {
+        Utils::Compare::NaturalLessThan<Qt::CaseSensitive> lessThan;
+        QBENCHMARK
+        {
+            QStringList names = m_names;
+            std::sort(names.begin(), names.end(), lessThan);
+        }
+    }
+
+    void benchSortKeyGeneration() const
+    {
+        const Utils::Compare::NaturalCompare<Qt::CaseInsensitive> compare;
+        QBENCHMARK
+        {
+            for (const QString &name : m_names)
+                compare.sortKey(name);
+        }
+    }
+
+    void benchSortByKeysCaseInsensitive() const
+    {
+        // keys are generated once per string, as a model caching them alongside its rows would do
+        const Utils::Compare::NaturalCompare<Qt::CaseInsensitive> compare;
+        QBENCHMARK
+        {
+            std::vector<std::pair<Utils::Compare::NaturalSortKey, QString>> entries;
+            entries.reserve(m_names.size());
+            for (const QString &name : m_names)
+                entries.emplace_back(compare.sortKey(name), name);
+            std::sort(entries.begin(), entries.end(), [](const auto &left, const auto &right)
+            {
+                return (left.first < right.first);
+            });
+        }
+    }
+
+    void benchSortByCachedKeysCaseInsensitive() const
+    {
+        const Utils::Compare::NaturalCompare<Qt::CaseInsensitive> compare;
+        std::vector<Utils::Compare::NaturalSortKey> keys;
+        keys.reserve(m_names.size());
+        for (const QString &name : m_names)
+            keys.push_back(compare.sortKey(name));
+
+        QBENCHMARK
+        {
+            std::vector<Utils::Compare::NaturalSortKey> sortedKeys = keys;
+            std::sort(sortedKeys.begin(), sortedKeys.end());
+        }
+    }
+
+private:
+    static const int TORRENTS_COUNT = 100000;
+
+    QStringList m_names;
+};
+
+QTEST_APPLESS_MAIN(BenchUtilsCompare)
+#include "benchutilscompare.moc"
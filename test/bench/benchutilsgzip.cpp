@@ -0,0 +1,91 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QTest>
+
+#include "base/global.h"
+#include "base/utils/gzip.h"
+
+class BenchUtilsGzip final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchUtilsGzip)
+
+public:
+    BenchUtilsGzip() = default;
+
+private slots:
+    void initTestCase()
+    {
+        // WebAPI sync response of a large session, one JSON object per torrent
+        for (int i = 0; i < TORRENTS_COUNT; ++i)
+        {
+            m_data += u"\"%1\":{\"name\":\"Torrent %2\",\"progress\":%3,\"dlspeed\":%4,\"upspeed\":%5,\"state\":\"%6\"},"_qs
+                .arg(QString::number((0x1000000 + i), 16).repeated(5), QString::number(i), QString::number((i % 1000) / 1000.0)
+                    , QString::number((i * 37) % 100000), QString::number((i * 91) % 50000)
+                    , ((i % 3) == 0) ? u"downloading"_qs : u"stalledUP"_qs).toUtf8();
+        }
+        m_compressedData = Utils::Gzip::compress(m_data);
+    }
+
+    void benchCompress_data() const
+    {
+        QTest::addColumn<int>("level");
+
+        QTest::newRow("level 1") << 1;
+        QTest::newRow("level 6") << 6;
+        QTest::newRow("level 9") << 9;
+    }
+
+    void benchCompress() const
+    {
+        QFETCH(const int, level);
+
+        QBENCHMARK
+        {
+            Utils::Gzip::compress(m_data, level);
+        }
+    }
+
+    void benchDecompress() const
+    {
+        QBENCHMARK
+        {
+            Utils::Gzip::decompress(m_compressedData);
+        }
+    }
+
+private:
+    static const int TORRENTS_COUNT = 10000;
+
+    QByteArray m_data;
+    QByteArray m_compressedData;
+};
+
+QTEST_APPLESS_MAIN(BenchUtilsGzip)
+#include "benchutilsgzip.moc"
@@ -0,0 +1,534 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+// Synthetic large-session load harness
+//
+// Generates a profile with the requested number of torrents (metadata and resume data
+// written by the real resume data storages), starts the BitTorrent session in an offline
+// configuration, drives WebAPI traffic against WebApplication through a loopback socket
+// and reports startup time, idle CPU usage, memory usage and request latency percentiles.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <libtorrent/bencode.hpp>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/torrent_info.hpp>
+
+#include <QtGlobal>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QHostAddress>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QUrl>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+#include "base/bittorrent/bencoderesumedatastorage.h"
+#include "base/bittorrent/dbresumedatastorage.h"
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/loadtorrentparams.h"
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/torrent.h"
+#include "base/global.h"
+#include "base/http/server.h"
+#include "base/interfaces/iapplication.h"
+#include "base/logger.h"
+#include "base/net/downloadmanager.h"
+#include "base/net/proxyconfigurationmanager.h"
+#include "base/path.h"
+#include "base/preferences.h"
+#include "base/profile.h"
+#include "base/settingsstorage.h"
+#include "base/utils/string.h"
+#include "webui/webapplication.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    const int PIECE_SIZE = 256 * 1024;
+    const qint64 FILE_SIZE = 64 * 1024 * 1024;
+
+    struct Options
+    {
+        int torrentsCount = 10000;
+        int filesCount = 4;
+        int activeTorrentsCount = 0;
+        BitTorrent::ResumeDataStorageType storageType = BitTorrent::ResumeDataStorageType::Legacy;
+        int requestsCount = 1000;
+        int idleSeconds = 10;
+        int timeoutSeconds = 600;
+        Path profilePath;
+        QString jsonPath;
+    };
+
+    // WebApplication only needs the application to expose its settings
+    class HarnessApplication final : public IApplication
+    {
+    public:
+        bool isFileLoggerEnabled() const override { return false; }
+        void setFileLoggerEnabled(bool) override {}
+        Path fileLoggerPath() const override { return {}; }
+        void setFileLoggerPath(const Path &) override {}
+        bool isFileLoggerBackup() const override { return false; }
+        void setFileLoggerBackup(bool) override {}
+        bool isFileLoggerDeleteOld() const override { return false; }
+        void setFileLoggerDeleteOld(bool) override {}
+        int fileLoggerMaxSize() const override { return 0; }
+        void setFileLoggerMaxSize(int) override {}
+        int fileLoggerAge() const override { return 0; }
+        void setFileLoggerAge(int) override {}
+        int fileLoggerAgeType() const override { return 0; }
+        void setFileLoggerAgeType(int) override {}
+
+        int memoryWorkingSetLimit() const override { return 0; }
+        void setMemoryWorkingSetLimit(int) override {}
+
+#ifdef Q_OS_WIN
+        MemoryPriority processMemoryPriority() const override { return MemoryPriority::Normal; }
+        void setProcessMemoryPriority(MemoryPriority) override {}
+#endif
+    };
+
+    struct LatencyStats
+    {
+        QVector<double> samples; // milliseconds
+
+        double percentile(const double p) const
+        {
+            if (samples.isEmpty())
+                return 0;
+
+            QVector<double> sorted = samples;
+            std::sort(sorted.begin(), sorted.end());
+            const int index = std::clamp(static_cast<int>((p / 100) * sorted.size()), 0, static_cast<int>(sorted.size() - 1));
+            return sorted[index];
+        }
+    };
+
+    // returns CPU time consumed by all threads of the process in milliseconds, -1 if unsupported
+    qint64 processCPUTime()
+    {
+#ifdef Q_OS_UNIX
+        rusage usage {};
+        if (::getrusage(RUSAGE_SELF, &usage) != 0)
+            return -1;
+        const auto toMSecs = [](const timeval &time) { return (static_cast<qint64>(time.tv_sec) * 1000) + (time.tv_usec / 1000); };
+        return toMSecs(usage.ru_utime) + toMSecs(usage.ru_stime);
+#else
+        return -1;
+#endif
+    }
+
+    // returns peak resident set size in bytes, -1 if unsupported
+    qint64 peakMemoryUsage()
+    {
+#ifdef Q_OS_UNIX
+        rusage usage {};
+        if (::getrusage(RUSAGE_SELF, &usage) != 0)
+            return -1;
+#ifdef Q_OS_MACOS
+        return usage.ru_maxrss;
+#else
+        return static_cast<qint64>(usage.ru_maxrss) * 1024;
+#endif
+#else
+        return -1;
+#endif
+    }
+
+    std::shared_ptr<lt::torrent_info> makeTorrentInfo(const int index, const int filesCount)
+    {
+        const QString name = u"Synthetic Torrent %1"_qs.arg(index, 7, 10, QChar(u'0'));
+
+        lt::file_storage fs;
+        for (int i = 0; i < filesCount; ++i)
+            fs.add_file((name + u"/File %1.bin"_qs.arg(i)).toStdString(), FILE_SIZE);
+
+#ifdef QBT_USES_LIBTORRENT2
+        lt::create_torrent creator {fs, PIECE_SIZE, lt::create_torrent::v1_only};
+#else
+        lt::create_torrent creator {fs, PIECE_SIZE};
+#endif
+        // the content is never checked so piece hashes only have to differ between torrents
+        for (const lt::piece_index_t piece : creator.files().piece_range())
+        {
+            lt::sha1_hash hash;
+            const int pieceIndex = static_cast<int>(piece);
+            for (int i = 0; i < 4; ++i)
+            {
+                hash[i] = static_cast<std::uint8_t>(index >> (i * 8));
+                hash[4 + i] = static_cast<std::uint8_t>(pieceIndex >> (i * 8));
+            }
+            creator.set_hash(piece, hash);
+        }
+
+        std::vector<char> buffer;
+        lt::bencode(std::back_inserter(buffer), creator.generate());
+        return std::make_shared<lt::torrent_info>(buffer, lt::from_span);
+    }
+
+    // writes the resume data of the synthetic torrents in the format of the configured storage
+    void generateSession(const Options &options)
+    {
+        const Path dataPath = specialFolderLocation(SpecialFolder::Data);
+        const Path savePath = specialFolderLocation(SpecialFolder::Downloads) / Path(u"harness"_qs);
+
+        std::unique_ptr<BitTorrent::ResumeDataStorage> storage;
+        if (options.storageType == BitTorrent::ResumeDataStorageType::SQLite)
+            storage = std::make_unique<BitTorrent::DBResumeDataStorage>(dataPath / Path(u"torrents.db"_qs));
+        else
+            storage = std::make_unique<BitTorrent::BencodeResumeDataStorage>(dataPath / Path(u"BT_backup"_qs));
+
+        QVector<BitTorrent::TorrentID> queue;
+        queue.reserve(options.torrentsCount);
+        for (int i = 0; i < options.torrentsCount; ++i)
+        {
+            const std::shared_ptr<lt::torrent_info> torrentInfo = makeTorrentInfo(i, options.filesCount);
+
+            BitTorrent::LoadTorrentParams params;
+            params.name = QString::fromStdString(torrentInfo->name());
+            params.savePath = savePath;
+            params.stopped = (i >= options.activeTorrentsCount);
+
+            lt::add_torrent_params &p = params.ltAddTorrentParams;
+            p.ti = torrentInfo;
+            p.save_path = savePath.toString().toStdString();
+#ifdef QBT_USES_LIBTORRENT2
+            p.info_hashes = torrentInfo->info_hashes();
+            const BitTorrent::InfoHash infoHash {torrentInfo->info_hashes()};
+#else
+            p.info_hash = torrentInfo->info_hash();
+            const BitTorrent::InfoHash infoHash {torrentInfo->info_hash()};
+#endif
+
+            const BitTorrent::TorrentID id = infoHash.toTorrentID();
+            storage->store(id, params);
+            queue.append(id);
+        }
+        storage->storeQueue(queue);
+        // the storage flushes the pending writes when destroyed
+    }
+
+    // stores the settings which keep the session off the network
+    void configureOfflineSession(const Options &options)
+    {
+        SettingsStorage *settings = SettingsStorage::instance();
+        settings->storeValue(u"BitTorrent/Session/ResumeDataStorageType"_qs, options.storageType);
+        settings->storeValue(u"BitTorrent/Session/InterfaceAddress"_qs, u"127.0.0.1"_qs);
+        settings->storeValue(u"BitTorrent/Session/Port"_qs, 0);
+        settings->storeValue(u"BitTorrent/Session/DHTEnabled"_qs, false);
+        settings->storeValue(u"BitTorrent/Session/LSDEnabled"_qs, false);
+        settings->storeValue(u"BitTorrent/Session/PeXEnabled"_qs, false);
+        settings->storeValue(u"Network/PortForwardingEnabled"_qs, false);
+
+        Preferences *pref = Preferences::instance();
+        pref->setWebUiLocalAuthEnabled(false);
+        pref->setWebUIHostHeaderValidationEnabled(false);
+    }
+
+    // runs the event loop until `isDone` returns true or the timeout elapses
+    bool waitUntil(const std::function<bool ()> &isDone, const std::chrono::milliseconds timeout)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        while (!isDone())
+        {
+            if (timer.hasExpired(timeout.count()))
+                return false;
+
+            QEventLoop loop;
+            QTimer::singleShot(10ms, &loop, &QEventLoop::quit);
+            loop.exec();
+        }
+        return true;
+    }
+
+    void runEventLoop(const std::chrono::milliseconds duration)
+    {
+        QEventLoop loop;
+        QTimer::singleShot(duration, &loop, &QEventLoop::quit);
+        loop.exec();
+    }
+
+    class ApiClient
+    {
+    public:
+        explicit ApiClient(const quint16 port)
+            : m_baseUrl {u"http://127.0.0.1:%1/api/v2/"_qs.arg(port)}
+        {
+        }
+
+        // performs the request and returns its latency in milliseconds, -1 on failure
+        double get(const QString &endpoint, QByteArray *data = nullptr)
+        {
+            QElapsedTimer timer;
+            timer.start();
+
+            QNetworkReply *reply = m_manager.get(QNetworkRequest(QUrl(m_baseUrl + endpoint)));
+            QEventLoop loop;
+            QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+            loop.exec();
+
+            const double latency = timer.nsecsElapsed() / 1e6;
+            const bool isOK = (reply->error() == QNetworkReply::NoError);
+            if (isOK && data)
+                *data = reply->readAll();
+            reply->deleteLater();
+            return isOK ? latency : -1;
+        }
+
+    private:
+        const QString m_baseUrl;
+        QNetworkAccessManager m_manager;
+    };
+
+    QJsonObject latencyToJson(const LatencyStats &stats)
+    {
+        return {
+            {u"count"_qs, stats.samples.size()},
+            {u"p50"_qs, stats.percentile(50)},
+            {u"p90"_qs, stats.percentile(90)},
+            {u"p99"_qs, stats.percentile(99)},
+            {u"max"_qs, stats.percentile(100)}
+        };
+    }
+
+    bool parseOptions(const QCoreApplication &app, Options &options)
+    {
+        QCommandLineParser parser;
+        parser.setApplicationDescription(u"Synthetic large-session load harness"_qs);
+        parser.addHelpOption();
+
+        const QCommandLineOption torrentsOption {u"torrents"_qs, u"Number of synthetic torrents."_qs, u"count"_qs, QString::number(options.torrentsCount)};
+        const QCommandLineOption filesOption {u"files"_qs, u"Number of files per torrent."_qs, u"count"_qs, QString::number(options.filesCount)};
+        const QCommandLineOption activeOption {u"active"_qs, u"Number of started torrents, the others are paused."_qs, u"count"_qs, QString::number(options.activeTorrentsCount)};
+        const QCommandLineOption storageOption {u"storage"_qs, u"Resume data storage: legacy or sqlite."_qs, u"type"_qs, u"legacy"_qs};
+        const QCommandLineOption requestsOption {u"requests"_qs, u"Number of WebAPI requests per endpoint."_qs, u"count"_qs, QString::number(options.requestsCount)};
+        const QCommandLineOption idleOption {u"idle"_qs, u"Seconds of idle time to measure steady-state CPU usage."_qs, u"seconds"_qs, QString::number(options.idleSeconds)};
+        const QCommandLineOption timeoutOption {u"timeout"_qs, u"Seconds to wait for the session to be restored."_qs, u"seconds"_qs, QString::number(options.timeoutSeconds)};
+        const QCommandLineOption profileOption {u"profile"_qs, u"Profile directory, a temporary one is used by default."_qs, u"path"_qs};
+        const QCommandLineOption jsonOption {u"json"_qs, u"Write the report in JSON format to the file."_qs, u"path"_qs};
+        parser.addOptions({torrentsOption, filesOption, activeOption, storageOption, requestsOption, idleOption, timeoutOption, profileOption, jsonOption});
+        parser.process(app);
+
+        options.torrentsCount = parser.value(torrentsOption).toInt();
+        options.filesCount = std::max(parser.value(filesOption).toInt(), 1);
+        options.activeTorrentsCount = parser.value(activeOption).toInt();
+        options.requestsCount = parser.value(requestsOption).toInt();
+        options.idleSeconds = parser.value(idleOption).toInt();
+        options.timeoutSeconds = parser.value(timeoutOption).toInt();
+        options.profilePath = Path(parser.value(profileOption));
+        options.jsonPath = parser.value(jsonOption);
+
+        const QString storage = parser.value(storageOption);
+        if (storage == u"sqlite")
+        {
+            options.storageType = BitTorrent::ResumeDataStorageType::SQLite;
+        }
+        else if (storage != u"legacy")
+        {
+            std::fprintf(stderr, "Unknown resume data storage: %s\n", qUtf8Printable(storage));
+            return false;
+        }
+
+        return (options.torrentsCount > 0);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app {argc, argv};
+    app.setApplicationName(u"qbt_loadharness"_qs);
+
+    Options options;
+    if (!parseOptions(app, options))
+        return EXIT_FAILURE;
+
+    QTemporaryDir tmpDir;
+    if (options.profilePath.isEmpty())
+    {
+        if (!tmpDir.isValid())
+            return EXIT_FAILURE;
+        options.profilePath = Path(tmpDir.path());
+    }
+
+    Logger::initInstance();
+    Profile::initInstance(options.profilePath, {}, false);
+    SettingsStorage::initInstance();
+    Preferences::initInstance();
+    configureOfflineSession(options);
+
+    QJsonObject report
+    {
+        {u"torrents"_qs, options.torrentsCount},
+        {u"files"_qs, options.filesCount},
+        {u"active"_qs, options.activeTorrentsCount},
+        {u"storage"_qs, Utils::String::fromEnum(options.storageType)}
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    generateSession(options);
+    report[u"generationTime"_qs] = timer.elapsed();
+    std::printf("Generated %d torrents in %lld ms\n", options.torrentsCount, timer.elapsed());
+
+    Net::ProxyConfigurationManager::initInstance();
+    Net::DownloadManager::initInstance();
+
+    timer.restart();
+    BitTorrent::Session::initInstance();
+    BitTorrent::Session *session = BitTorrent::Session::instance();
+    bool isRestored = false;
+    QObject::connect(session, &BitTorrent::Session::restored, &app, [&isRestored] { isRestored = true; });
+    if (!waitUntil([&isRestored] { return isRestored; }, std::chrono::seconds(options.timeoutSeconds)))
+    {
+        std::fprintf(stderr, "Session was not restored within %d seconds\n", options.timeoutSeconds);
+        return EXIT_FAILURE;
+    }
+    // the requests below are addressed to the restored torrents
+    if (session->torrents().isEmpty())
+    {
+        std::fprintf(stderr, "No torrents were restored from the generated profile\n");
+        return EXIT_FAILURE;
+    }
+    report[u"startupTime"_qs] = timer.elapsed();
+    report[u"loadedTorrents"_qs] = session->torrents().size();
+    std::printf("Restored %lld torrents in %lld ms\n", static_cast<qint64>(session->torrents().size()), timer.elapsed());
+
+    // steady state, the session only runs its periodic jobs
+    timer.restart();
+    const qint64 idleCPUTimeStart = processCPUTime();
+    runEventLoop(std::chrono::seconds(options.idleSeconds));
+    const qint64 idleWallTime = timer.elapsed();
+    const double idleCPUUsage = (idleCPUTimeStart >= 0) ? ((processCPUTime() - idleCPUTimeStart) * 100.0 / idleWallTime) : -1;
+    report[u"idleCPUUsage"_qs] = idleCPUUsage;
+    std::printf("Idle CPU usage: %.1f%%\n", idleCPUUsage);
+
+    HarnessApplication harnessApp;
+    auto *webApp = new WebApplication(&harnessApp);
+    auto *server = new Http::Server(webApp);
+    if (!server->listen(QHostAddress::LocalHost, 0))
+    {
+        std::fprintf(stderr, "Failed to listen on the loopback interface: %s\n", qUtf8Printable(server->errorString()));
+        return EXIT_FAILURE;
+    }
+
+    const QVector<BitTorrent::Torrent *> torrents = session->torrents();
+    const auto hashAt = [&torrents](const int i) { return torrents[i % torrents.size()]->id().toString(); };
+
+    ApiClient client {server->serverPort()};
+    QHash<QString, LatencyStats> latencies;
+    int failedRequests = 0;
+    const auto measure = [&latencies, &failedRequests](const QString &name, const double latency)
+    {
+        if (latency >= 0)
+            latencies[name].samples.append(latency);
+        else
+            ++failedRequests;
+    };
+
+    timer.restart();
+    const qint64 loadCPUTimeStart = processCPUTime();
+    int rid = 0;
+    for (int i = 0; i < options.requestsCount; ++i)
+    {
+        QByteArray syncData;
+        measure(u"sync/maindata"_qs, client.get(u"sync/maindata?rid=%1"_qs.arg(rid), &syncData));
+        rid = QJsonDocument::fromJson(syncData).object().value(u"rid"_qs).toInt(rid);
+
+        measure(u"transfer/info"_qs, client.get(u"transfer/info"_qs));
+        measure(u"torrents/info"_qs, client.get(u"torrents/info?limit=100&offset=%1"_qs.arg((i * 100) % torrents.size())));
+        measure(u"torrents/properties"_qs, client.get(u"torrents/properties?hash=%1"_qs.arg(hashAt(i))));
+        measure(u"torrents/files"_qs, client.get(u"torrents/files?hash=%1"_qs.arg(hashAt(i))));
+    }
+    const qint64 loadWallTime = timer.elapsed();
+    const double loadCPUUsage = (loadCPUTimeStart >= 0) ? ((processCPUTime() - loadCPUTimeStart) * 100.0 / loadWallTime) : -1;
+    report[u"loadCPUUsage"_qs] = loadCPUUsage;
+    report[u"failedRequests"_qs] = failedRequests;
+    std::printf("CPU usage under load: %.1f%%, failed requests: %d\n", loadCPUUsage, failedRequests);
+
+    QJsonObject latencyReport;
+    for (auto iter = latencies.cbegin(); iter != latencies.cend(); ++iter)
+    {
+        const LatencyStats &stats = iter.value();
+        latencyReport[iter.key()] = latencyToJson(stats);
+        std::printf("%-22s p50 %8.2f ms  p90 %8.2f ms  p99 %8.2f ms  max %8.2f ms\n", qUtf8Printable(iter.key())
+            , stats.percentile(50), stats.percentile(90), stats.percentile(99), stats.percentile(100));
+    }
+    report[u"latency"_qs] = latencyReport;
+
+    const qint64 peakMemory = peakMemoryUsage();
+    report[u"peakMemory"_qs] = peakMemory;
+    std::printf("Peak memory usage: %lld KiB\n", (peakMemory >= 0) ? (peakMemory / 1024) : -1);
+
+    delete server;
+    delete webApp;
+
+    timer.restart();
+    BitTorrent::Session::freeInstance();
+    report[u"shutdownTime"_qs] = timer.elapsed();
+
+    Net::DownloadManager::freeInstance();
+    Net::ProxyConfigurationManager::freeInstance();
+    Preferences::freeInstance();
+    SettingsStorage::freeInstance();
+    Profile::freeInstance();
+    Logger::freeInstance();
+
+    if (!options.jsonPath.isEmpty())
+    {
+        QFile jsonFile {options.jsonPath};
+        if (!jsonFile.open(QIODevice::WriteOnly) || (jsonFile.write(QJsonDocument(report).toJson()) == -1))
+        {
+            std::fprintf(stderr, "Failed to write the report to %s\n", qUtf8Printable(options.jsonPath));
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,174 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+
+#include <QStringList>
+#include <QTest>
+#include <QVector>
+
+#include "base/bittorrent/announcescheduler.h"
+#include "base/bittorrent/infohash.h"
+#include "base/global.h"
+
+namespace
+{
+    const QString TORRENT_HASH1 = u"0123456789abcdef0123456789abcdef01234567"_qs;
+    const QString TORRENT_HASH2 = u"89abcdef0123456789abcdef0123456789abcdef"_qs;
+    const QString TORRENT_HASH3 = u"fedcba9876543210fedcba9876543210fedcba98"_qs;
+    const BitTorrent::TorrentID TORRENT_ID1 = BitTorrent::TorrentID::fromString(TORRENT_HASH1);
+    const BitTorrent::TorrentID TORRENT_ID2 = BitTorrent::TorrentID::fromString(TORRENT_HASH2);
+    const BitTorrent::TorrentID TORRENT_ID3 = BitTorrent::TorrentID::fromString(TORRENT_HASH3);
+
+    const QString HOST1 = u"tracker.example.com"_qs;
+    const QString HOST2 = u"other.example.org"_qs;
+
+    // the scheduler checks the queue once a second, the announces not sent by libtorrent are released after 10 seconds
+    const int QUEUE_TIMEOUT = 5000;
+    const int START_TIMEOUT = 15000;
+
+    bool isScheduled(const BitTorrent::AnnounceScheduler &scheduler, const BitTorrent::TorrentID &id)
+    {
+        const QVector<BitTorrent::ScheduledAnnounce> announces = scheduler.scheduledAnnounces();
+        return std::any_of(announces.cbegin(), announces.cend()
+                , [&id](const BitTorrent::ScheduledAnnounce &announce) { return (announce.torrentID == id); });
+    }
+}
+
+class TestBittorrentAnnounceScheduler final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentAnnounceScheduler)
+
+public:
+    TestBittorrentAnnounceScheduler() = default;
+
+private slots:
+    void init()
+    {
+        m_scheduler = new BitTorrent::AnnounceScheduler(this);
+        m_scheduler->setMaxAnnouncesPerHost(1);
+        m_requested.clear();
+        connect(m_scheduler, &BitTorrent::AnnounceScheduler::announceRequested, this
+                , [this](const BitTorrent::TorrentID &id) { m_requested.append(id.toString()); });
+    }
+
+    void cleanup()
+    {
+        delete m_scheduler;
+        m_scheduler = nullptr;
+    }
+
+    void testPerHostLimit()
+    {
+        m_scheduler->schedule(TORRENT_ID1, {HOST1}, false);
+        QVERIFY(isScheduled(*m_scheduler, TORRENT_ID1));
+        QTRY_COMPARE_WITH_TIMEOUT(m_requested, QStringList {TORRENT_HASH1}, QUEUE_TIMEOUT);
+        QVERIFY(!isScheduled(*m_scheduler, TORRENT_ID1));
+
+        // the job waits for the busy host, the blocked job doesn't occupy its other hosts
+        m_scheduler->schedule(TORRENT_ID2, {HOST1, HOST2}, false);
+        m_scheduler->schedule(TORRENT_ID3, {HOST2, HOST2}, false);
+        QTRY_COMPARE_WITH_TIMEOUT(m_requested.size(), 2, QUEUE_TIMEOUT);
+        QCOMPARE(m_requested.last(), TORRENT_HASH3);
+        QVERIFY(isScheduled(*m_scheduler, TORRENT_ID2));
+
+        // released host passes the job to the next busy one
+        m_scheduler->handleAnnounceStarted(TORRENT_ID1, HOST1);
+        m_scheduler->handleAnnounceFinished(TORRENT_ID1, HOST1);
+        QCOMPARE(m_requested.size(), 2);
+        QVERIFY(isScheduled(*m_scheduler, TORRENT_ID2));
+
+        // replies of other torrents or hosts don't release anything
+        m_scheduler->handleAnnounceFinished(TORRENT_ID1, HOST2);
+        m_scheduler->handleAnnounceFinished(TORRENT_ID2, HOST2);
+        QCOMPARE(m_requested.size(), 2);
+
+        m_scheduler->handleAnnounceFinished(TORRENT_ID3, HOST2);
+        QCOMPARE(m_requested, (QStringList {TORRENT_HASH1, TORRENT_HASH3, TORRENT_HASH2}));
+        QVERIFY(!isScheduled(*m_scheduler, TORRENT_ID2));
+    }
+
+    void testLimitChange()
+    {
+        m_scheduler->schedule(TORRENT_ID1, {HOST1}, false);
+        m_scheduler->schedule(TORRENT_ID2, {HOST1}, false);
+        QTRY_COMPARE_WITH_TIMEOUT(m_requested.size(), 1, QUEUE_TIMEOUT);
+        QVERIFY(isScheduled(*m_scheduler, TORRENT_ID2));
+
+        m_scheduler->setMaxAnnouncesPerHost(0);
+        QCOMPARE(m_requested.size(), 2);
+        QVERIFY(!isScheduled(*m_scheduler, TORRENT_ID2));
+    }
+
+    void testCancel()
+    {
+        m_scheduler->schedule(TORRENT_ID1, {HOST1}, false);
+        QTRY_COMPARE_WITH_TIMEOUT(m_requested.size(), 1, QUEUE_TIMEOUT);
+        m_scheduler->schedule(TORRENT_ID2, {HOST1}, false);
+        m_scheduler->schedule(TORRENT_ID3, {HOST1}, false);
+        m_scheduler->cancel(TORRENT_ID2);
+        QVERIFY(!isScheduled(*m_scheduler, TORRENT_ID2));
+
+        // let the remaining job get blocked by the host
+        QTest::qWait(1500);
+        QCOMPARE(m_requested.size(), 1);
+        QVERIFY(isScheduled(*m_scheduler, TORRENT_ID3));
+
+        // canceled active announce releases the host
+        m_scheduler->cancel(TORRENT_ID1);
+        QCOMPARE(m_requested, (QStringList {TORRENT_HASH1, TORRENT_HASH3}));
+        QVERIFY(!isScheduled(*m_scheduler, TORRENT_ID3));
+    }
+
+    void testStartTimeout()
+    {
+        m_scheduler->schedule(TORRENT_ID1, {HOST1, HOST2}, false);
+        QTRY_COMPARE_WITH_TIMEOUT(m_requested.size(), 1, QUEUE_TIMEOUT);
+
+        // libtorrent announces to the first host only
+        m_scheduler->handleAnnounceStarted(TORRENT_ID1, HOST1);
+        m_scheduler->schedule(TORRENT_ID2, {HOST2}, false);
+        m_scheduler->schedule(TORRENT_ID3, {HOST1}, false);
+
+        // the host which wasn't announced to is released, the one waiting for the reply isn't
+        QTRY_COMPARE_WITH_TIMEOUT(m_requested, (QStringList {TORRENT_HASH1, TORRENT_HASH2}), START_TIMEOUT);
+        QVERIFY(isScheduled(*m_scheduler, TORRENT_ID3));
+
+        m_scheduler->handleAnnounceFinished(TORRENT_ID1, HOST1);
+        QCOMPARE(m_requested.last(), TORRENT_HASH3);
+    }
+
+private:
+    BitTorrent::AnnounceScheduler *m_scheduler = nullptr;
+    // hashes of the requested torrents
+    QStringList m_requested;
+};
+
+QTEST_GUILESS_MAIN(TestBittorrentAnnounceScheduler)
+#include "testbittorrentannouncescheduler.moc"
@@ -0,0 +1,144 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+
+#include <QTest>
+#include <QVector>
+
+#include "base/bittorrent/demandqueuescheduler.h"
+#include "base/bittorrent/infohash.h"
+#include "base/global.h"
+
+using BitTorrent::DemandQueueEntry;
+using BitTorrent::DemandQueueScheduler;
+
+namespace
+{
+    DemandQueueEntry makeEntry(const int number, const qreal score, const bool isActive)
+    {
+        DemandQueueEntry entry;
+        entry.torrentID = BitTorrent::TorrentID::fromString(u"%1"_qs.arg(number, 40, 10, u'0'));
+        entry.score = score;
+        entry.isActive = isActive;
+        return entry;
+    }
+
+    QVector<int> order(const QVector<DemandQueueEntry> &entries, const QVector<DemandQueueEntry> &original)
+    {
+        QVector<int> result;
+        for (const DemandQueueEntry &entry : entries)
+        {
+            const auto iter = std::find_if(original.cbegin(), original.cend()
+                    , [&entry](const DemandQueueEntry &item) { return (item.torrentID == entry.torrentID); });
+            result.append(static_cast<int>(iter - original.cbegin()));
+        }
+        return result;
+    }
+
+    int activeCount(const QVector<DemandQueueEntry> &entries)
+    {
+        return static_cast<int>(std::count_if(entries.cbegin(), entries.cend()
+                , [](const DemandQueueEntry &entry) { return entry.shouldBeActive; }));
+    }
+}
+
+class TestBittorrentDemandQueueScheduler final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentDemandQueueScheduler)
+
+public:
+    TestBittorrentDemandQueueScheduler() = default;
+
+private slots:
+    void testScore() const
+    {
+        QCOMPARE(DemandQueueScheduler::score(0, 0, 0), 0.0);
+        QCOMPARE(DemandQueueScheduler::score(0, 4, 0), 4.0);
+        QCOMPARE(DemandQueueScheduler::score(3, 4, 0), 1.0);
+        // 100 KiB/s of recent upload weighs as much as one leecher per seed
+        QCOMPARE(DemandQueueScheduler::score(3, 4, (200 * 1024)), 3.0);
+        // unknown swarm counts are treated as zero
+        QCOMPARE(DemandQueueScheduler::score(-1, -1, -1), 0.0);
+    }
+
+    void testAssignSlots() const
+    {
+        const QVector<DemandQueueEntry> original
+        {
+            makeEntry(0, 1.0, true),
+            makeEntry(1, 3.0, false),
+            makeEntry(2, 2.0, false),
+            makeEntry(3, 0.5, true)
+        };
+
+        QVector<DemandQueueEntry> entries = original;
+        DemandQueueScheduler::assignSlots(entries, 2);
+        QCOMPARE(order(entries, original), (QVector<int> {1, 2, 0, 3}));
+        QVERIFY(entries[0].shouldBeActive);
+        QVERIFY(entries[1].shouldBeActive);
+        QVERIFY(!entries[2].shouldBeActive);
+        QVERIFY(!entries[3].shouldBeActive);
+
+        // the previous assignment is overwritten
+        DemandQueueScheduler::assignSlots(entries, 0);
+        QCOMPARE(activeCount(entries), 0);
+
+        // unlimited slots and more slots than candidates activate everything
+        DemandQueueScheduler::assignSlots(entries, -1);
+        QCOMPARE(activeCount(entries), 4);
+        DemandQueueScheduler::assignSlots(entries, 10);
+        QCOMPARE(activeCount(entries), 4);
+
+        QVector<DemandQueueEntry> empty;
+        DemandQueueScheduler::assignSlots(empty, 2);
+        QVERIFY(empty.isEmpty());
+    }
+
+    void testAssignSlotsTies() const
+    {
+        // active torrents keep their slots on ties, so equal torrents aren't rotated needlessly
+        const QVector<DemandQueueEntry> original
+        {
+            makeEntry(0, 1.0, false),
+            makeEntry(1, 1.0, true),
+            makeEntry(2, 1.0, false),
+            makeEntry(3, 1.0, true)
+        };
+
+        QVector<DemandQueueEntry> entries = original;
+        DemandQueueScheduler::assignSlots(entries, 2);
+        QCOMPARE(order(entries, original), (QVector<int> {1, 3, 0, 2}));
+        QVERIFY(entries[0].shouldBeActive && entries[1].shouldBeActive);
+        QVERIFY(!entries[2].shouldBeActive && !entries[3].shouldBeActive);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentDemandQueueScheduler)
+#include "testbittorrentdemandqueuescheduler.moc"
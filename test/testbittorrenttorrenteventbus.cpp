@@ -0,0 +1,273 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QQueue>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QVector>
+
+#include "base/bittorrent/torrenteventbus.h"
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/net/downloadmanager.h"
+#include "base/net/proxyconfigurationmanager.h"
+#include "base/path.h"
+#include "base/preferences.h"
+#include "base/profile.h"
+#include "base/settingsstorage.h"
+
+Q_DECLARE_METATYPE(BitTorrent::TorrentEvent)
+
+namespace
+{
+    const BitTorrent::TorrentID TORRENT_ID = BitTorrent::TorrentID::fromString(u"0123456789abcdef0123456789abcdef01234567"_qs);
+
+    QVector<qint64> eventIDs(const QVector<BitTorrent::TorrentEvent> &events)
+    {
+        QVector<qint64> ids;
+        for (const BitTorrent::TorrentEvent &event : events)
+            ids.append(event.id);
+        return ids;
+    }
+
+    QVector<qint64> eventIDs(const QJsonObject &payload)
+    {
+        QVector<qint64> ids;
+        const QJsonArray events = payload[u"events"_qs].toArray();
+        for (const QJsonValue &event : events)
+            ids.append(event[u"id"_qs].toVariant().toLongLong());
+        return ids;
+    }
+
+    // Minimal HTTP server that records the JSON bodies of the requests it receives
+    class WebhookListener final : public QObject
+    {
+    public:
+        WebhookListener()
+        {
+            m_server.listen(QHostAddress::LocalHost);
+            connect(&m_server, &QTcpServer::newConnection, this, &WebhookListener::acceptConnections);
+        }
+
+        QString url() const
+        {
+            return u"http://127.0.0.1:%1/events"_qs.arg(m_server.serverPort());
+        }
+
+        // status codes of the next responses, 200 is used once it is empty
+        QQueue<int> statusCodes;
+        QVector<QJsonObject> payloads;
+
+    private:
+        void acceptConnections()
+        {
+            while (QTcpSocket *socket = m_server.nextPendingConnection())
+            {
+                connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { readRequests(socket); });
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+                connect(socket, &QObject::destroyed, this, [this, socket]() { m_buffers.remove(socket); });
+            }
+        }
+
+        void readRequests(QTcpSocket *socket)
+        {
+            QByteArray &buffer = m_buffers[socket];
+            buffer += socket->readAll();
+
+            // the connection may be kept alive and carry several requests
+            while (true)
+            {
+                const int headerEnd = buffer.indexOf("\r\n\r\n");
+                if (headerEnd < 0)
+                    return;
+
+                int contentLength = 0;
+                const QList<QByteArray> headerLines = buffer.left(headerEnd).split('\n');
+                for (const QByteArray &line : headerLines)
+                {
+                    if (line.toLower().startsWith("content-length:"))
+                        contentLength = line.mid(15).trimmed().toInt();
+                }
+
+                const int requestSize = headerEnd + 4 + contentLength;
+                if (buffer.size() < requestSize)
+                    return;
+
+                payloads.append(QJsonDocument::fromJson(buffer.mid((headerEnd + 4), contentLength)).object());
+                buffer.remove(0, requestSize);
+
+                const int statusCode = statusCodes.isEmpty() ? 200 : statusCodes.dequeue();
+                socket->write("HTTP/1.1 " + QByteArray::number(statusCode) + " Status\r\nContent-Length: 0\r\n\r\n");
+            }
+        }
+
+        QTcpServer m_server;
+        QHash<QTcpSocket *, QByteArray> m_buffers;
+    };
+}
+
+class TestBittorrentTorrentEventBus final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentTorrentEventBus)
+
+public:
+    TestBittorrentTorrentEventBus() = default;
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_profileDir.isValid());
+        qRegisterMetaType<QVector<BitTorrent::TorrentEvent>>();
+
+        // webhooks are delivered by DownloadManager which depends on the settings
+        Logger::initInstance();
+        Profile::initInstance(Path(m_profileDir.path()), {}, false);
+        SettingsStorage::initInstance();
+        Preferences::initInstance();
+        Net::ProxyConfigurationManager::initInstance();
+        Net::DownloadManager::initInstance();
+    }
+
+    void cleanupTestCase()
+    {
+        Net::DownloadManager::freeInstance();
+        Net::ProxyConfigurationManager::freeInstance();
+        Preferences::freeInstance();
+        SettingsStorage::freeInstance();
+        Profile::freeInstance();
+        Logger::freeInstance();
+    }
+
+    void testEvents() const
+    {
+        BitTorrent::TorrentEventBus eventBus {{}, 3};
+        bool eventsLost = true;
+        QVERIFY(eventBus.events(0, 10, &eventsLost).isEmpty());
+        QVERIFY(!eventsLost);
+
+        for (int i = 0; i < 5; ++i)
+            eventBus.publish(BitTorrent::TorrentEventType::Added, TORRENT_ID, u"torrent"_qs);
+        QCOMPARE(eventBus.lastEventID(), qint64 {5});
+
+        // the buffer holds the last 3 events only
+        QCOMPARE(eventIDs(eventBus.events(0, 10, &eventsLost)), QVector<qint64>({3, 4, 5}));
+        QVERIFY(eventsLost);
+        QCOMPARE(eventIDs(eventBus.events(1, 10, &eventsLost)), QVector<qint64>({3, 4, 5}));
+        QVERIFY(eventsLost);
+
+        QCOMPARE(eventIDs(eventBus.events(2, 10, &eventsLost)), QVector<qint64>({3, 4, 5}));
+        QVERIFY(!eventsLost);
+        QCOMPARE(eventIDs(eventBus.events(3, 10, &eventsLost)), QVector<qint64>({4, 5}));
+        QVERIFY(!eventsLost);
+        QCOMPARE(eventIDs(eventBus.events(3, 1, &eventsLost)), QVector<qint64>({4}));
+        QVERIFY(!eventsLost);
+        QVERIFY(eventBus.events(3, 0, &eventsLost).isEmpty());
+        QVERIFY(eventBus.events(5, 10, &eventsLost).isEmpty());
+        QVERIFY(!eventsLost);
+
+        // ID from an earlier session
+        QCOMPARE(eventIDs(eventBus.events(42, 10, &eventsLost)), QVector<qint64>({3, 4, 5}));
+        QVERIFY(eventsLost);
+    }
+
+    void testEventToJSON() const
+    {
+        BitTorrent::TorrentEventBus eventBus {{}, 10};
+        eventBus.publish(BitTorrent::TorrentEventType::TrackerError, TORRENT_ID, u"torrent"_qs, u"udp://tracker:1337"_qs);
+        eventBus.publish(BitTorrent::TorrentEventType::Finished, TORRENT_ID, u"torrent"_qs);
+
+        const QVector<BitTorrent::TorrentEvent> events = eventBus.events(0, 10);
+        QCOMPARE(events.size(), 2);
+
+        const QJsonObject trackerErrorEvent = events[0].toJSON();
+        QCOMPARE(trackerErrorEvent[u"id"_qs].toVariant().toLongLong(), qint64 {1});
+        QCOMPARE(trackerErrorEvent[u"type"_qs].toString(), u"tracker_error"_qs);
+        QCOMPARE(trackerErrorEvent[u"hash"_qs].toString(), TORRENT_ID.toString());
+        QCOMPARE(trackerErrorEvent[u"name"_qs].toString(), u"torrent"_qs);
+        QCOMPARE(trackerErrorEvent[u"details"_qs].toString(), u"udp://tracker:1337"_qs);
+
+        const QJsonObject finishedEvent = events[1].toJSON();
+        QCOMPARE(finishedEvent[u"type"_qs].toString(), u"finished"_qs);
+        QVERIFY(!finishedEvent.contains(u"details"_qs));
+    }
+
+    void testWebhookBatching() const
+    {
+        WebhookListener listener;
+        BitTorrent::TorrentEventBus eventBus {{listener.url()}, 10};
+        QSignalSpy publishedSpy {&eventBus, &BitTorrent::TorrentEventBus::eventsPublished};
+
+        for (int i = 0; i < 3; ++i)
+            eventBus.publish(BitTorrent::TorrentEventType::Added, TORRENT_ID, u"torrent"_qs);
+
+        QTRY_COMPARE(listener.payloads.size(), 1);
+        QCOMPARE(eventIDs(listener.payloads[0]), QVector<qint64>({1, 2, 3}));
+        QCOMPARE(listener.payloads[0][u"lost"_qs].toBool(), false);
+        QCOMPARE(publishedSpy.count(), 1);
+        QCOMPARE(eventIDs(publishedSpy[0][0].value<QVector<BitTorrent::TorrentEvent>>()), QVector<qint64>({1, 2, 3}));
+
+        eventBus.publish(BitTorrent::TorrentEventType::Removed, TORRENT_ID, u"torrent"_qs);
+        QTRY_COMPARE(listener.payloads.size(), 2);
+        QCOMPARE(eventIDs(listener.payloads[1]), QVector<qint64>({4}));
+    }
+
+    void testWebhookRetry() const
+    {
+        WebhookListener listener;
+        listener.statusCodes.enqueue(500);
+        BitTorrent::TorrentEventBus eventBus {{listener.url()}, 10};
+
+        eventBus.publish(BitTorrent::TorrentEventType::Added, TORRENT_ID, u"torrent"_qs);
+        QTRY_COMPARE(listener.payloads.size(), 1);
+
+        // published while the failed batch waits for the retry
+        eventBus.publish(BitTorrent::TorrentEventType::Finished, TORRENT_ID, u"torrent"_qs);
+        QTRY_COMPARE_WITH_TIMEOUT(listener.payloads.size(), 2, 10000);
+        QCOMPARE(eventIDs(listener.payloads[0]), QVector<qint64>({1}));
+        QCOMPARE(eventIDs(listener.payloads[1]), QVector<qint64>({1, 2}));
+
+        eventBus.publish(BitTorrent::TorrentEventType::Removed, TORRENT_ID, u"torrent"_qs);
+        QTRY_COMPARE(listener.payloads.size(), 3);
+        QCOMPARE(eventIDs(listener.payloads[2]), QVector<qint64>({3}));
+    }
+
+private:
+    QTemporaryDir m_profileDir;
+};
+
+QTEST_GUILESS_MAIN(TestBittorrentTorrentEventBus)
+#include "testbittorrenttorrenteventbus.moc"
@@ -0,0 +1,128 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include <utility>
+
+#include <QTest>
+#include <QVector>
+
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/torrentsqueue.h"
+#include "base/global.h"
+
+namespace
+{
+    BitTorrent::TorrentID makeID(const char digit)
+    {
+        return BitTorrent::TorrentID::fromString(QString(40, QLatin1Char(digit)));
+    }
+}
+
+class TestBittorrentTorrentsQueue final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentTorrentsQueue)
+
+public:
+    TestBittorrentTorrentsQueue() = default;
+
+private slots:
+    void testSetPosition() const
+    {
+        BitTorrent::TorrentsQueue queue;
+        QVERIFY(queue.isEmpty());
+        QCOMPARE(queue.position(makeID('a')), -1);
+
+        QVERIFY(queue.setPosition(makeID('a'), 0));
+        QVERIFY(queue.setPosition(makeID('b'), 1));
+        QVERIFY(!queue.setPosition(makeID('b'), 1));
+        QVERIFY(!queue.setPosition(makeID('c'), -1));
+        QCOMPARE(queue.count(), 2);
+        QCOMPARE(queue.position(makeID('a')), 0);
+        QCOMPARE(queue.position(makeID('b')), 1);
+        QCOMPARE(queue.position(makeID('c')), -1);
+
+        // swap positions as libtorrent reports them
+        QVERIFY(queue.setPosition(makeID('b'), 0));
+        QVERIFY(queue.setPosition(makeID('a'), 1));
+        QCOMPARE(queue.toVector(), (QVector<BitTorrent::TorrentID> {makeID('b'), makeID('a')}));
+
+        // torrent which occupied the position is dropped until it reports its own position
+        QVERIFY(queue.setPosition(makeID('c'), 0));
+        QCOMPARE(queue.position(makeID('b')), -1);
+        QCOMPARE(queue.count(), 2);
+        QVERIFY(queue.setPosition(makeID('b'), 2));
+        QCOMPARE(queue.toVector(), (QVector<BitTorrent::TorrentID> {makeID('c'), makeID('a'), makeID('b')}));
+
+        QVERIFY(queue.setPosition(makeID('a'), -1));
+        QCOMPARE(queue.count(), 2);
+        QCOMPARE(queue.toVector(), (QVector<BitTorrent::TorrentID> {makeID('c'), {}, makeID('b')}));
+    }
+
+    void testRemove() const
+    {
+        BitTorrent::TorrentsQueue queue;
+        queue.setPosition(makeID('a'), 0);
+        queue.setPosition(makeID('b'), 1);
+
+        queue.remove(makeID('f'));
+        QCOMPARE(queue.count(), 2);
+
+        queue.remove(makeID('b'));
+        QCOMPARE(queue.position(makeID('b')), -1);
+        QCOMPARE(queue.toVector(), (QVector<BitTorrent::TorrentID> {makeID('a')}));
+
+        queue.remove(makeID('a'));
+        QVERIFY(queue.isEmpty());
+        QVERIFY(queue.toVector().isEmpty());
+    }
+
+    void testChangedRange() const
+    {
+        BitTorrent::TorrentsQueue queue;
+        QVERIFY(!queue.isChanged());
+
+        for (int i = 0; i < 6; ++i)
+            queue.setPosition(makeID(static_cast<char>('0' + i)), i);
+        QVERIFY(queue.isChanged());
+        QCOMPARE(queue.changedRange(), std::make_pair(0, 5));
+
+        queue.resetChanged();
+        QVERIFY(!queue.isChanged());
+
+        queue.setPosition(makeID('2'), 3);
+        queue.setPosition(makeID('3'), 2);
+        QCOMPARE(queue.changedRange(), std::make_pair(2, 3));
+
+        queue.resetChanged();
+        queue.markAllChanged();
+        QCOMPARE(queue.changedRange(), std::make_pair(0, 5));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentTorrentsQueue)
+#include "testbittorrenttorrentsqueue.moc"
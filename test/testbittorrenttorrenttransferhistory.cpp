@@ -0,0 +1,149 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include <QTest>
+
+#include "base/bittorrent/torrenttransferhistory.h"
+#include "base/global.h"
+
+namespace
+{
+    const qint64 HOUR = 60 * 60;
+    const qint64 DAY = 24 * HOUR;
+    // start of a day
+    const qint64 START_TIME = 1699920000;
+}
+
+class TestBittorrentTorrentTransferHistory final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentTorrentTransferHistory)
+
+public:
+    TestBittorrentTorrentTransferHistory() = default;
+
+private slots:
+    void testRecord() const
+    {
+        BitTorrent::TorrentTransferHistory history;
+
+        // the first record sets the baseline only
+        QVERIFY(!history.record(START_TIME, 100, 50));
+        QCOMPARE(history.transferred(START_TIME, (START_TIME + HOUR)).uploaded, qint64 {0});
+
+        QVERIFY(!history.record((START_TIME + 600), 1100, 550));
+        BitTorrent::TransferAmount amount = history.transferred(START_TIME, (START_TIME + 1));
+        QCOMPARE(amount.uploaded, qint64 {1000});
+        QCOMPARE(amount.downloaded, qint64 {500});
+
+        // non-empty bucket is completed
+        QVERIFY(history.record((START_TIME + HOUR), 3100, 550));
+        QCOMPARE(history.transferred(START_TIME, (START_TIME + (2 * HOUR))).uploaded, qint64 {3000});
+        QCOMPARE(history.transferred((START_TIME + HOUR), (START_TIME + (2 * HOUR))).uploaded, qint64 {2000});
+
+        QVERIFY(history.record((START_TIME + (2 * HOUR)), 3100, 550));
+        QVERIFY(!history.record((START_TIME + (3 * HOUR)), 3100, 550));
+        for (qint64 hour = 4; hour < 72; ++hour)
+            history.record((START_TIME + (hour * HOUR)), 3100, 550);
+
+        QCOMPARE(history.transferred((START_TIME + (2 * HOUR)), (START_TIME + (72 * HOUR))).uploaded, qint64 {0});
+        QCOMPARE(history.transferred(START_TIME, (START_TIME + (72 * HOUR))).uploaded, qint64 {3000});
+        QVERIFY(history.toData().size() < 64);
+    }
+
+    void testDownsampling() const
+    {
+        BitTorrent::TorrentTransferHistory history;
+        history.record(START_TIME, 0, 0);
+        for (qint64 hour = 1; hour <= (10 * 24); ++hour)
+            history.record((START_TIME + (hour * HOUR)), hour, 0);
+
+        // hourly history is kept for the last week only
+        QCOMPARE(history.transferred((START_TIME + (239 * HOUR)), (START_TIME + (240 * HOUR) + 1)).uploaded, qint64 {2});
+        QCOMPARE(history.transferred(START_TIME, (START_TIME + DAY)).uploaded, qint64 {23});
+        QCOMPARE(history.transferred(START_TIME, (START_TIME + (241 * HOUR))).uploaded, qint64 {240});
+    }
+
+    void testData() const
+    {
+        BitTorrent::TorrentTransferHistory history;
+        history.record(START_TIME, 0, 0);
+        history.record((START_TIME + HOUR), 5000, 7000);
+        history.record((START_TIME + (30 * HOUR)), 6000, 7000);
+        history.record((START_TIME + (31 * HOUR)), 6000, 9000);
+
+        const BitTorrent::TorrentTransferHistory loaded = BitTorrent::TorrentTransferHistory::fromData(history.toData());
+        QCOMPARE(loaded.toData(), history.toData());
+        for (const qint64 hour : {0, 1, 30, 31})
+        {
+            const qint64 from = START_TIME + (hour * HOUR);
+            QCOMPARE(loaded.transferred(from, (from + HOUR)).uploaded, history.transferred(from, (from + HOUR)).uploaded);
+            QCOMPARE(loaded.transferred(from, (from + HOUR)).downloaded, history.transferred(from, (from + HOUR)).downloaded);
+        }
+
+        // the baseline is restored too
+        BitTorrent::TorrentTransferHistory restored = BitTorrent::TorrentTransferHistory::fromData(history.toData());
+        restored.record((START_TIME + (31 * HOUR)), 6500, 9000);
+        QCOMPARE(restored.transferred((START_TIME + (31 * HOUR)), (START_TIME + (32 * HOUR))).uploaded, qint64 {500});
+
+        const QByteArray corruptedData = history.toData().left(5);
+        QCOMPARE(BitTorrent::TorrentTransferHistory::fromData(corruptedData).transferred(START_TIME, (START_TIME + DAY)).uploaded, qint64 {0});
+    }
+
+    void testDataEmptyRun() const
+    {
+        BitTorrent::TorrentTransferHistory history;
+        history.record(START_TIME, 0, 0);
+        history.record((START_TIME + HOUR), 1000, 0);
+        for (qint64 hour = 2; hour < 10; ++hour)
+            history.record((START_TIME + (hour * HOUR)), 1000, 0);
+
+        // the trailing run of empty buckets keeps being extended after loading
+        BitTorrent::TorrentTransferHistory loaded = BitTorrent::TorrentTransferHistory::fromData(history.toData());
+        for (qint64 hour = 10; hour < 20; ++hour)
+        {
+            history.record((START_TIME + (hour * HOUR)), 1000, 0);
+            loaded.record((START_TIME + (hour * HOUR)), 1000, 0);
+        }
+        QCOMPARE(loaded.toData(), history.toData());
+
+        history.record((START_TIME + (20 * HOUR)), 3000, 0);
+        loaded.record((START_TIME + (20 * HOUR)), 3000, 0);
+        loaded = BitTorrent::TorrentTransferHistory::fromData(loaded.toData());
+        for (qint64 hour = 21; hour < 30; ++hour)
+        {
+            history.record((START_TIME + (hour * HOUR)), 3000, 0);
+            loaded.record((START_TIME + (hour * HOUR)), 3000, 0);
+        }
+        QCOMPARE(loaded.toData(), history.toData());
+        QCOMPARE(loaded.transferred(START_TIME, (START_TIME + (30 * HOUR))).uploaded, qint64 {3000});
+        QCOMPARE(loaded.transferred((START_TIME + (20 * HOUR)), (START_TIME + (21 * HOUR))).uploaded, qint64 {2000});
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentTorrentTransferHistory)
+#include "testbittorrenttorrenttransferhistory.moc"
@@ -0,0 +1,139 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QSet>
+#include <QTest>
+
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/trackerhoststatistics.h"
+#include "base/global.h"
+
+namespace
+{
+    const BitTorrent::TorrentID TORRENT_ID1 = BitTorrent::TorrentID::fromString(u"0123456789abcdef0123456789abcdef01234567"_qs);
+    const BitTorrent::TorrentID TORRENT_ID2 = BitTorrent::TorrentID::fromString(u"89abcdef0123456789abcdef0123456789abcdef"_qs);
+
+    const QString TRACKER_URL1 = u"http://tracker.example.com/announce"_qs;
+    const QString TRACKER_URL2 = u"udp://tracker.example.com:6969/announce"_qs;
+    const QString OTHER_TRACKER_URL = u"http://other.example.org/announce"_qs;
+}
+
+class TestBittorrentTrackerHostStatistics final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentTrackerHostStatistics)
+
+public:
+    TestBittorrentTrackerHostStatistics() = default;
+
+private slots:
+    void testTrackerHost() const
+    {
+        BitTorrent::TrackerHostStatistics statistics;
+        QCOMPARE(statistics.trackerHost(TRACKER_URL1), u"tracker.example.com"_qs);
+        QCOMPARE(statistics.trackerHost(TRACKER_URL2), u"tracker.example.com"_qs);
+        // URLs without host are kept as is
+        QCOMPARE(statistics.trackerHost(u"invalid"_qs), u"invalid"_qs);
+
+        // only the URLs which were announced to are listed
+        QVERIFY(statistics.trackerURLs(u"tracker.example.com"_qs).isEmpty());
+        statistics.handleAnnounceStarted(TORRENT_ID1, TRACKER_URL1);
+        statistics.handleAnnounceStarted(TORRENT_ID2, TRACKER_URL2);
+        statistics.handleAnnounceStarted(TORRENT_ID1, OTHER_TRACKER_URL);
+        QCOMPARE(statistics.trackerURLs(u"tracker.example.com"_qs), (QSet<QString> {TRACKER_URL1, TRACKER_URL2}));
+        QCOMPARE(statistics.statuses().size(), 2);
+    }
+
+    void testStatus() const
+    {
+        BitTorrent::TrackerHostStatistics statistics;
+        QCOMPARE(statistics.status(u"tracker.example.com"_qs).announces, qint64 {0});
+        QCOMPARE(statistics.status(u"tracker.example.com"_qs).latencyP50, -1);
+
+        statistics.handleAnnounceStarted(TORRENT_ID1, TRACKER_URL1);
+        statistics.handleAnnounceReplied(TORRENT_ID1, TRACKER_URL1);
+        statistics.handleAnnounceStarted(TORRENT_ID2, TRACKER_URL2);
+        QVERIFY(!statistics.handleAnnounceFailed(TORRENT_ID2, TRACKER_URL2, u"timed out"_qs));
+        // reply without a started announce doesn't give a latency sample
+        statistics.handleAnnounceReplied(TORRENT_ID2, TRACKER_URL2);
+
+        const BitTorrent::TrackerHostStatus status = statistics.status(u"tracker.example.com"_qs);
+        QCOMPARE(status.host, u"tracker.example.com"_qs);
+        QCOMPARE(status.announces, qint64 {3});
+        QCOMPARE(status.failures, qint64 {1});
+        QCOMPARE(status.successRate, (2.0 / 3));
+        QVERIFY(status.latencyP50 >= 0);
+        QCOMPARE(status.latencyP99, status.latencyP50);
+        QCOMPARE(status.failureStreak, 0);
+        QCOMPARE(status.lastError, u"timed out"_qs);
+        QVERIFY(status.lastErrorTime.isValid());
+        QVERIFY(!status.backoffEnd.isValid());
+    }
+
+    void testBackoff() const
+    {
+        BitTorrent::TrackerHostStatistics statistics;
+        QCOMPARE(statistics.backoffRemaining(TRACKER_URL1), 0);
+
+        QVERIFY(!statistics.handleAnnounceFailed(TORRENT_ID1, TRACKER_URL1, u"error"_qs));
+        QVERIFY(!statistics.handleAnnounceFailed(TORRENT_ID2, TRACKER_URL2, u"error"_qs));
+        QCOMPARE(statistics.backoffRemaining(TRACKER_URL1), 0);
+
+        // the host is backed off after 3 consecutive failures of any of its trackers
+        QVERIFY(statistics.handleAnnounceFailed(TORRENT_ID1, TRACKER_URL1, u"error"_qs));
+        QCOMPARE(statistics.backoffRemaining(TRACKER_URL1), 60);
+        QCOMPARE(statistics.backoffRemaining(TRACKER_URL2), 60);
+        QCOMPARE(statistics.backoffRemaining(OTHER_TRACKER_URL), 0);
+        QCOMPARE(statistics.status(u"tracker.example.com"_qs).failureStreak, 3);
+        QVERIFY(statistics.status(u"tracker.example.com"_qs).backoffEnd.isValid());
+
+        // failures of the announces sent before the backoff don't prolong it
+        QVERIFY(!statistics.handleAnnounceFailed(TORRENT_ID2, TRACKER_URL2, u"error"_qs));
+        QCOMPARE(statistics.backoffRemaining(TRACKER_URL1), 60);
+
+        // any reply ends the backoff
+        statistics.handleAnnounceReplied(TORRENT_ID1, TRACKER_URL1);
+        QCOMPARE(statistics.backoffRemaining(TRACKER_URL2), 0);
+        QCOMPARE(statistics.status(u"tracker.example.com"_qs).failureStreak, 0);
+    }
+
+    void testRemoveTorrent() const
+    {
+        BitTorrent::TrackerHostStatistics statistics;
+        statistics.handleAnnounceStarted(TORRENT_ID1, TRACKER_URL1);
+        statistics.removeTorrent(TORRENT_ID1);
+        statistics.handleAnnounceReplied(TORRENT_ID1, TRACKER_URL1);
+
+        const BitTorrent::TrackerHostStatus status = statistics.status(u"tracker.example.com"_qs);
+        QCOMPARE(status.announces, qint64 {1});
+        QCOMPARE(status.latencyP50, -1);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentTrackerHostStatistics)
+#include "testbittorrenttrackerhoststatistics.moc"
@@ -0,0 +1,200 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QByteArray>
+#include <QHash>
+#include <QTest>
+
+#include "base/bittorrent/sessionstatus.h"
+#include "base/bittorrent/transferhistory.h"
+#include "base/global.h"
+
+using BitTorrent::TransferHistory;
+
+namespace
+{
+    const qint64 HOUR = 60 * 60;
+    // start of a day
+    const qint64 START_TIME = 1699920000;
+
+    BitTorrent::SessionStatus makeStatus(const qint64 uploadRate, const qint64 downloadRate)
+    {
+        BitTorrent::SessionStatus status;
+        status.uploadRate = uploadRate;
+        status.downloadRate = downloadRate;
+        return status;
+    }
+}
+
+class TestBittorrentTransferHistory final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentTransferHistory)
+
+public:
+    TestBittorrentTransferHistory() = default;
+
+private slots:
+    void testRecord() const
+    {
+        TransferHistory history;
+        QCOMPARE(history.series(TransferHistory::Resolution::Second, 0).samplesCount(), 0);
+
+        history.record(START_TIME, makeStatus(1000, 500));
+        // samples within a slot are averaged
+        history.record(START_TIME, makeStatus(3000, 1500));
+        history.record((START_TIME + 1), makeStatus(-10, 100));
+        // short gaps are filled by the next sample
+        history.record((START_TIME + 3), makeStatus(400, 0));
+
+        BitTorrent::TransferHistorySeries series = history.series(TransferHistory::Resolution::Second, 0);
+        QCOMPARE(series.startTime, START_TIME);
+        QCOMPARE(series.interval, 1);
+        QCOMPARE(series.metricsCount, static_cast<int>(TransferHistory::MetricsCount));
+        QCOMPARE(series.samplesCount(), 4);
+        QCOMPARE(series.value(0, TransferHistory::Upload), 2000u);
+        QCOMPARE(series.value(0, TransferHistory::Download), 1000u);
+        QCOMPARE(series.value(1, TransferHistory::Upload), 0u);
+        QCOMPARE(series.value(1, TransferHistory::Download), 100u);
+        QCOMPARE(series.value(2, TransferHistory::Upload), 400u);
+        QCOMPARE(series.value(3, TransferHistory::Upload), 400u);
+
+        // long gaps are missing data
+        history.record((START_TIME + 60), makeStatus(700, 0));
+        series = history.series(TransferHistory::Resolution::Second, (START_TIME + 4));
+        QCOMPARE(series.startTime, (START_TIME + 4));
+        QCOMPARE(series.samplesCount(), 57);
+        QCOMPARE(series.value(0, TransferHistory::Upload), 0u);
+        QCOMPARE(series.value(56, TransferHistory::Upload), 700u);
+
+        // clock going backwards doesn't overwrite older samples
+        history.record((START_TIME + 30), makeStatus(100, 0));
+        series = history.series(TransferHistory::Resolution::Second, (START_TIME + 60));
+        QCOMPARE(series.samplesCount(), 1);
+        QCOMPARE(series.value(0, TransferHistory::Upload), 400u);
+    }
+
+    void testDownsampling() const
+    {
+        TransferHistory history;
+        for (qint64 time = 0; time < (2 * HOUR); ++time)
+            history.record((START_TIME + time), makeStatus(((time < HOUR) ? 100 : 300), 0));
+
+        // per second samples are kept for the last hour only
+        const BitTorrent::TransferHistorySeries seconds = history.series(TransferHistory::Resolution::Second, 0);
+        QCOMPARE(seconds.startTime, (START_TIME + HOUR));
+        QCOMPARE(seconds.samplesCount(), 3600);
+        QCOMPARE(seconds.value(0, TransferHistory::Upload), 300u);
+
+        const BitTorrent::TransferHistorySeries minutes = history.series(TransferHistory::Resolution::Minute, 0);
+        QCOMPARE(minutes.startTime, START_TIME);
+        QCOMPARE(minutes.interval, 60);
+        QCOMPARE(minutes.samplesCount(), 120);
+        QCOMPARE(minutes.value(0, TransferHistory::Upload), 100u);
+        QCOMPARE(minutes.value(59, TransferHistory::Upload), 100u);
+        QCOMPARE(minutes.value(60, TransferHistory::Upload), 300u);
+
+        const BitTorrent::TransferHistorySeries hours = history.series(TransferHistory::Resolution::Hour, 0);
+        QCOMPARE(hours.startTime, START_TIME);
+        QCOMPARE(hours.interval, 3600);
+        QCOMPARE(hours.samplesCount(), 2);
+        QCOMPARE(hours.value(0, TransferHistory::Upload), 100u);
+        QCOMPARE(hours.value(1, TransferHistory::Upload), 300u);
+    }
+
+    void testCategories() const
+    {
+        TransferHistory history;
+        history.recordCategories(START_TIME, {{u"movies"_qs, {10, 20}}, {u"music"_qs, {30, 40}}});
+        QCOMPARE(history.categories().size(), 2);
+
+        const BitTorrent::TransferHistorySeries series = history.series(TransferHistory::Resolution::Minute, 0, u"music"_qs);
+        QCOMPARE(series.metricsCount, static_cast<int>(TransferHistory::CategoryMetricsCount));
+        QCOMPARE(series.samplesCount(), 1);
+        QCOMPARE(series.value(0, TransferHistory::CategoryPayloadUpload), 30u);
+        QCOMPARE(series.value(0, TransferHistory::CategoryPayloadDownload), 40u);
+
+        // removed categories are dropped
+        history.recordCategories((START_TIME + 1), {{u"movies"_qs, {10, 20}}});
+        QCOMPARE(history.categories(), QStringList {u"movies"_qs});
+        QCOMPARE(history.series(TransferHistory::Resolution::Minute, 0, u"music"_qs).samplesCount(), 0);
+    }
+
+    void testSerialize() const
+    {
+        TransferHistory history;
+        for (qint64 time = 0; time < 90; ++time)
+            history.record((START_TIME + time), makeStatus(time, (2 * time)));
+        history.recordCategories(START_TIME, {{u"movies"_qs, {10, 20}}});
+
+        const QByteArray data = history.serialize();
+        TransferHistory loaded;
+        QVERIFY(loaded.load(data));
+        QCOMPARE(loaded.serialize(), data);
+        QCOMPARE(loaded.categories(), history.categories());
+        for (const auto resolution : {TransferHistory::Resolution::Second, TransferHistory::Resolution::Minute, TransferHistory::Resolution::Hour})
+        {
+            const BitTorrent::TransferHistorySeries expected = history.series(resolution, 0);
+            const BitTorrent::TransferHistorySeries actual = loaded.series(resolution, 0);
+            QCOMPARE(actual.startTime, expected.startTime);
+            QCOMPARE(actual.values, expected.values);
+        }
+        QCOMPARE(loaded.series(TransferHistory::Resolution::Second, 0, u"movies"_qs).values
+            , history.series(TransferHistory::Resolution::Second, 0, u"movies"_qs).values);
+    }
+
+    void testLoadInvalid() const
+    {
+        TransferHistory history;
+        history.record(START_TIME, makeStatus(1000, 500));
+        const QByteArray data = history.serialize();
+        const QByteArray uncompressedData = qUncompress(data);
+        const auto uncompressedSize = static_cast<int>(uncompressedData.size());
+
+        TransferHistory loaded;
+        loaded.record(START_TIME, makeStatus(5, 5));
+        const QByteArray loadedData = loaded.serialize();
+
+        QVERIFY(!loaded.load({}));
+        QVERIFY(!loaded.load(data.left(data.size() / 2)));
+        QVERIFY(!loaded.load(qCompress(QByteArray("garbage"))));
+        // every truncation of the stream is detected
+        for (const int size : {4, 8, 12, 100, (uncompressedSize - 4), (uncompressedSize - 1)})
+            QVERIFY(!loaded.load(qCompress(uncompressedData.left(size))));
+
+        QByteArray wrongVersion = uncompressedData;
+        wrongVersion[7] = 2;
+        QVERIFY(!loaded.load(qCompress(wrongVersion)));
+
+        // failed loading keeps the current history
+        QCOMPARE(loaded.serialize(), loadedData);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentTransferHistory)
+#include "testbittorrenttransferhistory.moc"
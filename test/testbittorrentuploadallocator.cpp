@@ -0,0 +1,126 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <limits>
+
+#include <QHash>
+#include <QTest>
+#include <QVector>
+
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/uploadallocator.h"
+#include "base/global.h"
+
+using BitTorrent::TorrentID;
+using BitTorrent::UploadAllocator;
+using BitTorrent::UploadCandidate;
+
+namespace
+{
+    const TorrentID TORRENT_ID1 = TorrentID::fromString(u"0123456789abcdef0123456789abcdef01234567"_qs);
+    const TorrentID TORRENT_ID2 = TorrentID::fromString(u"89abcdef0123456789abcdef0123456789abcdef"_qs);
+    const TorrentID TORRENT_ID3 = TorrentID::fromString(u"fedcba9876543210fedcba9876543210fedcba98"_qs);
+
+    UploadCandidate makeCandidate(const TorrentID &id, const qreal weight, const qint64 cap = std::numeric_limits<int>::max())
+    {
+        return {id, weight, cap};
+    }
+}
+
+class TestBittorrentUploadAllocator final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentUploadAllocator)
+
+public:
+    TestBittorrentUploadAllocator() = default;
+
+private slots:
+    void testNoDemand() const
+    {
+        QVERIFY(UploadAllocator::distribute({}, 100000).isEmpty());
+        QVERIFY(UploadAllocator::distribute({makeCandidate(TORRENT_ID1, 0), makeCandidate(TORRENT_ID2, 0)}, 100000).isEmpty());
+    }
+
+    void testDistribute() const
+    {
+        // a tenth of the budget is shared equally, the rest by weight
+        const QHash<TorrentID, int> limits = UploadAllocator::distribute({makeCandidate(TORRENT_ID1, 1)
+                , makeCandidate(TORRENT_ID2, 1), makeCandidate(TORRENT_ID3, 2)}, 100000);
+        QCOMPARE(static_cast<int>(limits.size()), 3);
+        QCOMPARE(limits.value(TORRENT_ID1), 25833);
+        QCOMPARE(limits.value(TORRENT_ID2), 25833);
+        QCOMPARE(limits.value(TORRENT_ID3), 48333);
+
+        // torrent without demand gets the equal part only
+        const QHash<TorrentID, int> idleLimits = UploadAllocator::distribute({makeCandidate(TORRENT_ID1, 0)
+                , makeCandidate(TORRENT_ID2, 1)}, 100000);
+        QCOMPARE(idleLimits.value(TORRENT_ID1), 5000);
+        QCOMPARE(idleLimits.value(TORRENT_ID2), 95000);
+    }
+
+    void testMinLimit() const
+    {
+        // the limits never go below 1 KiB/s, even if the budget is exceeded
+        const QHash<TorrentID, int> limits = UploadAllocator::distribute({makeCandidate(TORRENT_ID1, 1)
+                , makeCandidate(TORRENT_ID2, 3)}, 1000);
+        QCOMPARE(limits.value(TORRENT_ID1), 1024);
+        QCOMPARE(limits.value(TORRENT_ID2), 1024);
+
+        // the cap doesn't go below the equal part either
+        const QHash<TorrentID, int> cappedLimits = UploadAllocator::distribute({makeCandidate(TORRENT_ID1, 1, 100)
+                , makeCandidate(TORRENT_ID2, 1)}, 100000);
+        QCOMPARE(cappedLimits.value(TORRENT_ID1), 5000);
+        QCOMPARE(cappedLimits.value(TORRENT_ID2), 95000);
+    }
+
+    void testRedistribution() const
+    {
+        // the part the capped torrent can't use goes to the others
+        const QHash<TorrentID, int> limits = UploadAllocator::distribute({makeCandidate(TORRENT_ID1, 1, 20000)
+                , makeCandidate(TORRENT_ID2, 1)}, 100000);
+        QCOMPARE(limits.value(TORRENT_ID1), 20000);
+        QCOMPARE(limits.value(TORRENT_ID2), 80000);
+
+        // redistributed by weight among the uncapped ones
+        const QHash<TorrentID, int> weightedLimits = UploadAllocator::distribute({makeCandidate(TORRENT_ID1, 2, 10000)
+                , makeCandidate(TORRENT_ID2, 1), makeCandidate(TORRENT_ID3, 3)}, 99000);
+        QCOMPARE(weightedLimits.value(TORRENT_ID1), 10000);
+        QCOMPARE(weightedLimits.value(TORRENT_ID2), 23900);
+        QCOMPARE(weightedLimits.value(TORRENT_ID3), 65100);
+
+        // nothing is left over if all of them are capped
+        const QHash<TorrentID, int> cappedLimits = UploadAllocator::distribute({makeCandidate(TORRENT_ID1, 1, 20000)
+                , makeCandidate(TORRENT_ID2, 1, 30000)}, 100000);
+        QCOMPARE(cappedLimits.value(TORRENT_ID1), 20000);
+        QCOMPARE(cappedLimits.value(TORRENT_ID2), 30000);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentUploadAllocator)
+#include "testbittorrentuploadallocator.moc"
@@ -0,0 +1,108 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QHash>
+#include <QSet>
+#include <QTest>
+
+#include "base/bittorrent/infohash.h"
+#include "base/global.h"
+
+class TestDigest32 final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestDigest32)
+
+public:
+    TestDigest32() = default;
+
+private slots:
+    void testDefault() const
+    {
+        const SHA1Hash hash;
+        QVERIFY(!hash.isValid());
+        QVERIFY(hash.toString().isEmpty());
+        QCOMPARE(hash, SHA1Hash());
+    }
+
+    void testFromString() const
+    {
+        const QString hexString = u"0123456789abcdef0123456789abcdef01234567"_qs;
+
+        const SHA1Hash hash = SHA1Hash::fromString(hexString);
+        QVERIFY(hash.isValid());
+        QCOMPARE(hash.toString(), hexString);
+
+        const SHA1Hash upperCaseHash = SHA1Hash::fromString(hexString.toUpper());
+        QVERIFY(upperCaseHash.isValid());
+        QCOMPARE(upperCaseHash, hash);
+        QCOMPARE(upperCaseHash.toString(), hexString);
+
+        const auto raw = static_cast<SHA1Hash::UnderlyingType>(hash);
+        QCOMPARE(static_cast<uchar>(raw.data()[0]), uchar(0x01));
+        QCOMPARE(static_cast<uchar>(raw.data()[19]), uchar(0x67));
+    }
+
+    void testFromInvalidString() const
+    {
+        QVERIFY(!SHA1Hash::fromString({}).isValid());
+        QVERIFY(!SHA1Hash::fromString(u"0123456789abcdef"_qs).isValid());
+        QVERIFY(!SHA1Hash::fromString(u"0123456789abcdef0123456789abcdef012345678"_qs).isValid());
+        QVERIFY(!SHA1Hash::fromString(u"0123456789abcdef0123456789abcdef0123456g"_qs).isValid());
+        QVERIFY(!SHA1Hash::fromString(u"0123456789abcdef0123456789abcdef012345 7"_qs).isValid());
+        QVERIFY(!SHA1Hash::fromString(u"0123456789abcdef0123456789abcdef012345٠١"_qs).isValid());
+        QVERIFY(!BitTorrent::TorrentID::fromString(u"not a hash"_qs).isValid());
+    }
+
+    void testRoundTrip() const
+    {
+        const QString hexString = u"ffeeddccbbaa99887766554433221100ffeeddccbbaa99887766554433221100"_qs;
+
+        const SHA256Hash hash = SHA256Hash::fromString(hexString);
+        QVERIFY(hash.isValid());
+        QCOMPARE(hash.toString(), hexString);
+        QCOMPARE(SHA256Hash::fromString(hash.toString()), hash);
+    }
+
+    void testHash() const
+    {
+        const auto id1 = BitTorrent::TorrentID::fromString(u"0123456789abcdef0123456789abcdef01234567"_qs);
+        const auto id2 = BitTorrent::TorrentID::fromString(u"0123456789abcdef0123456789abcdef01234568"_qs);
+        const auto id3 = BitTorrent::TorrentID::fromString(u"1123456789abcdef0123456789abcdef01234567"_qs);
+
+        QCOMPARE(qHash(id1), qHash(BitTorrent::TorrentID(id1)));
+        QVERIFY(qHash(id1) != qHash(id3));
+
+        const QSet<BitTorrent::TorrentID> ids {id1, id2, id3};
+        QCOMPARE(ids.size(), 3);
+        QVERIFY(ids.contains(id2));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestDigest32)
+#include "testdigest32.moc"
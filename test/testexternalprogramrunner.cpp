@@ -0,0 +1,118 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QTest>
+
+#include "app/externalprogramrunner.h"
+#include "base/global.h"
+
+namespace
+{
+    QString placeholderValue(const char16_t placeholder)
+    {
+        switch (placeholder)
+        {
+        case u'F':
+            return u"/downloads/My torrent"_qs;
+        case u'I':
+            return u"0123456789abcdef"_qs;
+        case u'N':
+            return u"My %I torrent"_qs;
+        default:
+            return u"<%1>"_qs.arg(QChar(placeholder));
+        }
+    }
+
+    QString expand(const QString &str)
+    {
+        return ExternalProgramRunner::expand(ExternalProgramRunner::parse(str), placeholderValue);
+    }
+}
+
+class TestExternalProgramRunner final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestExternalProgramRunner)
+
+public:
+    TestExternalProgramRunner() = default;
+
+private slots:
+    void testParse() const
+    {
+        QVERIFY(ExternalProgramRunner::parse({}).isEmpty());
+
+        const ExternalProgramRunner::ParsedString literal = ExternalProgramRunner::parse(u"/bin/true"_qs);
+        QCOMPARE(literal.size(), 1);
+        QCOMPARE(literal[0].text, u"/bin/true"_qs);
+        QCOMPARE(literal[0].placeholder, char16_t {0});
+
+        const ExternalProgramRunner::ParsedString parsed = ExternalProgramRunner::parse(u"run %N --hash=%I"_qs);
+        QCOMPARE(parsed.size(), 4);
+        QCOMPARE(parsed[0].text, u"run "_qs);
+        QCOMPARE(parsed[1].placeholder, char16_t {u'N'});
+        QCOMPARE(parsed[2].text, u" --hash="_qs);
+        QCOMPARE(parsed[3].placeholder, char16_t {u'I'});
+    }
+
+    void testExpand() const
+    {
+        QCOMPARE(expand({}), QString());
+        QCOMPARE(expand(u"run --hash=%I"_qs), u"run --hash=0123456789abcdef"_qs);
+        QCOMPARE(expand(u"%I%I"_qs), u"0123456789abcdef0123456789abcdef"_qs);
+        QCOMPARE(expand(u"%C %D %G %J %K %L %R %T %Z"_qs), u"<C> <D> <G> <J> <K> <L> <R> <T> <Z>"_qs);
+
+        // unknown specifiers and a trailing '%' are kept as is
+        QCOMPARE(expand(u"100% %X %"_qs), u"100% %X %"_qs);
+
+        // placeholders in the values aren't expanded again
+        QCOMPARE(expand(u"%N"_qs), u"My %I torrent"_qs);
+    }
+
+    void testQuoting() const
+    {
+        QCOMPARE(expand(u"run \"%F\""_qs), u"run \"/downloads/My torrent\""_qs);
+        QCOMPARE(expand(u"run '%F' \"%N\""_qs), u"run '/downloads/My torrent' \"My %I torrent\""_qs);
+    }
+
+    void testEscape() const
+    {
+        // the character preceding a '%' never starts a placeholder
+        const ExternalProgramRunner::ParsedString parsed = ExternalProgramRunner::parse(u"%%N"_qs);
+        QCOMPARE(parsed.size(), 2);
+        QCOMPARE(parsed[0].text, u"%"_qs);
+        QCOMPARE(parsed[1].placeholder, char16_t {u'N'});
+
+        QCOMPARE(expand(u"%%N"_qs), u"%My %I torrent"_qs);
+        QCOMPARE(expand(u"%%%I"_qs), u"%%0123456789abcdef"_qs);
+        QCOMPARE(expand(u"50%%"_qs), u"50%%"_qs);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestExternalProgramRunner)
+#include "testexternalprogramrunner.moc"
@@ -0,0 +1,310 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPointer>
+#include <QQueue>
+#include <QStringList>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QVector>
+
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/net/downloadmanager.h"
+#include "base/net/proxyconfigurationmanager.h"
+#include "base/path.h"
+#include "base/preferences.h"
+#include "base/profile.h"
+#include "base/settingsstorage.h"
+
+namespace
+{
+    // default limit of the concurrent requests to a single host
+    const int MAX_REQUESTS_PER_HOST = 4;
+
+    struct Response
+    {
+        int statusCode = 200;
+        QByteArray headers;
+        QByteArray body = "ok";
+    };
+
+    // Minimal HTTP server replying with the responses queued for the request path
+    class HttpServer final : public QObject
+    {
+    public:
+        HttpServer()
+        {
+            m_server.listen(QHostAddress::LocalHost);
+            connect(&m_server, &QTcpServer::newConnection, this, &HttpServer::acceptConnections);
+        }
+
+        QString url(const QString &path) const
+        {
+            return u"http://127.0.0.1:%1%2"_qs.arg(QString::number(m_server.serverPort()), path);
+        }
+
+        // replies are held back until release() is called
+        void hold()
+        {
+            m_isHolding = true;
+        }
+
+        void release()
+        {
+            m_isHolding = false;
+            while (!m_heldRequests.isEmpty())
+            {
+                const auto [socket, path] = m_heldRequests.dequeue();
+                if (socket)
+                    reply(socket, path);
+            }
+        }
+
+        int pendingRequests() const
+        {
+            return m_heldRequests.size();
+        }
+
+        // responses for the request path, "200 ok" is used once it is empty
+        QHash<QString, QQueue<Response>> responses;
+        // request lines of the received requests, e.g. "GET /file"
+        QStringList requests;
+        int maxPendingRequests = 0;
+
+    private:
+        void acceptConnections()
+        {
+            while (QTcpSocket *socket = m_server.nextPendingConnection())
+            {
+                connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { readRequests(socket); });
+                connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+                connect(socket, &QObject::destroyed, this, [this, socket]() { m_buffers.remove(socket); });
+            }
+        }
+
+        void readRequests(QTcpSocket *socket)
+        {
+            QByteArray &buffer = m_buffers[socket];
+            buffer += socket->readAll();
+
+            // the connection may be kept alive and carry several requests
+            while (true)
+            {
+                const int headerEnd = buffer.indexOf("\r\n\r\n");
+                if (headerEnd < 0)
+                    return;
+
+                int contentLength = 0;
+                const QList<QByteArray> headerLines = buffer.left(headerEnd).split('\n');
+                for (const QByteArray &line : headerLines)
+                {
+                    if (line.toLower().startsWith("content-length:"))
+                        contentLength = line.mid(15).trimmed().toInt();
+                }
+
+                const int requestSize = headerEnd + 4 + contentLength;
+                if (buffer.size() < requestSize)
+                    return;
+
+                const QList<QByteArray> requestLine = headerLines.first().trimmed().split(' ');
+                const QString method = QString::fromLatin1(requestLine.value(0));
+                const QString path = QString::fromLatin1(requestLine.value(1));
+                requests.append(method + u' ' + path);
+                buffer.remove(0, requestSize);
+
+                m_heldRequests.enqueue({socket, path});
+                maxPendingRequests = std::max(maxPendingRequests, static_cast<int>(m_heldRequests.size()));
+                if (!m_isHolding)
+                    release();
+            }
+        }
+
+        void reply(QTcpSocket *socket, const QString &path)
+        {
+            QQueue<Response> &pathResponses = responses[path];
+            const Response response = pathResponses.isEmpty() ? Response() : pathResponses.dequeue();
+            socket->write("HTTP/1.1 " + QByteArray::number(response.statusCode) + " Status\r\n"
+                    + response.headers
+                    + "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n\r\n"
+                    + response.body);
+        }
+
+        struct HeldRequest
+        {
+            QPointer<QTcpSocket> socket;
+            QString path;
+        };
+
+        QTcpServer m_server;
+        QHash<QTcpSocket *, QByteArray> m_buffers;
+        QQueue<HeldRequest> m_heldRequests;
+        bool m_isHolding = false;
+    };
+
+    struct Download
+    {
+        bool isFinished = false;
+        Net::DownloadResult result;
+        qint64 duration = 0;
+    };
+
+    void startDownload(const Net::DownloadRequest &request, Download &download)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        const Net::DownloadHandler *handler = Net::DownloadManager::instance()->download(request, false);
+        QObject::connect(handler, &Net::DownloadHandler::finished, handler, [&download, timer](const Net::DownloadResult &result)
+        {
+            download.isFinished = true;
+            download.result = result;
+            download.duration = timer.elapsed();
+        });
+    }
+}
+
+class TestNetDownloadManager final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestNetDownloadManager)
+
+public:
+    TestNetDownloadManager() = default;
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_profileDir.isValid());
+
+        Logger::initInstance();
+        Profile::initInstance(Path(m_profileDir.path()), {}, false);
+        SettingsStorage::initInstance();
+        Preferences::initInstance();
+        Net::ProxyConfigurationManager::initInstance();
+        Net::DownloadManager::initInstance();
+    }
+
+    void cleanupTestCase()
+    {
+        Net::DownloadManager::freeInstance();
+        Net::ProxyConfigurationManager::freeInstance();
+        Preferences::freeInstance();
+        SettingsStorage::freeInstance();
+        Profile::freeInstance();
+        Logger::freeInstance();
+    }
+
+    void testRetryAfter() const
+    {
+        HttpServer server;
+        server.responses[u"/throttled"_qs].enqueue({429, "Retry-After: 2\r\n", {}});
+        server.responses[u"/unavailable"_qs].enqueue({503, "Retry-After: 0\r\n", {}});
+        server.responses[u"/unavailable"_qs].enqueue({503, "Retry-After: 0\r\n", {}});
+
+        // without Retry-After the first retry is delayed by a second
+        Download throttled;
+        startDownload(Net::DownloadRequest(server.url(u"/throttled"_qs)), throttled);
+        Download unavailable;
+        startDownload(Net::DownloadRequest(server.url(u"/unavailable"_qs)), unavailable);
+
+        QTRY_VERIFY_WITH_TIMEOUT((throttled.isFinished && unavailable.isFinished), 10000);
+        QCOMPARE(throttled.result.status, Net::DownloadStatus::Success);
+        QCOMPARE(throttled.result.data, QByteArray("ok"));
+        QVERIFY(throttled.duration >= 1900);
+        QCOMPARE(unavailable.result.status, Net::DownloadStatus::Success);
+        QVERIFY(unavailable.duration < 900);
+
+        QCOMPARE(server.requests.count(u"GET /throttled"_qs), 2);
+        QCOMPARE(server.requests.count(u"GET /unavailable"_qs), 3);
+    }
+
+    void testRetryLimit() const
+    {
+        HttpServer server;
+        for (int i = 0; i < 5; ++i)
+            server.responses[u"/down"_qs].enqueue({503, "Retry-After: 0\r\n", {}});
+
+        Download down;
+        startDownload(Net::DownloadRequest(server.url(u"/down"_qs)), down);
+        QTRY_VERIFY_WITH_TIMEOUT(down.isFinished, 10000);
+        QCOMPARE(down.result.status, Net::DownloadStatus::Failed);
+        // the first attempt and 3 retries
+        QCOMPARE(server.requests.count(u"GET /down"_qs), 4);
+    }
+
+    void testNoPostRetry() const
+    {
+        HttpServer server;
+        server.responses[u"/post"_qs].enqueue({503, "Retry-After: 0\r\n", {}});
+
+        Download post;
+        startDownload(Net::DownloadRequest(server.url(u"/post"_qs)).postData("data"), post);
+        QTRY_VERIFY_WITH_TIMEOUT(post.isFinished, 10000);
+        QCOMPARE(post.result.status, Net::DownloadStatus::Failed);
+
+        QTest::qWait(500);
+        QCOMPARE(server.requests, QStringList {u"POST /post"_qs});
+    }
+
+    void testMaxRequestsPerHost() const
+    {
+        HttpServer server;
+        server.hold();
+
+        const int downloadsCount = 10;
+        QVector<Download> downloads(downloadsCount);
+        for (int i = 0; i < downloadsCount; ++i)
+            startDownload(Net::DownloadRequest(server.url(u"/file%1"_qs.arg(i))), downloads[i]);
+
+        QTRY_COMPARE_WITH_TIMEOUT(server.pendingRequests(), MAX_REQUESTS_PER_HOST, 5000);
+        // the waiting requests aren't started until some of the active ones are finished
+        QTest::qWait(500);
+        QCOMPARE(server.requests.size(), MAX_REQUESTS_PER_HOST);
+
+        server.release();
+        QTRY_VERIFY_WITH_TIMEOUT(std::all_of(downloads.cbegin(), downloads.cend()
+                , [](const Download &item) { return item.isFinished; }), 10000);
+        QCOMPARE(server.requests.size(), downloadsCount);
+        QCOMPARE(server.maxPendingRequests, MAX_REQUESTS_PER_HOST);
+        for (const Download &item : asConst(downloads))
+            QCOMPARE(item.result.status, Net::DownloadStatus::Success);
+    }
+
+private:
+    QTemporaryDir m_profileDir;
+};
+
+QTEST_GUILESS_MAIN(TestNetDownloadManager)
+#include "testnetdownloadmanager.moc"
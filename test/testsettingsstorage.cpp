@@ -0,0 +1,236 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <memory>
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QVariantHash>
+
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/path.h"
+#include "base/profile.h"
+#include "base/settingsstorage.h"
+#include "base/utils/fs.h"
+
+namespace
+{
+    const QString KEY_A = u"Test/A"_qs;
+    const QString KEY_B = u"Test/B"_qs;
+    const QString KEY_C = u"Test/C"_qs;
+
+    Path settingsPath(const QString &name)
+    {
+        return Path(Profile::instance()->applicationSettings(name)->fileName());
+    }
+
+    Path configPath()
+    {
+        return settingsPath(u"qBittorrent"_qs);
+    }
+
+    Path newConfigPath()
+    {
+        return settingsPath(u"qBittorrent_new"_qs);
+    }
+
+    Path journalPath()
+    {
+        return configPath().removedExtension() + u".journal";
+    }
+
+    QByteArray readFile(const Path &path)
+    {
+        QFile file {path.data()};
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    bool writeFile(const Path &path, const QByteArray &data)
+    {
+        QFile file {path.data()};
+        return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && (file.write(data) == data.size());
+    }
+
+    void writeSettings(const Path &path, const QVariantHash &values)
+    {
+        QSettings settings {path.data(), QSettings::IniFormat};
+        settings.clear();
+        for (auto iter = values.cbegin(); iter != values.cend(); ++iter)
+            settings.setValue(iter.key(), iter.value());
+        settings.sync();
+    }
+
+    int loadValue(const QString &key)
+    {
+        return SettingsStorage::instance()->loadValue(key, -1);
+    }
+}
+
+class TestSettingsStorage final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestSettingsStorage)
+
+public:
+    TestSettingsStorage() = default;
+
+private slots:
+    void initTestCase()
+    {
+        Logger::initInstance();
+    }
+
+    void cleanupTestCase()
+    {
+        Logger::freeInstance();
+    }
+
+    void init()
+    {
+        m_profileDir = std::make_unique<QTemporaryDir>();
+        QVERIFY(m_profileDir->isValid());
+
+        Profile::initInstance(Path(m_profileDir->path()), {}, false);
+        SettingsStorage::initInstance();
+    }
+
+    void cleanup()
+    {
+        SettingsStorage::freeInstance();
+        Profile::freeInstance();
+        m_profileDir.reset();
+    }
+
+    void testRestart() const
+    {
+        SettingsStorage::instance()->storeValue(KEY_A, 1);
+        SettingsStorage::instance()->storeValue(KEY_B, 2);
+        QVERIFY(SettingsStorage::instance()->save());
+        SettingsStorage::instance()->removeValue(KEY_B);
+        SettingsStorage::instance()->storeValue(KEY_C, 3);
+
+        restart();
+        QCOMPARE(loadValue(KEY_A), 1);
+        QCOMPARE(loadValue(KEY_B), -1);
+        QCOMPARE(loadValue(KEY_C), 3);
+        QVERIFY(configPath().exists());
+        QVERIFY(!journalPath().exists());
+    }
+
+    void testReplayJournal() const
+    {
+        SettingsStorage::instance()->storeValue(KEY_A, 1);
+        QVERIFY(SettingsStorage::instance()->save());
+        SettingsStorage::instance()->storeValue(KEY_B, 2);
+        QVERIFY(SettingsStorage::instance()->save());
+
+        // simulate a crash: the configuration file is never written and the journal stays
+        const QByteArray journal = readFile(journalPath());
+        QVERIFY(!journal.isEmpty());
+        SettingsStorage::freeInstance();
+        QVERIFY(Utils::Fs::removeFile(configPath()));
+        QVERIFY(writeFile(journalPath(), journal));
+
+        SettingsStorage::initInstance();
+        QCOMPARE(loadValue(KEY_A), 1);
+        QCOMPARE(loadValue(KEY_B), 2);
+    }
+
+    void testRecoverInterruptedSave() const
+    {
+        SettingsStorage::instance()->storeValue(KEY_A, 1);
+        QVERIFY(SettingsStorage::instance()->save());
+        const QByteArray journal = readFile(journalPath());
+        QVERIFY(!journal.isEmpty());
+        SettingsStorage::freeInstance();
+
+        // simulate a save interrupted before "_new" file replaced the configuration file,
+        // followed by changes recorded in the journal
+        writeSettings(configPath(), {{KEY_A, -2}, {KEY_C, 3}});
+        writeSettings(newConfigPath(), {{KEY_A, 0}, {KEY_B, 2}});
+        QVERIFY(writeFile(journalPath(), journal));
+
+        SettingsStorage::initInstance();
+        QCOMPARE(loadValue(KEY_A), 1);
+        QCOMPARE(loadValue(KEY_B), 2);
+        QCOMPARE(loadValue(KEY_C), -1);
+        QVERIFY(!newConfigPath().exists());
+
+        restart();
+        QCOMPARE(loadValue(KEY_A), 1);
+        QCOMPARE(loadValue(KEY_B), 2);
+        QCOMPARE(loadValue(KEY_C), -1);
+    }
+
+    void testRenameFailure() const
+    {
+        SettingsStorage::instance()->storeValue(KEY_A, 1);
+        QVERIFY(SettingsStorage::instance()->save());
+        SettingsStorage::instance()->storeValue(KEY_B, 2);
+
+        // a non-empty directory in place of the configuration file can't be replaced
+        const Path blockerPath = configPath() / Path(u"blocker"_qs);
+        QVERIFY(QDir().mkpath(configPath().data()));
+        QVERIFY(writeFile(blockerPath, "blocker"));
+
+        SettingsStorage::freeInstance();
+        QVERIFY(newConfigPath().exists());
+        QVERIFY(journalPath().exists());
+
+        QVERIFY(Utils::Fs::removeFile(blockerPath));
+        QVERIFY(QDir().rmdir(configPath().data()));
+
+        SettingsStorage::initInstance();
+        QCOMPARE(loadValue(KEY_A), 1);
+        QCOMPARE(loadValue(KEY_B), 2);
+
+        restart();
+        QCOMPARE(loadValue(KEY_A), 1);
+        QCOMPARE(loadValue(KEY_B), 2);
+        QVERIFY(configPath().exists());
+        QVERIFY(!newConfigPath().exists());
+        QVERIFY(!journalPath().exists());
+    }
+
+private:
+    void restart() const
+    {
+        SettingsStorage::freeInstance();
+        SettingsStorage::initInstance();
+    }
+
+    std::unique_ptr<QTemporaryDir> m_profileDir;
+};
+
+QTEST_GUILESS_MAIN(TestSettingsStorage)
+#include "testsettingsstorage.moc"
@@ -0,0 +1,116 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QString>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/path.h"
+#include "base/stringpool.h"
+
+// The values are built at runtime, since the string literals aren't reference counted
+class TestStringPool final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestStringPool)
+
+public:
+    TestStringPool() = default;
+
+private slots:
+    void testIntern() const
+    {
+        StringPool pool;
+        QVERIFY(pool.intern(QString()).isEmpty());
+        QVERIFY(pool.intern(QString::fromLatin1("")).isEmpty());
+        QCOMPARE(pool.count(), qsizetype {0});
+
+        const QString first = pool.intern(QString::fromLatin1("http://tracker.example.com/announce"));
+        const QString second = pool.intern(QString::fromLatin1("http://tracker.example.com/announce"));
+        QCOMPARE(second, first);
+        QVERIFY(second.constData() == first.constData());
+        QCOMPARE(pool.count(), qsizetype {1});
+
+        const QString other = pool.intern(QString::fromLatin1("udp://tracker.example.com:6969/announce"));
+        QCOMPARE(other, u"udp://tracker.example.com:6969/announce"_qs);
+        QVERIFY(other.constData() != first.constData());
+        QCOMPARE(pool.count(), qsizetype {2});
+    }
+
+    void testInternPath() const
+    {
+        StringPool pool;
+        QVERIFY(pool.intern(Path()).isEmpty());
+        QCOMPARE(pool.count(), qsizetype {0});
+
+        const Path first = pool.intern(Path(QString::fromLatin1("/downloads/movies")));
+        const Path second = pool.intern(Path(QString::fromLatin1("/downloads/movies")));
+        QCOMPARE(second, first);
+        QVERIFY(second.data().constData() == first.data().constData());
+        QCOMPARE(pool.count(), qsizetype {1});
+
+        // strings and paths are pooled separately
+        const QString str = pool.intern(QString::fromLatin1("/downloads/movies"));
+        QCOMPARE(str, first.data());
+        QCOMPARE(pool.count(), qsizetype {2});
+    }
+
+    void testSqueeze() const
+    {
+        StringPool pool;
+        QString keptString = pool.intern(QString::fromLatin1("kept"));
+        pool.intern(QString::fromLatin1("dropped"));
+        Path keptPath = pool.intern(Path(QString::fromLatin1("/downloads/kept")));
+        pool.intern(Path(QString::fromLatin1("/downloads/dropped")));
+        QCOMPARE(pool.count(), qsizetype {4});
+
+        const qint64 memoryUsage = pool.memoryUsage();
+        QVERIFY(memoryUsage > 0);
+
+        // only the values referenced outside of the pool remain
+        pool.squeeze();
+        QCOMPARE(pool.count(), qsizetype {2});
+        QVERIFY(pool.memoryUsage() < memoryUsage);
+        QVERIFY(pool.intern(QString::fromLatin1("kept")).constData() == keptString.constData());
+        QVERIFY(pool.intern(Path(QString::fromLatin1("/downloads/kept"))).data().constData() == keptPath.data().constData());
+
+        // dropped values are interned again as new ones
+        const QString dropped = pool.intern(QString::fromLatin1("dropped"));
+        QCOMPARE(dropped, u"dropped"_qs);
+        QCOMPARE(pool.count(), qsizetype {3});
+
+        keptString.clear();
+        keptPath = {};
+        pool.squeeze();
+        QCOMPARE(pool.count(), qsizetype {1});
+        QCOMPARE(pool.memoryUsage(), qint64 {dropped.capacity() * static_cast<qint64>(sizeof(QChar))});
+    }
+};
+
+QTEST_APPLESS_MAIN(TestStringPool)
+#include "teststringpool.moc"
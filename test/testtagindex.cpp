@@ -0,0 +1,128 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QBitArray>
+#include <QSet>
+#include <QStringList>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/tagindex.h"
+#include "base/tagset.h"
+
+class TestTagIndex final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestTagIndex)
+
+public:
+    TestTagIndex() = default;
+
+private slots:
+    void testInsert() const
+    {
+        TagIndex index;
+        QCOMPARE(index.count(), 0);
+        QCOMPARE(index.indexOf(u"a"_qs), -1);
+
+        QCOMPARE(index.insert(u"b"_qs), 0);
+        QCOMPARE(index.insert(u"a"_qs), 1);
+        // inserting an existing tag keeps its index
+        QCOMPARE(index.insert(u"b"_qs), 0);
+
+        QVERIFY(index.contains(u"a"_qs));
+        QCOMPARE(index.indexOf(u"a"_qs), 1);
+        QCOMPARE(index.tag(0), u"b"_qs);
+        QCOMPARE(index.tag(5), QString());
+        QCOMPARE(index.count(), 2);
+        QCOMPARE(index.capacity(), 2);
+        QCOMPARE(index.tags(), (QSet<QString> {u"a"_qs, u"b"_qs}));
+        QCOMPARE(index.tagList(), (QStringList {u"a"_qs, u"b"_qs}));
+    }
+
+    void testRemove() const
+    {
+        TagIndex index;
+        index.insert(u"a"_qs);
+        index.insert(u"b"_qs);
+        index.insert(u"c"_qs);
+
+        QCOMPARE(index.remove(u"b"_qs), 1);
+        QCOMPARE(index.remove(u"b"_qs), -1);
+        QVERIFY(!index.contains(u"b"_qs));
+        QCOMPARE(index.tag(1), QString());
+        QCOMPARE(index.count(), 2);
+        QCOMPARE(index.capacity(), 3);
+        QCOMPARE(index.tags(), (QSet<QString> {u"a"_qs, u"c"_qs}));
+        QCOMPARE(index.tagList(), (QStringList {u"a"_qs, u"c"_qs}));
+    }
+
+    void testRename() const
+    {
+        TagIndex index;
+        index.insert(u"a"_qs);
+        index.insert(u"old"_qs);
+
+        // renaming is removal followed by insertion which reuses the freed index
+        const int oldIndex = index.remove(u"old"_qs);
+        QCOMPARE(index.insert(u"new"_qs), oldIndex);
+        QCOMPARE(index.tag(oldIndex), u"new"_qs);
+        QCOMPARE(index.indexOf(u"old"_qs), -1);
+        QCOMPARE(index.count(), 2);
+        QCOMPARE(index.capacity(), 2);
+        QCOMPARE(index.tags(), (QSet<QString> {u"a"_qs, u"new"_qs}));
+        QCOMPARE(index.tagList(), (QStringList {u"a"_qs, u"new"_qs}));
+
+        // new tags are appended once no index is free
+        QCOMPARE(index.insert(u"z"_qs), 2);
+        QCOMPARE(index.capacity(), 3);
+    }
+
+    void testToTagSet() const
+    {
+        TagIndex index;
+        index.insert(u"tag10"_qs);
+        index.insert(u"Tag2"_qs);
+        index.insert(u"tag1"_qs);
+
+        QVERIFY(index.toTagSet({}).isEmpty());
+
+        QBitArray bits {5};
+        bits.setBit(0);
+        bits.setBit(2);
+        // bits of unused indexes are ignored
+        bits.setBit(4);
+        QCOMPARE(index.toTagSet(bits).join(u","_qs), u"tag1,tag10"_qs);
+
+        bits.setBit(1);
+        QCOMPARE(index.toTagSet(bits).join(u","_qs), u"tag1,Tag2,tag10"_qs);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestTagIndex)
+#include "testtagindex.moc"
@@ -177,6 +177,31 @@ private slots:
         for (const TestData &data : testData)
             testLessThan(data, cmp(data.lhs, data.rhs), data.caseSensitiveResult);
     }
+
+    void testNaturalSortKeyCaseInsensitive() const
+    {
+        const Utils::Compare::NaturalCompare<Qt::CaseInsensitive> cmp;
+
+        for (const TestData &data : testData)
+            testCompare(data, cmp.sortKey(data.lhs).compare(cmp.sortKey(data.rhs)), data.caseInsensitiveResult);
+    }
+
+    void testNaturalSortKeyCaseSensitive() const
+    {
+        const Utils::Compare::NaturalCompare<Qt::CaseSensitive> cmp;
+
+        for (const TestData &data : testData)
+            testCompare(data, cmp.sortKey(data.lhs).compare(cmp.sortKey(data.rhs)), data.caseSensitiveResult);
+    }
+
+    void testNaturalSortKeyDefault() const
+    {
+        const Utils::Compare::NaturalCompare<Qt::CaseSensitive> cmp;
+
+        QCOMPARE(Utils::Compare::NaturalSortKey().compare(Utils::Compare::NaturalSortKey()), 0);
+        QVERIFY(Utils::Compare::NaturalSortKey() < cmp.sortKey(u"a"_qs));
+        QVERIFY(!(cmp.sortKey(u"a"_qs) < Utils::Compare::NaturalSortKey()));
+    }
 #endif
 };
 
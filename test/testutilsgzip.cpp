@@ -64,6 +64,27 @@ private slots:
         QVERIFY(ok);
         QCOMPARE(decompressedData, data);
     }
+
+    void testDecompressLarge() const
+    {
+        // large enough to be compressed in parallel chunks, the last one being partial
+        QByteArray data;
+        for (int i = 0; data.size() < (3 * 1024 * 1024 + 123); ++i)
+            data += QByteArray::number(i) + ',';
+
+        for (const int level : {1, 6, 9})
+        {
+            bool ok = false;
+            const QByteArray compressedData = Utils::Gzip::compress(data, level, &ok);
+            QVERIFY(ok);
+            QVERIFY(compressedData.size() < data.size());
+
+            ok = false;
+            const QByteArray decompressedData = Utils::Gzip::decompress(compressedData, &ok);
+            QVERIFY(ok);
+            QCOMPARE(decompressedData, data);
+        }
+    }
 };
 
 QTEST_APPLESS_MAIN(TestUtilsGzip)